@@ -29,6 +29,8 @@
 #include <linux/sched.h>            // task_struct
 #include <linux/numa.h>             // NUMA_NO_NODE
 #include <linux/semaphore.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
 
 #include "conftest.h"
 
@@ -52,6 +54,71 @@ struct nv_kthread_q_item
     struct list_head q_list_node;
     nv_q_func_t function_to_run;
     void *function_args;
+
+    // The fields below are only used by nv_kthread_mq. An item can move
+    // between the deques of the workers, so whether it is pending can't be
+    // derived from q_list_node without holding the right lock.
+    atomic_t is_pending;
+    u64 schedule_time_ns;
+};
+
+struct nv_kthread_mq_worker
+{
+    // Deque of items scheduled on this worker. The worker runs items from the
+    // head, other workers steal them from the tail.
+    struct list_head q_list_head;
+    spinlock_t q_lock;
+
+    wait_queue_head_t q_wait;
+    atomic_t is_idle;
+
+    struct task_struct *q_kthread;
+    struct nv_kthread_mq *mq;
+    unsigned index;
+    int node;
+};
+
+struct nv_kthread_mq_stats
+{
+    u64 items_scheduled;
+    u64 items_run;
+
+    // Items run by a worker other than the one they were scheduled on
+    u64 items_stolen;
+
+    // Time between the scheduling of an item and the start of its callback
+    u64 total_latency_ns;
+    u64 max_latency_ns;
+
+    // Number of items pending in the deques
+    u32 occupancy;
+    u32 max_occupancy;
+};
+
+struct nv_kthread_mq
+{
+    struct nv_kthread_mq_worker *workers;
+    unsigned num_workers;
+
+    // Used to spread the items scheduled from outside of the workers
+    atomic_t next_worker;
+
+    // Number of items pending in all the deques
+    atomic_t pending;
+
+    // Number of items scheduled that didn't finish running yet. Flushes wait
+    // for it to drop to zero.
+    atomic_t outstanding;
+    wait_queue_head_t flush_wait;
+
+    atomic_t main_loop_should_exit;
+
+    atomic64_t items_scheduled;
+    atomic64_t items_run;
+    atomic64_t items_stolen;
+    atomic64_t total_latency_ns;
+    atomic64_t max_latency_ns;
+    atomic_t max_occupancy;
 };
 
 
@@ -61,4 +128,6 @@ struct nv_kthread_q_item
 
 #define NV_KTHREAD_NO_NODE NUMA_NO_NODE
 
+#define NV_KTHREAD_MQ_MAX_WORKERS 64
+
 #endif
@@ -28,6 +28,12 @@ struct nv_kthread_q;
 struct nv_kthread_q_item;
 typedef struct nv_kthread_q nv_kthread_q_t;
 typedef struct nv_kthread_q_item nv_kthread_q_item_t;
+struct nv_kthread_mq;
+struct nv_kthread_mq_worker;
+struct nv_kthread_mq_stats;
+typedef struct nv_kthread_mq nv_kthread_mq_t;
+typedef struct nv_kthread_mq_worker nv_kthread_mq_worker_t;
+typedef struct nv_kthread_mq_stats nv_kthread_mq_stats_t;
 
 typedef void (*nv_q_func_t)(void *args);
 
@@ -199,6 +205,76 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
 int nv_kthread_q_schedule_q_item(nv_kthread_q_t *q,
                                  nv_kthread_q_item_t *q_item);
 
+////////////////////////////////////////////////////////////////////////////////
+// nv_kthread_mq:
+//
+//    Multi-worker variant of nv_kthread_q, for queues whose items are
+//    independent from each other and numerous enough for a single kthread to
+//    become a bottleneck.
+//
+//    Each worker kthread owns a deque of items. Items scheduled from within a
+//    worker's callback go to that worker's deque, other items are spread
+//    across the workers, preferring the ones on the NUMA node of the caller.
+//    Workers run the items of their own deque in FIFO order, and steal items
+//    from the other deques (same node first) once their own is empty.
+//
+//    Queue items are the same nv_kthread_q_item_t used by nv_kthread_q, but a
+//    q_item must not be scheduled on an nv_kthread_q and an nv_kthread_mq at
+//    the same time. Unlike nv_kthread_q, items scheduled on the same
+//    nv_kthread_mq can run concurrently and in any order.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Initializes the queue and starts num_workers kthreads, up to
+// NV_KTHREAD_MQ_MAX_WORKERS, to service it.
+//
+// If preferred_node is NV_KTHREAD_NO_NODE, the workers are spread across the
+// NUMA nodes with CPUs. Otherwise they are all created on preferred_node. In
+// both cases, unlike nv_kthread_q_init_on_node(), a worker created on a node
+// is also restricted to the CPUs of that node, if it has any.
+//
+// Returns a Linux kernel (negative) errno on failure, and zero on success. It
+// is safe to call nv_kthread_mq_stop() on a queue that
+// nv_kthread_mq_init_on_node() failed for.
+//
+int nv_kthread_mq_init_on_node(nv_kthread_mq_t *mq,
+                               const char *qname,
+                               unsigned num_workers,
+                               int preferred_node);
+
+int nv_kthread_mq_init(nv_kthread_mq_t *mq, const char *qname, unsigned num_workers);
+
+//
+// Flushes the queue, then stops the workers. Same rules as nv_kthread_q_stop().
+//
+void nv_kthread_mq_stop(nv_kthread_mq_t *mq);
+
+//
+// Waits for all the items scheduled before the call, and all the items
+// scheduled by them, to finish running.
+//
+// This waits for the queue to go idle, so unlike nv_kthread_q_flush(), it
+// doesn't return while a q_item keeps rescheduling itself. Such q_items must be
+// told to stop rescheduling themselves before flushing. It must not be called
+// from a q_item callback.
+//
+void nv_kthread_mq_flush(nv_kthread_mq_t *mq);
+
+//
+// Same semantics as nv_kthread_q_schedule_q_item(), including being callable
+// from interrupt context.
+//
+int nv_kthread_mq_schedule_q_item(nv_kthread_mq_t *mq,
+                                  nv_kthread_q_item_t *q_item);
+
+//
+// Snapshot of the latency and occupancy statistics of the queue, accumulated
+// since nv_kthread_mq_init_on_node(). The counters are updated independently,
+// so a snapshot taken while items are running is not necessarily consistent.
+//
+void nv_kthread_mq_get_stats(nv_kthread_mq_t *mq, nv_kthread_mq_stats_t *stats);
+
 // Built-in test. Returns -1 if any subtest failed, or 0 upon success.
 int nv_kthread_q_run_self_test(void);
 
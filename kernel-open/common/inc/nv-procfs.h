@@ -25,4 +25,16 @@
 
 #include "nv-procfs-utils.h"
 
+#if defined(CONFIG_PROC_FS)
+/*
+ * Statistics printers for the nvidia procfs files, implemented next to the
+ * state they report on.
+ */
+void nv_mem_pool_procfs_print(struct seq_file *s);
+void nv_mmap_procfs_print(struct seq_file *s);
+void nv_dma_procfs_print(struct seq_file *s);
+void nv_pin_procfs_print(struct seq_file *s);
+void nv_p2p_procfs_print(struct seq_file *s);
+#endif
+
 #endif /* _NV_PROCFS_H */
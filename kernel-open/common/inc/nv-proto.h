@@ -42,6 +42,9 @@ void        nv_procfs_remove_gpu        (nv_linux_state_t *);
 
 int         nvidia_mmap                 (struct file *, struct vm_area_struct *);
 int         nvidia_mmap_helper          (nv_state_t *, nv_linux_file_private_t *, nvidia_stack_t *, struct vm_area_struct *, void *);
+#if defined(CONFIG_ARCH_SUPPORTS_PMD_PFNMAP)
+unsigned long nvidia_get_unmapped_area  (struct file *, unsigned long, unsigned long, unsigned long, unsigned long);
+#endif
 int         nv_encode_caching           (pgprot_t *, NvU32, nv_memory_type_t);
 void        nv_revoke_gpu_mappings_locked(nv_state_t *);
 
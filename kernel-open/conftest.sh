@@ -3951,6 +3951,54 @@ compile_test() {
             compile_check_conftest "$CODE" "NV_HANDLE_MM_FAULT_HAS_PT_REGS_ARG" "" "types"
         ;;
 
+        vmf_insert_pfn_pmd_has_pfn_t_arg)
+            #
+            # Determine if vmf_insert_pfn_pmd() and vmf_insert_pfn_pud() take
+            # a pfn_t rather than an unsigned long pfn.
+            #
+            # The pfn_t argument was introduced together with the functions
+            # and replaced by a plain pfn when the pfn_t type was removed.
+            #
+            CODE="
+            #include <linux/mm.h>
+            #include <linux/huge_mm.h>
+            #include <linux/pfn_t.h>
+
+            typeof(vmf_insert_pfn_pmd) conftest_vmf_insert_pfn_pmd_has_pfn_t_arg;
+            vm_fault_t conftest_vmf_insert_pfn_pmd_has_pfn_t_arg(struct vm_fault *vmf,
+                                                                 pfn_t pfn,
+                                                                 bool write) {
+                return 0;
+            }"
+
+            compile_check_conftest "$CODE" "NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG" "" "types"
+        ;;
+
+        mm_get_unmapped_area_has_mm_arg)
+            #
+            # Determine if mm_get_unmapped_area() takes the mm_struct to
+            # search as its first argument.
+            #
+            # The function replaced mm->get_unmapped_area(). If the mm
+            # argument is absent, current->mm is always searched.
+            #
+            CODE="
+            #include <linux/mm.h>
+            #include <linux/sched/mm.h>
+
+            typeof(mm_get_unmapped_area) conftest_mm_get_unmapped_area_has_mm_arg;
+            unsigned long conftest_mm_get_unmapped_area_has_mm_arg(struct mm_struct *mm,
+                                                                   struct file *filp,
+                                                                   unsigned long addr,
+                                                                   unsigned long len,
+                                                                   unsigned long pgoff,
+                                                                   unsigned long flags) {
+                return 0;
+            }"
+
+            compile_check_conftest "$CODE" "NV_MM_GET_UNMAPPED_AREA_HAS_MM_ARG" "" "types"
+        ;;
+
         pci_rebar_get_possible_sizes)
             #
             # Determine if the pci_rebar_get_possible_sizes() function is present.
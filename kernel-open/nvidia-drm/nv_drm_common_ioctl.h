@@ -53,6 +53,7 @@
 #define DRM_NVIDIA_SEMSURF_FENCE_WAIT               0x16
 #define DRM_NVIDIA_SEMSURF_FENCE_ATTACH             0x17
 #define DRM_NVIDIA_GET_DRM_FILE_UNIQUE_ID           0x18
+#define DRM_NVIDIA_SEMSURF_FENCE_CREATE_BATCH       0x19
 
 #define DRM_IOCTL_NVIDIA_GEM_IMPORT_NVKMS_MEMORY                           \
     DRM_IOWR((DRM_COMMAND_BASE + DRM_NVIDIA_GEM_IMPORT_NVKMS_MEMORY),      \
@@ -163,6 +164,11 @@
               DRM_NVIDIA_GET_DRM_FILE_UNIQUE_ID),                       \
               struct drm_nvidia_get_drm_file_unique_id_params)
 
+#define DRM_IOCTL_NVIDIA_SEMSURF_FENCE_CREATE_BATCH                     \
+    DRM_IOW((DRM_COMMAND_BASE +                                         \
+              DRM_NVIDIA_SEMSURF_FENCE_CREATE_BATCH),                   \
+              struct drm_nvidia_semsurf_fence_create_batch_params)
+
 struct drm_nvidia_gem_import_nvkms_memory_params {
     uint64_t mem_size;           /* IN */
 
@@ -396,4 +402,31 @@ struct drm_nvidia_get_drm_file_unique_id_params {
     uint64_t id;                    /* OUT Unique ID of the DRM file */
 };
 
+/* Maximum number of fences created by one SEMSURF_FENCE_CREATE_BATCH call */
+#define DRM_NVIDIA_SEMSURF_FENCE_CREATE_BATCH_MAX 256
+
+/*
+ * Creates 'count' fences on one fence context, equivalent to 'count'
+ * SEMSURF_FENCE_CREATE calls with the same timeout, but the fences are made
+ * pending and the semaphore callback is re-armed only once for the whole
+ * batch. Either all sync FDs are created, or none are.
+ */
+struct drm_nvidia_semsurf_fence_create_batch_params {
+    uint32_t fence_context_handle;  /* IN GEM handle to fence context on which
+                                     * fences are run on */
+
+    uint32_t timeout_value_ms;      /* IN Timeout value in ms for each fence,
+                                     * see drm_nvidia_semsurf_fence_create_params */
+
+    uint64_t wait_values_ptr;       /* IN Pointer to an array of 'count'
+                                     * uint64_t semaphore values */
+
+    uint64_t fds_ptr;               /* IN Pointer to an array of 'count'
+                                     * int32_t, filled with the sync FDs */
+
+    uint32_t count;                 /* IN Number of fences, at most
+                                     * DRM_NVIDIA_SEMSURF_FENCE_CREATE_BATCH_MAX */
+    uint32_t __pad;
+};
+
 #endif /* _NV_DRM_COMMON_IOCTL_H_ */
@@ -1776,6 +1776,9 @@ static const struct drm_ioctl_desc nv_drm_ioctls[] = {
     DRM_IOCTL_DEF_DRV(NVIDIA_SEMSURF_FENCE_CREATE,
                       nv_drm_semsurf_fence_create_ioctl,
                       DRM_RENDER_ALLOW|DRM_UNLOCKED),
+    DRM_IOCTL_DEF_DRV(NVIDIA_SEMSURF_FENCE_CREATE_BATCH,
+                      nv_drm_semsurf_fence_create_batch_ioctl,
+                      DRM_RENDER_ALLOW|DRM_UNLOCKED),
     DRM_IOCTL_DEF_DRV(NVIDIA_SEMSURF_FENCE_WAIT,
                       nv_drm_semsurf_fence_wait_ioctl,
                       DRM_RENDER_ALLOW|DRM_UNLOCKED),
@@ -35,6 +35,7 @@
 #include "nv_drm_common_ioctl.h"
 
 #include <linux/dma-fence.h>
+#include <linux/uaccess.h>
 
 #define NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS 5000
 
@@ -819,6 +820,7 @@ __nv_drm_semsurf_ctx_process_completed(struct nv_drm_semsurf_fence_ctx *ctx,
 {
     struct list_head finished;
     struct list_head timed_out;
+    struct list_head *last_finished;
     struct nv_drm_semsurf_fence *nv_fence;
     struct dma_fence *fence;
     NvU64 currentSeqno = __nv_drm_get_semsurf_ctx_seqno(ctx);
@@ -832,6 +834,20 @@ __nv_drm_semsurf_ctx_process_completed(struct nv_drm_semsurf_fence_ctx *ctx,
 
     spin_lock_irqsave(&ctx->lock, flags);
 
+    /*
+     * The pending list is ordered by seqno, so the completed fences form a
+     * prefix of it. Find its end and move it to the finished list at once.
+     */
+    list_for_each(last_finished, &ctx->pending_fences) {
+        nv_fence = list_entry(last_finished, typeof(*nv_fence), pending_node);
+
+        if (__nv_drm_get_semsurf_fence_seqno(nv_fence) > currentSeqno) {
+            break;
+        }
+    }
+
+    list_cut_position(&finished, &ctx->pending_fences, last_finished->prev);
+
     while (!list_empty(&ctx->pending_fences)) {
         nv_fence = list_first_entry(&ctx->pending_fences,
                                     typeof(*nv_fence),
@@ -840,9 +856,7 @@ __nv_drm_semsurf_ctx_process_completed(struct nv_drm_semsurf_fence_ctx *ctx,
         fenceSeqno = __nv_drm_get_semsurf_fence_seqno(nv_fence);
         fenceTimeout = nv_fence->timeout;
 
-        if (fenceSeqno <= currentSeqno) {
-            list_move_tail(&nv_fence->pending_node, &finished);
-        } else if (fenceTimeout <= now) {
+        if (fenceTimeout <= now) {
             list_move_tail(&nv_fence->pending_node, &timed_out);
         } else {
             break;
@@ -1378,94 +1392,126 @@ static const struct dma_fence_ops nv_drm_semsurf_fence_ops = {
 };
 
 /*
- * Completes fence initialization, places a new reference to the fence in the
+ * Completes fence initialization, places a new reference to each fence in the
  * context's pending fence list, and updates/registers any RM callbacks and
- * timeout timers if necessary.
+ * timeout timers if necessary. Adding a batch of fences at once takes the
+ * context lock and re-arms the callbacks only once.
  *
  * Can NOT be called from in an atomic context/interrupt handler.
  */
 static void
 __nv_drm_semsurf_ctx_add_pending(struct nv_drm_semsurf_fence_ctx *ctx,
-                                 struct nv_drm_semsurf_fence *nv_fence,
+                                 struct nv_drm_semsurf_fence **nv_fences,
+                                 NvU32 count,
                                  NvU64 timeoutMS)
 {
     struct list_head *pending;
+    unsigned long timeout;
     unsigned long flags;
+    NvU32 i;
 
     if (timeoutMS > NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS) {
         timeoutMS = NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS;
     }
 
-    /* Add a reference to the fence for the list */
-    dma_fence_get(&nv_fence->base);
-    INIT_LIST_HEAD(&nv_fence->pending_node);
+    timeout = nv_drm_timeout_from_ms(timeoutMS);
 
-    nv_fence->timeout = nv_drm_timeout_from_ms(timeoutMS);
+    for (i = 0; i < count; i++) {
+        /* Add a reference to the fence for the list */
+        dma_fence_get(&nv_fences[i]->base);
+        nv_fences[i]->timeout = timeout;
+    }
 
     spin_lock_irqsave(&ctx->lock, flags);
 
-    list_for_each(pending, &ctx->pending_fences) {
-        struct nv_drm_semsurf_fence *pending_fence =
-            list_entry(pending, typeof(*pending_fence), pending_node);
-        if (__nv_drm_get_semsurf_fence_seqno(pending_fence) >
-            __nv_drm_get_semsurf_fence_seqno(nv_fence)) {
-            /* Inserts 'nv_fence->pending_node' before 'pending' */
-            list_add_tail(&nv_fence->pending_node, pending);
-            break;
+    for (i = 0; i < count; i++) {
+        struct nv_drm_semsurf_fence *nv_fence = nv_fences[i];
+
+        /*
+         * Fences are usually created in increasing seqno order, so search for
+         * the insertion point from the tail of the list.
+         */
+        list_for_each_prev(pending, &ctx->pending_fences) {
+            struct nv_drm_semsurf_fence *pending_fence =
+                list_entry(pending, typeof(*pending_fence), pending_node);
+            if (__nv_drm_get_semsurf_fence_seqno(pending_fence) <=
+                __nv_drm_get_semsurf_fence_seqno(nv_fence)) {
+                break;
+            }
         }
-    }
 
-    if (list_empty(&nv_fence->pending_node)) {
         /*
-         * Inserts 'fence->pending_node' at the end of 'ctx->pending_fences',
-         * or as the head if the list is empty
+         * Inserts 'nv_fence->pending_node' after 'pending', or as the head of
+         * 'ctx->pending_fences' if all pending fences have a greater seqno
          */
-        list_add_tail(&nv_fence->pending_node, &ctx->pending_fences);
+        list_add(&nv_fence->pending_node, pending);
     }
 
-    /* Fence is live starting... now! */
+    /* Fences are live starting... now! */
     spin_unlock_irqrestore(&ctx->lock, flags);
 
     /* Register new wait and timeout callbacks, if necessary */
     __nv_drm_semsurf_ctx_reg_callbacks(ctx);
 }
 
-static struct dma_fence *__nv_drm_semsurf_fence_ctx_create_fence(
-    struct nv_drm_device *nv_dev,
+/*
+ * Allocates and initializes a fence. The returned fence has one reference
+ * reserved for the caller, and is not pending until passed to
+ * __nv_drm_semsurf_ctx_add_pending().
+ */
+static struct nv_drm_semsurf_fence *__nv_drm_semsurf_fence_new(
     struct nv_drm_semsurf_fence_ctx *ctx,
-    NvU64 wait_value,
-    NvU64 timeout_value_ms)
+    NvU64 wait_value)
 {
     struct nv_drm_semsurf_fence *nv_fence;
-    struct dma_fence *fence;
-    int ret = 0;
-
-    if (timeout_value_ms == 0 ||
-        timeout_value_ms > NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS) {
-        timeout_value_ms = NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS;
-    }
 
     if ((nv_fence = nv_drm_calloc(1, sizeof(*nv_fence))) == NULL) {
-        ret = -ENOMEM;
-        goto out;
+        return NULL;
     }
 
-    fence = &nv_fence->base;
     spin_lock_init(&nv_fence->lock);
+    INIT_LIST_HEAD(&nv_fence->pending_node);
 #if !defined(NV_DMA_FENCE_OPS_HAS_USE_64BIT_SEQNO)
     nv_fence->wait_value = wait_value;
 #endif
 
     /* Initializes the fence with one reference (for the caller) */
-    dma_fence_init(fence, &nv_drm_semsurf_fence_ops,
+    dma_fence_init(&nv_fence->base, &nv_drm_semsurf_fence_ops,
                    &nv_fence->lock,
                    ctx->base.context, wait_value);
 
-    __nv_drm_semsurf_ctx_add_pending(ctx, nv_fence, timeout_value_ms);
+    return nv_fence;
+}
+
+static inline NvU64
+__nv_drm_semsurf_fence_timeout_ms(NvU64 timeout_value_ms)
+{
+    if (timeout_value_ms == 0 ||
+        timeout_value_ms > NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS) {
+        timeout_value_ms = NV_DRM_SEMAPHORE_SURFACE_FENCE_MAX_TIMEOUT_MS;
+    }
+
+    return timeout_value_ms;
+}
+
+static struct dma_fence *__nv_drm_semsurf_fence_ctx_create_fence(
+    struct nv_drm_device *nv_dev,
+    struct nv_drm_semsurf_fence_ctx *ctx,
+    NvU64 wait_value,
+    NvU64 timeout_value_ms)
+{
+    struct nv_drm_semsurf_fence *nv_fence;
+
+    if ((nv_fence = __nv_drm_semsurf_fence_new(ctx, wait_value)) == NULL) {
+        return ERR_PTR(-ENOMEM);
+    }
+
+    __nv_drm_semsurf_ctx_add_pending(
+        ctx, &nv_fence, 1,
+        __nv_drm_semsurf_fence_timeout_ms(timeout_value_ms));
 
-out:
     /* Returned fence has one reference reserved for the caller. */
-    return ret != 0 ? ERR_PTR(ret) : &nv_fence->base;
+    return &nv_fence->base;
 }
 
 int nv_drm_semsurf_fence_create_ioctl(struct drm_device *dev,
@@ -1554,6 +1600,125 @@ done:
     return ret;
 }
 
+int nv_drm_semsurf_fence_create_batch_ioctl(struct drm_device *dev,
+                                            void *data,
+                                            struct drm_file *filep)
+{
+    struct nv_drm_device *nv_dev = to_nv_device(dev);
+    struct drm_nvidia_semsurf_fence_create_batch_params *p = data;
+    struct nv_drm_fence_context *nv_fence_context;
+    struct nv_drm_semsurf_fence_ctx *ctx;
+    struct nv_drm_semsurf_fence **nv_fences = NULL;
+    struct dma_fence **fences = NULL;
+    NvU64 *wait_values = NULL;
+    NvU32 created = 0;
+    NvU32 i;
+    int ret = -EINVAL;
+
+    if (nv_dev->pDevice == NULL) {
+        ret = -EOPNOTSUPP;
+        goto done;
+    }
+
+    if (p->__pad != 0) {
+        NV_DRM_DEV_LOG_ERR(nv_dev, "Padding fields must be zeroed");
+        goto done;
+    }
+
+    if (p->count == 0 ||
+        p->count > DRM_NVIDIA_SEMSURF_FENCE_CREATE_BATCH_MAX) {
+        NV_DRM_DEV_LOG_ERR(nv_dev, "Invalid fence count: %u", p->count);
+        goto done;
+    }
+
+    if ((nv_fence_context = __nv_drm_fence_context_lookup(
+                                filep,
+                                p->fence_context_handle)) == NULL) {
+        NV_DRM_DEV_LOG_ERR(
+            nv_dev,
+            "Failed to lookup gem object for fence context: 0x%08x",
+            p->fence_context_handle);
+
+        goto done;
+    }
+
+    if (nv_fence_context->ops != &nv_drm_semsurf_fence_ctx_ops) {
+        NV_DRM_DEV_LOG_ERR(
+            nv_dev,
+            "Wrong fence context type: 0x%08x",
+            p->fence_context_handle);
+
+        goto fence_context_create_fence_failed;
+    }
+
+    ctx = to_semsurf_fence_ctx(nv_fence_context);
+
+    wait_values = nv_drm_calloc(p->count, sizeof(*wait_values));
+    nv_fences = nv_drm_calloc(p->count, sizeof(*nv_fences));
+    fences = nv_drm_calloc(p->count, sizeof(*fences));
+
+    if (wait_values == NULL || nv_fences == NULL || fences == NULL) {
+        ret = -ENOMEM;
+        goto fence_context_create_fence_failed;
+    }
+
+    if (copy_from_user(wait_values,
+                       (void __user *)(uintptr_t)p->wait_values_ptr,
+                       p->count * sizeof(*wait_values)) != 0) {
+        ret = -EFAULT;
+        goto fence_context_create_fence_failed;
+    }
+
+    for (created = 0; created < p->count; created++) {
+        nv_fences[created] =
+            __nv_drm_semsurf_fence_new(ctx, wait_values[created]);
+
+        if (nv_fences[created] == NULL) {
+            ret = -ENOMEM;
+
+            NV_DRM_DEV_LOG_ERR(
+                nv_dev,
+                "Failed to allocate fence: 0x%08x", p->fence_context_handle);
+
+            goto fence_context_create_fence_failed;
+        }
+
+        fences[created] = &nv_fences[created]->base;
+    }
+
+    __nv_drm_semsurf_ctx_add_pending(
+        ctx, nv_fences, p->count,
+        __nv_drm_semsurf_fence_timeout_ms(p->timeout_value_ms));
+
+    ret = nv_drm_create_sync_files(fences, p->count,
+                                   (int __user *)(uintptr_t)p->fds_ptr);
+    if (ret != 0) {
+        NV_DRM_DEV_LOG_ERR(
+            nv_dev,
+            "Failed to create sync files from fences on ctx 0x%08x",
+            p->fence_context_handle);
+    }
+
+fence_context_create_fence_failed:
+    /*
+     * Release this function's references to the fences.  If successful, the
+     * sync FDs will still hold a reference, and the pending list (if a fence
+     * hasn't already been signaled) will also retain a reference.
+     */
+    for (i = 0; i < created; i++) {
+        dma_fence_put(fences[i]);
+    }
+
+    nv_drm_free(fences);
+    nv_drm_free(nv_fences);
+    nv_drm_free(wait_values);
+
+    nv_drm_gem_object_unreference_unlocked(&nv_fence_context->base);
+
+done:
+    return ret;
+}
+
 static void
 __nv_drm_semsurf_free_wait_data(struct nv_drm_sync_fd_wait_data *wait_data)
 {
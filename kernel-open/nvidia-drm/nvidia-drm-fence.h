@@ -47,6 +47,10 @@ int nv_drm_semsurf_fence_create_ioctl(struct drm_device *dev,
                                       void *data,
                                       struct drm_file *filep);
 
+int nv_drm_semsurf_fence_create_batch_ioctl(struct drm_device *dev,
+                                            void *data,
+                                            struct drm_file *filep);
+
 int nv_drm_semsurf_fence_wait_ioctl(struct drm_device *dev,
                                     void *data,
                                     struct drm_file *filep);
@@ -31,6 +31,7 @@
 #include <linux/vmalloc.h>
 #include <linux/sched.h>
 #include <linux/device.h>
+#include <linux/uaccess.h>
 
 #include "nv-mm.h"
 
@@ -243,6 +244,77 @@ int nv_drm_create_sync_file(struct dma_fence *fence)
     return fd;
 }
 
+/*
+ * Creates one sync file per fence and returns their file descriptors in
+ * user_fds. Either all of the file descriptors are installed, or none are.
+ */
+int nv_drm_create_sync_files(struct dma_fence **fences,
+                             NvU32 count,
+                             int __user *user_fds)
+{
+    struct sync_file **syncs;
+    int *fds;
+    NvU32 i;
+    int ret = 0;
+
+    syncs = nv_drm_calloc(count, sizeof(*syncs));
+    fds = nv_drm_calloc(count, sizeof(*fds));
+
+    if ((syncs == NULL) || (fds == NULL)) {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < count; i++) {
+        fds[i] = -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        fds[i] = get_unused_fd_flags(O_CLOEXEC);
+        if (fds[i] < 0) {
+            ret = fds[i];
+            goto failed;
+        }
+
+        /* sync_file_create() generates its own reference to the fence */
+        syncs[i] = sync_file_create(fences[i]);
+        if (IS_ERR(syncs[i])) {
+            ret = PTR_ERR(syncs[i]);
+            syncs[i] = NULL;
+            goto failed;
+        }
+    }
+
+    if (copy_to_user(user_fds, fds, count * sizeof(*fds)) != 0) {
+        ret = -EFAULT;
+        goto failed;
+    }
+
+    for (i = 0; i < count; i++) {
+        fd_install(fds[i], syncs[i]->file);
+    }
+
+    goto done;
+
+failed:
+    for (i = 0; i < count; i++) {
+        if (syncs[i] != NULL) {
+            /* Releases the sync file and its fence reference */
+            fput(syncs[i]->file);
+        }
+
+        if (fds[i] >= 0) {
+            put_unused_fd(fds[i]);
+        }
+    }
+
+done:
+    nv_drm_free(fds);
+    nv_drm_free(syncs);
+
+    return ret;
+}
+
 struct dma_fence *nv_drm_sync_file_get_fence(int fd)
 {
     return sync_file_get_fence(fd);
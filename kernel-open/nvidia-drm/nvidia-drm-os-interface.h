@@ -103,6 +103,10 @@ unsigned long nv_drm_timeout_from_ms(NvU64 relative_timeout_ms);
 
 int nv_drm_create_sync_file(struct dma_fence *fence);
 
+int nv_drm_create_sync_files(struct dma_fence **fences,
+                             NvU32 count,
+                             int __user *user_fds);
+
 struct dma_fence *nv_drm_sync_file_get_fence(int fd);
 
 void nv_drm_yield(void);
@@ -29,6 +29,11 @@
 #include <linux/module.h>
 #include <linux/mm.h>
 #include <linux/bug.h>
+#include <linux/slab.h>
+#include <linux/ktime.h>
+#include <linux/cpumask.h>
+#include <linux/nodemask.h>
+#include <linux/topology.h>
 
 // Today's implementation is a little simpler and more limited than the
 // API description allows for in nv-kthread-q.h. Details include:
@@ -41,6 +46,9 @@
 // named kernel thread (kthread). You can then insert arbitrary functions
 // into the queue, and those functions will be run in the context of the
 // queue's kthread.
+//
+// nv_kthread_mq is the exception to 2.: it is serviced by a set of kthreads,
+// each with its own deque of items.
 
 #define NVQ_WARN(fmt, ...)                                   \
     do {                                                     \
@@ -153,7 +161,7 @@ void nv_kthread_q_stop(nv_kthread_q_t *q)
 // This function is never invoked when there is no NUMA preference (preferred
 // node is NUMA_NO_NODE).
 static struct task_struct *thread_create_on_node(int (*threadfn)(void *data),
-                                                 nv_kthread_q_t *q,
+                                                 void *data,
                                                  int preferred_node,
                                                  const char *q_name)
 {
@@ -165,7 +173,7 @@ static struct task_struct *thread_create_on_node(int (*threadfn)(void *data),
     for (i = 0;; i++) {
         struct page *stack;
 
-        thread[i] = kthread_create_on_node(threadfn, q, preferred_node, q_name);
+        thread[i] = kthread_create_on_node(threadfn, data, preferred_node, q_name);
 
         if (unlikely(IS_ERR(thread[i]))) {
 
@@ -264,6 +272,9 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
     INIT_LIST_HEAD(&q_item->q_list_node);
     q_item->function_to_run = function_to_run;
     q_item->function_args   = function_args;
+
+    atomic_set(&q_item->is_pending, 0);
+    q_item->schedule_time_ns = 0;
 }
 
 // Returns true (non-zero) if the q_item got scheduled, false otherwise.
@@ -315,3 +326,383 @@ void nv_kthread_q_flush(nv_kthread_q_t *q)
     _raw_q_flush(q);
     _raw_q_flush(q);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// nv_kthread_mq
+
+static void _atomic64_max(atomic64_t *max_value, s64 value)
+{
+    s64 old = atomic64_read(max_value);
+
+    while (value > old) {
+        s64 prev = atomic64_cmpxchg(max_value, old, value);
+
+        if (prev == old)
+            break;
+
+        old = prev;
+    }
+}
+
+static void _atomic_max(atomic_t *max_value, int value)
+{
+    int old = atomic_read(max_value);
+
+    while (value > old) {
+        int prev = atomic_cmpxchg(max_value, old, value);
+
+        if (prev == old)
+            break;
+
+        old = prev;
+    }
+}
+
+// Removes an item from the worker's deque: from the head for the worker
+// itself, from the tail for thieves.
+static nv_kthread_q_item_t *_mq_pop(nv_kthread_mq_worker_t *worker, bool steal)
+{
+    nv_kthread_q_item_t *q_item = NULL;
+    unsigned long flags;
+
+    // Unlocked peek, so that looking for work to steal doesn't bounce the
+    // locks of empty deques around. A racing insertion is picked up by the
+    // wakeup that follows it.
+    if (list_empty(&worker->q_list_head))
+        return NULL;
+
+    spin_lock_irqsave(&worker->q_lock, flags);
+
+    if (!list_empty(&worker->q_list_head)) {
+        if (steal)
+            q_item = list_last_entry(&worker->q_list_head, nv_kthread_q_item_t, q_list_node);
+        else
+            q_item = list_first_entry(&worker->q_list_head, nv_kthread_q_item_t, q_list_node);
+
+        list_del_init(&q_item->q_list_node);
+        atomic_dec(&worker->mq->pending);
+    }
+
+    spin_unlock_irqrestore(&worker->q_lock, flags);
+
+    return q_item;
+}
+
+// Steals an item from another worker, trying the workers on the same NUMA
+// node first.
+static nv_kthread_q_item_t *_mq_steal(nv_kthread_mq_worker_t *thief)
+{
+    nv_kthread_mq_t *mq = thief->mq;
+    unsigned pass, i;
+
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 1; i < mq->num_workers; i++) {
+            nv_kthread_mq_worker_t *victim = &mq->workers[(thief->index + i) % mq->num_workers];
+            nv_kthread_q_item_t *q_item;
+
+            if ((victim->node == thief->node) != (pass == 0))
+                continue;
+
+            q_item = _mq_pop(victim, true);
+            if (q_item)
+                return q_item;
+        }
+    }
+
+    return NULL;
+}
+
+static void _mq_run(nv_kthread_mq_t *mq, nv_kthread_q_item_t *q_item, bool stolen)
+{
+    nv_q_func_t function_to_run = q_item->function_to_run;
+    void *function_args = q_item->function_args;
+    s64 latency_ns = ktime_to_ns(ktime_get()) - q_item->schedule_time_ns;
+
+    atomic64_inc(&mq->items_run);
+    if (stolen)
+        atomic64_inc(&mq->items_stolen);
+
+    atomic64_add(latency_ns, &mq->total_latency_ns);
+    _atomic64_max(&mq->max_latency_ns, latency_ns);
+
+    // The item is not pending anymore once it's out of the deque, which allows
+    // it to be rescheduled from its own callback. Nothing in the item can be
+    // touched past this point. atomic_set() is not a RMW operation, so a full
+    // barrier is needed to order the reads of the item above before the clear.
+    // It pairs with the fully ordered atomic_cmpxchg() in
+    // nv_kthread_mq_schedule_q_item().
+    smp_mb();
+    atomic_set(&q_item->is_pending, 0);
+
+    function_to_run(function_args);
+
+    if (atomic_dec_and_test(&mq->outstanding))
+        wake_up_all(&mq->flush_wait);
+}
+
+static int _mq_main_loop(void *args)
+{
+    nv_kthread_mq_worker_t *worker = (nv_kthread_mq_worker_t *)args;
+    nv_kthread_mq_t *mq = worker->mq;
+
+    while (1) {
+        nv_kthread_q_item_t *q_item = _mq_pop(worker, false);
+        bool stolen = false;
+
+        if (!q_item) {
+            q_item = _mq_steal(worker);
+            stolen = (q_item != NULL);
+        }
+
+        if (q_item) {
+            _mq_run(mq, q_item, stolen);
+            continue;
+        }
+
+        // nv_kthread_mq_stop() flushes the queue before stopping the workers,
+        // so the deques are empty by then.
+        if (kthread_should_stop())
+            break;
+
+        // Pairs with the fully ordered atomic_inc_return of mq->pending in
+        // nv_kthread_mq_schedule_q_item(): either the scheduler sees this
+        // worker idle and wakes it up, or the wait below sees the item.
+        atomic_set(&worker->is_idle, 1);
+        smp_mb__after_atomic();
+
+        // Interruptible wait for the same reason as in _main_loop()
+        if (wait_event_interruptible(worker->q_wait,
+                                     atomic_read(&mq->pending) > 0 || kthread_should_stop()))
+            NVQ_WARN("Interrupted during worker wait\n");
+
+        atomic_set(&worker->is_idle, 0);
+    }
+
+    return 0;
+}
+
+// NUMA node of the index-th worker of a queue without a preferred node, going
+// round-robin over the nodes with CPUs.
+static int _mq_worker_node(unsigned index)
+{
+#if defined(CONFIG_NUMA)
+    unsigned num_nodes = num_node_state(N_CPU);
+    unsigned target;
+    int node;
+
+    if (num_nodes <= 1)
+        return NV_KTHREAD_NO_NODE;
+
+    target = index % num_nodes;
+
+    for_each_node_state(node, N_CPU) {
+        if (target == 0)
+            return node;
+
+        target--;
+    }
+#endif
+
+    return NV_KTHREAD_NO_NODE;
+}
+
+int nv_kthread_mq_init_on_node(nv_kthread_mq_t *mq,
+                               const char *qname,
+                               unsigned num_workers,
+                               int preferred_node)
+{
+    unsigned i;
+
+    memset(mq, 0, sizeof(*mq));
+
+    if (num_workers == 0 || num_workers > NV_KTHREAD_MQ_MAX_WORKERS)
+        return -EINVAL;
+
+    init_waitqueue_head(&mq->flush_wait);
+
+    mq->workers = kzalloc_node(num_workers * sizeof(*mq->workers), GFP_KERNEL, preferred_node);
+    if (!mq->workers)
+        return -ENOMEM;
+
+    mq->num_workers = num_workers;
+
+    for (i = 0; i < num_workers; i++) {
+        nv_kthread_mq_worker_t *worker = &mq->workers[i];
+        char worker_name[TASK_COMM_LEN];
+
+        INIT_LIST_HEAD(&worker->q_list_head);
+        spin_lock_init(&worker->q_lock);
+        init_waitqueue_head(&worker->q_wait);
+        worker->mq = mq;
+        worker->index = i;
+
+        if (preferred_node == NV_KTHREAD_NO_NODE)
+            worker->node = _mq_worker_node(i);
+        else
+            worker->node = preferred_node;
+
+        snprintf(worker_name, sizeof(worker_name), "%s/%u", qname, i);
+
+        if (worker->node == NV_KTHREAD_NO_NODE)
+            worker->q_kthread = kthread_create(_mq_main_loop, worker, "%s", worker_name);
+        else
+            worker->q_kthread = thread_create_on_node(_mq_main_loop, worker, worker->node, worker_name);
+
+        if (IS_ERR(worker->q_kthread)) {
+            int err = PTR_ERR(worker->q_kthread);
+
+            worker->q_kthread = NULL;
+            nv_kthread_mq_stop(mq);
+
+            return err;
+        }
+
+#if defined(CONFIG_NUMA)
+        // Keep the worker close to the memory of its node. Nodes without CPUs,
+        // like GPU memory nodes, only get the stack affinity.
+        if (worker->node != NV_KTHREAD_NO_NODE && !cpumask_empty(cpumask_of_node(worker->node)))
+            set_cpus_allowed_ptr(worker->q_kthread, cpumask_of_node(worker->node));
+#endif
+    }
+
+    for (i = 0; i < num_workers; i++)
+        wake_up_process(mq->workers[i].q_kthread);
+
+    return 0;
+}
+
+int nv_kthread_mq_init(nv_kthread_mq_t *mq, const char *qname, unsigned num_workers)
+{
+    return nv_kthread_mq_init_on_node(mq, qname, num_workers, NV_KTHREAD_NO_NODE);
+}
+
+void nv_kthread_mq_stop(nv_kthread_mq_t *mq)
+{
+    unsigned i;
+
+    // check if queue has been properly initialized
+    if (unlikely(!mq->workers))
+        return;
+
+    nv_kthread_mq_flush(mq);
+
+    atomic_set(&mq->main_loop_should_exit, 1);
+
+    for (i = 0; i < mq->num_workers; i++) {
+        nv_kthread_mq_worker_t *worker = &mq->workers[i];
+
+        if (unlikely(!list_empty(&worker->q_list_head)))
+            NVQ_WARN("list not empty after flushing\n");
+
+        if (worker->q_kthread)
+            kthread_stop(worker->q_kthread);
+    }
+
+    kfree(mq->workers);
+    mq->workers = NULL;
+}
+
+void nv_kthread_mq_flush(nv_kthread_mq_t *mq)
+{
+    if (unlikely(atomic_read(&mq->main_loop_should_exit))) {
+        NVQ_WARN("Not allowed: nv_kthread_mq_flush was called after "
+                   "nv_kthread_mq_stop. mq: 0x%p\n", mq);
+        return;
+    }
+
+    wait_event(mq->flush_wait, atomic_read(&mq->outstanding) == 0);
+}
+
+// Picks the deque of a new item: the current worker's one when called from a
+// callback, otherwise the next worker on the current NUMA node, if any.
+static nv_kthread_mq_worker_t *_mq_pick_worker(nv_kthread_mq_t *mq)
+{
+    int node = numa_node_id();
+    unsigned start, i;
+
+    for (i = 0; i < mq->num_workers; i++) {
+        if (mq->workers[i].q_kthread == current)
+            return &mq->workers[i];
+    }
+
+    start = (unsigned)atomic_inc_return(&mq->next_worker);
+
+    for (i = 0; i < mq->num_workers; i++) {
+        nv_kthread_mq_worker_t *worker = &mq->workers[(start + i) % mq->num_workers];
+
+        if (worker->node == node)
+            return worker;
+    }
+
+    return &mq->workers[start % mq->num_workers];
+}
+
+// Wakes up an idle worker to steal from a busy one, preferring the workers on
+// the given node.
+static void _mq_wake_idle_worker(nv_kthread_mq_t *mq, int node)
+{
+    nv_kthread_mq_worker_t *idle_worker = NULL;
+    unsigned i;
+
+    for (i = 0; i < mq->num_workers; i++) {
+        nv_kthread_mq_worker_t *worker = &mq->workers[i];
+
+        if (!atomic_read(&worker->is_idle))
+            continue;
+
+        idle_worker = worker;
+        if (worker->node == node)
+            break;
+    }
+
+    if (idle_worker)
+        wake_up(&idle_worker->q_wait);
+}
+
+int nv_kthread_mq_schedule_q_item(nv_kthread_mq_t *mq,
+                                  nv_kthread_q_item_t *q_item)
+{
+    nv_kthread_mq_worker_t *worker;
+    unsigned long flags;
+    int occupancy;
+
+    if (unlikely(atomic_read(&mq->main_loop_should_exit))) {
+        NVQ_WARN("Not allowed: nv_kthread_mq_schedule_q_item was "
+                   "called with a non-alive mq: 0x%p\n", mq);
+        return 0;
+    }
+
+    if (atomic_cmpxchg(&q_item->is_pending, 0, 1) != 0)
+        return 0;
+
+    worker = _mq_pick_worker(mq);
+
+    q_item->schedule_time_ns = ktime_to_ns(ktime_get());
+    atomic_inc(&mq->outstanding);
+    atomic64_inc(&mq->items_scheduled);
+
+    spin_lock_irqsave(&worker->q_lock, flags);
+    list_add_tail(&q_item->q_list_node, &worker->q_list_head);
+    occupancy = atomic_inc_return(&mq->pending);
+    spin_unlock_irqrestore(&worker->q_lock, flags);
+
+    _atomic_max(&mq->max_occupancy, occupancy);
+
+    wake_up(&worker->q_wait);
+
+    if (!atomic_read(&worker->is_idle))
+        _mq_wake_idle_worker(mq, worker->node);
+
+    return 1;
+}
+
+void nv_kthread_mq_get_stats(nv_kthread_mq_t *mq, nv_kthread_mq_stats_t *stats)
+{
+    stats->items_scheduled  = atomic64_read(&mq->items_scheduled);
+    stats->items_run        = atomic64_read(&mq->items_run);
+    stats->items_stolen     = atomic64_read(&mq->items_stolen);
+    stats->total_latency_ns = atomic64_read(&mq->total_latency_ns);
+    stats->max_latency_ns   = atomic64_read(&mq->max_latency_ns);
+    stats->occupancy        = max(atomic_read(&mq->pending), 0);
+    stats->max_occupancy    = atomic_read(&mq->max_occupancy);
+}
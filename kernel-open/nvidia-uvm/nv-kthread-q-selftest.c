@@ -29,6 +29,8 @@
 #include <linux/module.h>
 #include <linux/cpumask.h>
 #include <linux/mm.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
 
 // If NV_BUILD_MODULE_INSTANCES is not defined, do it here in order to avoid
 // build warnings/errors when including nv-linux.h as it expects the definition
@@ -79,6 +81,10 @@
 #define NUM_TEST_Q_ITEMS                (100 * 1000)
 #define NUM_TEST_KTHREADS               8
 #define NUM_Q_ITEMS_IN_MULTITHREAD_TEST (NUM_TEST_Q_ITEMS * NUM_TEST_KTHREADS)
+#define NUM_MQ_TEST_WORKERS             4
+#define NUM_MQ_SCALING_Q_ITEMS          (20 * 1000)
+#define MAX_MQ_SCALING_WORKERS          16
+#define MQ_STEAL_WAIT_MS                (10 * 1000)
 
 // This exists in order to have a function to place a breakpoint on:
 static void on_nvq_assert(void)
@@ -541,6 +547,180 @@ static int _check_cpu_affinity_test(void)
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Multi-worker queue tests
+
+typedef struct mq_args
+{
+    nv_kthread_mq_t     *test_mq;
+    nv_kthread_q_item_t *q_items;
+    int                  num_children;
+    atomic_t             accumulator;
+    int                  test_failure;
+} mq_args_t;
+
+static void _mq_callback(void *args)
+{
+    mq_args_t *mq_args = (mq_args_t*)args;
+
+    atomic_inc(&mq_args->accumulator);
+}
+
+// Schedules the child items from within a callback, which puts them on the
+// deque of the current worker, for the other workers to steal. The current
+// worker is busy in here until a child has run, so that child must have been
+// stolen by another worker.
+static void _mq_parent_callback(void *args)
+{
+    mq_args_t *mq_args = (mq_args_t*)args;
+    int i;
+
+    for (i = 0; i < mq_args->num_children; ++i) {
+        nv_kthread_q_item_init(&mq_args->q_items[i], _mq_callback, mq_args);
+
+        if (!nv_kthread_mq_schedule_q_item(mq_args->test_mq, &mq_args->q_items[i]))
+            mq_args->test_failure = 1;
+    }
+
+    for (i = 0; i < MQ_STEAL_WAIT_MS && atomic_read(&mq_args->accumulator) == 0; ++i)
+        msleep(1);
+
+    if (atomic_read(&mq_args->accumulator) == 0)
+        mq_args->test_failure = 1;
+}
+
+static int _mq_basic_test(void)
+{
+    int i, result;
+    int num_scheduled = 0;
+    nv_kthread_mq_t local_mq;
+    nv_kthread_mq_stats_t stats;
+    nv_kthread_q_item_t parent_item;
+    nv_kthread_q_item_t same_item;
+    mq_args_t mq_args;
+
+    // Stopping a zero initialized queue, or a queue that failed to initialize,
+    // is a no-op.
+    memset(&local_mq, 0, sizeof(local_mq));
+    nv_kthread_mq_stop(&local_mq);
+
+    result = nv_kthread_mq_init(&local_mq, "mq_bad", 0);
+    TEST_CHECK_RET(result != 0);
+    nv_kthread_mq_stop(&local_mq);
+
+    memset(&mq_args, 0, sizeof(mq_args));
+    mq_args.test_mq = &local_mq;
+    mq_args.num_children = NUM_TEST_Q_ITEMS / 10;
+    mq_args.q_items = vmalloc(mq_args.num_children * sizeof(nv_kthread_q_item_t));
+    TEST_CHECK_RET(mq_args.q_items != NULL);
+
+    result = nv_kthread_mq_init(&local_mq, "mq_basic", NUM_MQ_TEST_WORKERS);
+    if (result != 0) {
+        vfree(mq_args.q_items);
+        TEST_CHECK_RET(result == 0);
+    }
+
+    nv_kthread_q_item_init(&parent_item, _mq_parent_callback, &mq_args);
+    result = !nv_kthread_mq_schedule_q_item(&local_mq, &parent_item);
+
+    nv_kthread_mq_flush(&local_mq);
+
+    // Scheduling an item that is already pending is a no-op
+    nv_kthread_q_item_init(&same_item, _mq_callback, &mq_args);
+    for (i = 0; i < 1000; ++i)
+        num_scheduled += nv_kthread_mq_schedule_q_item(&local_mq, &same_item);
+
+    nv_kthread_mq_flush(&local_mq);
+
+    nv_kthread_mq_get_stats(&local_mq, &stats);
+    nv_kthread_mq_stop(&local_mq);
+    vfree(mq_args.q_items);
+
+    TEST_CHECK_RET(result == 0);
+    TEST_CHECK_RET(mq_args.test_failure == 0);
+    TEST_CHECK_RET(num_scheduled >= 1);
+    TEST_CHECK_RET(atomic_read(&mq_args.accumulator) == mq_args.num_children + num_scheduled);
+
+    TEST_CHECK_RET(stats.items_scheduled == 1 + mq_args.num_children + num_scheduled);
+    TEST_CHECK_RET(stats.items_run == stats.items_scheduled);
+    TEST_CHECK_RET(stats.items_stolen > 0);
+    TEST_CHECK_RET(stats.items_stolen <= stats.items_run);
+    TEST_CHECK_RET(stats.max_latency_ns <= stats.total_latency_ns);
+    TEST_CHECK_RET(stats.occupancy == 0);
+    TEST_CHECK_RET(stats.max_occupancy >= 1);
+
+    return 0;
+}
+
+static void _mq_scaling_callback(void *args)
+{
+    atomic_t *accumulator = (atomic_t*)args;
+
+    // Stand-in for a short bottom half
+    udelay(2);
+
+    atomic_inc(accumulator);
+}
+
+// Runs the same batch of items with a growing number of workers, and reports
+// the throughput. Only correctness is checked: the scaling depends on the
+// number of CPUs and on what else is running on them.
+static int _mq_scaling_test(void)
+{
+    int result = 0;
+    unsigned i, num_workers;
+    unsigned max_workers = min_t(unsigned, num_online_cpus(), MAX_MQ_SCALING_WORKERS);
+    nv_kthread_q_item_t *q_items;
+    atomic_t accumulator;
+
+    q_items = vmalloc(NUM_MQ_SCALING_Q_ITEMS * sizeof(nv_kthread_q_item_t));
+    TEST_CHECK_RET(q_items != NULL);
+
+    for (num_workers = 1; num_workers <= max_workers; num_workers *= 2) {
+        nv_kthread_mq_t local_mq;
+        nv_kthread_mq_stats_t stats;
+        u64 start_ns, elapsed_ns;
+
+        result = nv_kthread_mq_init(&local_mq, "mq_scaling", num_workers);
+        if (result != 0)
+            break;
+
+        atomic_set(&accumulator, 0);
+        start_ns = ktime_to_ns(ktime_get());
+
+        for (i = 0; i < NUM_MQ_SCALING_Q_ITEMS; ++i) {
+            nv_kthread_q_item_init(&q_items[i], _mq_scaling_callback, &accumulator);
+            result |= !nv_kthread_mq_schedule_q_item(&local_mq, &q_items[i]);
+        }
+
+        nv_kthread_mq_flush(&local_mq);
+
+        elapsed_ns = max_t(u64, ktime_to_ns(ktime_get()) - start_ns, 1);
+
+        nv_kthread_mq_get_stats(&local_mq, &stats);
+        nv_kthread_mq_stop(&local_mq);
+
+        NVQ_TEST_PRINT("%u workers: %llu items/sec, latency avg %llu ns max %llu ns, %llu stolen, max occupancy %u\n",
+                       num_workers,
+                       div64_u64((u64)NUM_MQ_SCALING_Q_ITEMS * NSEC_PER_SEC, elapsed_ns),
+                       div64_u64(stats.total_latency_ns, max_t(u64, stats.items_run, 1)),
+                       stats.max_latency_ns,
+                       stats.items_stolen,
+                       stats.max_occupancy);
+
+        if (result != 0 || atomic_read(&accumulator) != NUM_MQ_SCALING_Q_ITEMS) {
+            result = -1;
+            break;
+        }
+    }
+
+    vfree(q_items);
+
+    TEST_CHECK_RET(result == 0);
+
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Top-level test entry point
 
@@ -563,5 +743,11 @@ int nv_kthread_q_run_self_test(void)
     result = _check_cpu_affinity_test();
     TEST_CHECK_RET(result == 0);
 
+    result = _mq_basic_test();
+    TEST_CHECK_RET(result == 0);
+
+    result = _mq_scaling_test();
+    TEST_CHECK_RET(result == 0);
+
     return 0;
 }
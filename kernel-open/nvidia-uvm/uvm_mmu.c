@@ -359,6 +359,30 @@ static void uvm_mmu_page_table_cpu_memset_16(uvm_gpu_t *gpu,
     uvm_mmu_page_table_cpu_unmap(gpu, phys_alloc, ptr);
 }
 
+// Returns the physical allocations the PDE at entry_index of dir should point
+// to. If phys_addr is NULL, they are taken from the children of dir in the host
+// tree and stored in entry_phys_addr. Otherwise phys_addr is returned as-is.
+static uvm_mmu_page_table_alloc_t **pde_phys_allocs(uvm_page_tree_t *tree,
+                                                    uvm_page_directory_t *dir,
+                                                    NvU32 entry_index,
+                                                    uvm_mmu_page_table_alloc_t **phys_addr,
+                                                    uvm_mmu_page_table_alloc_t **entry_phys_addr)
+{
+    NvU32 i;
+    NvU32 entries_per_index = tree->hal->entries_per_index(dir->depth);
+
+    if (phys_addr)
+        return phys_addr;
+
+    // extract physical allocs from non-null entries.
+    for (i = 0; i < entries_per_index; i++) {
+        uvm_page_directory_t *entry = dir->entries[entries_per_index * entry_index + i];
+        entry_phys_addr[i] = entry ? &entry->phys_alloc : NULL;
+    }
+
+    return entry_phys_addr;
+}
+
 static void pde_fill_cpu(uvm_page_tree_t *tree,
                          uvm_page_directory_t *directory,
                          NvU32 start_index,
@@ -366,6 +390,7 @@ static void pde_fill_cpu(uvm_page_tree_t *tree,
                          uvm_mmu_page_table_alloc_t **phys_addr)
 {
     NvU64 pde_data[2], entry_size;
+    uvm_mmu_page_table_alloc_t *entry_phys_addr[2];
     NvU32 i;
 
     UVM_ASSERT(uvm_mmu_use_cpu(tree));
@@ -374,7 +399,10 @@ static void pde_fill_cpu(uvm_page_tree_t *tree,
     UVM_ASSERT(sizeof(pde_data) >= entry_size);
 
     for (i = 0; i < pde_count; i++) {
-        tree->hal->make_pde(pde_data, phys_addr, directory, start_index + i);
+        tree->hal->make_pde(pde_data,
+                            pde_phys_allocs(tree, directory, start_index + i, phys_addr, entry_phys_addr),
+                            directory,
+                            start_index + i);
 
         if (entry_size == sizeof(pde_data[0]))
             uvm_mmu_page_table_cpu_memset_8(tree->gpu, &directory->phys_alloc, start_index + i, pde_data[0], 1);
@@ -396,6 +424,7 @@ static void pde_fill_gpu(uvm_page_tree_t *tree,
     uvm_membar_t push_membar;
     uvm_gpu_address_t inline_data_addr;
     uvm_push_inline_data_t inline_data;
+    uvm_mmu_page_table_alloc_t *entry_phys_addr[2];
     NvU32 entry_count, i, j;
 
     UVM_ASSERT(!uvm_mmu_use_cpu(tree));
@@ -424,7 +453,10 @@ static void pde_fill_gpu(uvm_page_tree_t *tree,
 
         uvm_push_inline_data_begin(push, &inline_data);
         for (j = 0; j < entry_count; j++) {
-            tree->hal->make_pde(pde_data, phys_addr, directory, start_index + i + j);
+            tree->hal->make_pde(pde_data,
+                                pde_phys_allocs(tree, directory, start_index + i + j, phys_addr, entry_phys_addr),
+                                directory,
+                                start_index + i + j);
             uvm_push_inline_data_add(&inline_data, pde_data, entry_size);
         }
         inline_data_addr = uvm_push_inline_data_end(&inline_data);
@@ -437,7 +469,9 @@ static void pde_fill_gpu(uvm_page_tree_t *tree,
 }
 
 // pde_fill() populates pde_count PDE entries (starting at start_index) with
-// the same mapping, i.e., with the same physical address (phys_addr).
+// the same mapping, i.e., with the same physical address (phys_addr). If
+// phys_addr is NULL, each entry is instead written with the children currently
+// present in the host tree, which lets adjacent PDE writes be coalesced.
 // pde_fill() is optimized for pde_count == 1, which is the common case.
 static void pde_fill(uvm_page_tree_t *tree,
                      uvm_page_directory_t *directory,
@@ -530,15 +564,10 @@ static void phys_mem_init(uvm_page_tree_t *tree, NvU64 page_size, uvm_page_direc
     }
 }
 
-static uvm_page_directory_t *allocate_directory(uvm_page_tree_t *tree,
-                                                NvU64 page_size,
-                                                NvU32 depth,
-                                                uvm_pmm_alloc_flags_t pmm_flags)
+static uvm_page_directory_t *allocate_directory_host(uvm_page_tree_t *tree, NvU64 page_size, NvU32 depth)
 {
-    NV_STATUS status;
     uvm_mmu_mode_hal_t *hal = tree->hal;
     NvU32 entry_count;
-    NvLength phys_alloc_size = hal->allocation_size(depth, page_size);
     uvm_page_directory_t *dir;
 
     // The page tree doesn't cache PTEs so space is not allocated for entries
@@ -554,7 +583,17 @@ static uvm_page_directory_t *allocate_directory(uvm_page_tree_t *tree,
     if (dir == NULL)
         return NULL;
 
-    status = phys_mem_allocate(tree, phys_alloc_size, tree->location, pmm_flags, &dir->phys_alloc);
+    dir->depth = depth;
+
+    return dir;
+}
+
+static NV_STATUS allocate_directory_phys(uvm_page_tree_t *tree,
+                                         NvLength size,
+                                         uvm_pmm_alloc_flags_t pmm_flags,
+                                         uvm_mmu_page_table_alloc_t *out)
+{
+    NV_STATUS status = phys_mem_allocate(tree, size, tree->location, pmm_flags, out);
 
     // Fall back to sysmem if allocating page tables in vidmem with eviction
     // fails, and the fallback is allowed.
@@ -562,18 +601,124 @@ static uvm_page_directory_t *allocate_directory(uvm_page_tree_t *tree,
         (tree->location == UVM_APERTURE_VID) &&
         (tree->location_sys_fallback) &&
         ((pmm_flags & UVM_PMM_ALLOC_FLAGS_EVICT) != 0)) {
-        status = phys_mem_allocate(tree, phys_alloc_size, UVM_APERTURE_SYS, pmm_flags, &dir->phys_alloc);
+        status = phys_mem_allocate(tree, size, UVM_APERTURE_SYS, pmm_flags, out);
     }
 
+    return status;
+}
+
+static uvm_page_directory_t *allocate_directory(uvm_page_tree_t *tree,
+                                                NvU64 page_size,
+                                                NvU32 depth,
+                                                uvm_pmm_alloc_flags_t pmm_flags)
+{
+    NV_STATUS status;
+    NvLength phys_alloc_size = tree->hal->allocation_size(depth, page_size);
+    uvm_page_directory_t *dir;
+
+    dir = allocate_directory_host(tree, page_size, depth);
+    if (dir == NULL)
+        return NULL;
+
+    status = allocate_directory_phys(tree, phys_alloc_size, pmm_flags, &dir->phys_alloc);
     if (status != NV_OK) {
         uvm_kvfree(dir);
         return NULL;
     }
-    dir->depth = depth;
 
     return dir;
 }
 
+// Allocate count directories at the given depth into dirs. Vidmem backing for
+// all of them is requested from PMM with a single call, falling back to
+// per-directory allocations (and the sysmem fallback) if that fails.
+//
+// On failure, no directories are left allocated.
+static NV_STATUS allocate_directories(uvm_page_tree_t *tree,
+                                      NvU64 page_size,
+                                      NvU32 depth,
+                                      NvU32 count,
+                                      uvm_pmm_alloc_flags_t pmm_flags,
+                                      uvm_page_directory_t **dirs)
+{
+    NV_STATUS status = NV_OK;
+    NvLength phys_alloc_size = tree->hal->allocation_size(depth, page_size);
+    uvm_gpu_chunk_t **chunks = NULL;
+    NvU32 phys_count = 0;
+    NvU32 i;
+
+    memset(dirs, 0, sizeof(*dirs) * count);
+
+    for (i = 0; i < count; i++) {
+        dirs[i] = allocate_directory_host(tree, page_size, depth);
+        if (dirs[i] == NULL) {
+            status = NV_ERR_NO_MEMORY;
+            goto error;
+        }
+    }
+
+    if (tree->location == UVM_APERTURE_VID && count > 1)
+        chunks = uvm_kvmalloc(sizeof(*chunks) * count);
+
+    if (chunks) {
+        uvm_tracker_t local_tracker = UVM_TRACKER_INIT();
+
+        status = uvm_pmm_gpu_alloc_kernel(&tree->gpu->pmm,
+                                          count,
+                                          phys_alloc_size,
+                                          pmm_flags,
+                                          chunks,
+                                          &local_tracker);
+        if (status == NV_OK && !uvm_tracker_is_empty(&local_tracker)) {
+            uvm_mutex_lock(&tree->lock);
+            status = uvm_tracker_add_tracker_safe(&tree->tracker, &local_tracker);
+            uvm_mutex_unlock(&tree->lock);
+
+            if (status != NV_OK) {
+                for (i = 0; i < count; i++)
+                    uvm_pmm_gpu_free(&tree->gpu->pmm, chunks[i], NULL);
+            }
+        }
+
+        uvm_tracker_deinit(&local_tracker);
+
+        if (status == NV_OK) {
+            for (i = 0; i < count; i++) {
+                dirs[i]->phys_alloc.handle.chunk = chunks[i];
+                dirs[i]->phys_alloc.addr = uvm_gpu_phys_address(UVM_APERTURE_VID, chunks[i]->address);
+                dirs[i]->phys_alloc.size = phys_alloc_size;
+            }
+
+            phys_count = count;
+        }
+
+        uvm_kvfree(chunks);
+    }
+
+    for (; phys_count < count; phys_count++) {
+        status = allocate_directory_phys(tree, phys_alloc_size, pmm_flags, &dirs[phys_count]->phys_alloc);
+        if (status != NV_OK)
+            goto error;
+    }
+
+    return NV_OK;
+
+error:
+    if (phys_count > 0) {
+        uvm_mutex_lock(&tree->lock);
+        for (i = 0; i < phys_count; i++)
+            phys_mem_deallocate(tree, &dirs[i]->phys_alloc);
+        uvm_mutex_unlock(&tree->lock);
+    }
+
+    for (i = 0; i < count; i++) {
+        uvm_kvfree(dirs[i]);
+        dirs[i] = NULL;
+    }
+
+    return status;
+}
+
 static inline NvU32 entry_index_from_vaddr(NvU64 vaddr, NvU32 addr_bit_shift, NvU32 bits)
 {
     NvU64 mask = ((NvU64)1 << bits) - 1;
@@ -601,20 +746,24 @@ static void pde_write(uvm_page_tree_t *tree,
                       bool force_clear,
                       uvm_push_t *push)
 {
-    NvU32 i;
-    uvm_mmu_page_table_alloc_t *phys_allocs[2];
-    NvU32 entries_per_index = tree->hal->entries_per_index(dir->depth);
+    uvm_mmu_page_table_alloc_t *phys_allocs[2] = {NULL, NULL};
 
-    // extract physical allocs from non-null entries.
-    for (i = 0; i < entries_per_index; i++) {
-        uvm_page_directory_t *entry = dir->entries[entries_per_index * entry_index + i];
-        if (entry == NULL || force_clear)
-            phys_allocs[i] = NULL;
-        else
-            phys_allocs[i] = &entry->phys_alloc;
-    }
+    pde_fill(tree, dir, entry_index, 1, force_clear ? phys_allocs : NULL, push);
+}
 
-    pde_fill(tree, dir, entry_index, 1, phys_allocs, push);
+// Number of consecutive entries of dirs, ending at dirs[last] and walking
+// backwards, that are inserted into adjacent PDEs of the same parent. Their PDEs
+// can be written with a single pde_fill().
+static NvU32 pde_write_run_length(uvm_page_directory_t **dirs, NvS32 last)
+{
+    NvS32 i = last;
+
+    while (i > 0 &&
+           dirs[i - 1]->host_parent == dirs[last]->host_parent &&
+           dirs[i - 1]->index_in_parent + 1 == dirs[i]->index_in_parent)
+        i--;
+
+    return last - i + 1;
 }
 
 static void host_pde_clear(uvm_page_tree_t *tree, uvm_page_directory_t *dir, NvU32 entry_index, NvU64 page_size)
@@ -705,6 +854,7 @@ static NV_STATUS write_gpu_state_cpu(uvm_page_tree_t *tree,
                                      uvm_page_directory_t **dirs_used)
 {
     NvS32 i;
+    NvU32 run;
     uvm_push_t push;
     NV_STATUS status;
 
@@ -726,9 +876,12 @@ static NV_STATUS write_gpu_state_cpu(uvm_page_tree_t *tree,
     mb();
 
     // write entries bottom up, so that they are valid once they're inserted
-    // into the tree
-    for (i = used_count - 1; i >= 0; i--)
-        pde_write(tree, dirs_used[i]->host_parent, dirs_used[i]->index_in_parent, false, NULL);
+    // into the tree. Directories inserted into adjacent PDEs of the same parent
+    // are written together.
+    for (i = used_count - 1; i >= 0; i -= run) {
+        run = pde_write_run_length(dirs_used, i);
+        pde_fill(tree, dirs_used[i]->host_parent, dirs_used[i - run + 1]->index_in_parent, run, NULL, NULL);
+    }
 
     // A CPU membar is needed between the PDE writes and the subsequent TLB
     // invalidate. Work submission guarantees such a membar.
@@ -756,6 +909,7 @@ static NV_STATUS write_gpu_state_gpu(uvm_page_tree_t *tree,
                                      uvm_page_directory_t **dirs_used)
 {
     NvS32 i;
+    NvU32 run;
     uvm_push_t push;
     NV_STATUS status;
 
@@ -798,22 +952,25 @@ static NV_STATUS write_gpu_state_gpu(uvm_page_tree_t *tree,
     membar_after_writes = UVM_MEMBAR_GPU;
 
     // write entries bottom up, so that they are valid once they're inserted
-    // into the tree
-    for (i = used_count - 1; i >= 0; i--) {
-        uvm_page_directory_t *dir = dirs_used[i];
+    // into the tree. Directories inserted into adjacent PDEs of the same parent
+    // are written with a single copy.
+    for (i = used_count - 1; i >= 0; i -= run) {
+        uvm_page_directory_t *parent = dirs_used[i]->host_parent;
+
+        run = pde_write_run_length(dirs_used, i);
 
         // Appropriate membar will be done after all the writes. Pipelining can
         // be enabled as they are all independent and we just did a WFI above.
         uvm_push_set_flag(&push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
         uvm_push_set_flag(&push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
-        pde_write(tree, dir->host_parent, dir->index_in_parent, false, &push);
+        pde_fill(tree, parent, dirs_used[i - run + 1]->index_in_parent, run, NULL, &push);
 
         // If any of the written PDEs is in sysmem, a sysmembar is needed before
         // the TLB invalidate.
         // Notably sysmembar is needed even though the writer (CE) and reader
         // (MMU) are on the same GPU, because CE physical writes take the L2
         // bypass path.
-        if (dir->host_parent->phys_alloc.addr.aperture == UVM_APERTURE_SYS)
+        if (parent->phys_alloc.addr.aperture == UVM_APERTURE_SYS)
             membar_after_writes = UVM_MEMBAR_SYS;
     }
 
@@ -1560,6 +1717,8 @@ NV_STATUS uvm_page_tree_get_ptes_async(uvm_page_tree_t *tree,
 {
     NV_STATUS status;
     NvU32 cur_depth = 0;
+    NvU32 depth;
+    NvU32 page_table_depth = tree->hal->page_table_depth(page_size);
     uvm_page_directory_t *dir_cache[MAX_OPERATION_DEPTH];
     memset(dir_cache, 0, sizeof(dir_cache));
 
@@ -1574,15 +1733,20 @@ NV_STATUS uvm_page_tree_get_ptes_async(uvm_page_tree_t *tree,
         uvm_mutex_unlock(&tree->lock);
 
         // try_get_ptes never needs depth 0, so store a directory at its
-        // parent's depth.
-        // TODO: Bug 1766655: Allocate everything below cur_depth instead of
-        //       retrying for every level.
-        dir_cache[cur_depth] = allocate_directory(tree, page_size, cur_depth + 1, pmm_flags);
-        if (dir_cache[cur_depth] == NULL) {
-            uvm_mutex_lock(&tree->lock);
-            free_unused_directories(tree, 0, NULL, dir_cache);
-            uvm_mutex_unlock(&tree->lock);
-            return NV_ERR_NO_MEMORY;
+        // parent's depth. Every level below a missing directory is missing
+        // too, so allocate all of them at once instead of retrying for every
+        // level.
+        for (depth = cur_depth; depth < page_table_depth; depth++) {
+            if (dir_cache[depth] != NULL)
+                continue;
+
+            dir_cache[depth] = allocate_directory(tree, page_size, depth + 1, pmm_flags);
+            if (dir_cache[depth] == NULL) {
+                uvm_mutex_lock(&tree->lock);
+                free_unused_directories(tree, 0, NULL, dir_cache);
+                uvm_mutex_unlock(&tree->lock);
+                return NV_ERR_NO_MEMORY;
+            }
         }
 
         uvm_mutex_lock(&tree->lock);
@@ -1817,6 +1981,322 @@ static size_t range_vec_calc_range_index(uvm_page_table_range_vec_t *range_vec,
     return (size_t)uvm_div_pow2_64(aligned_addr - aligned_start, pde_coverage);
 }
 
+// Directories preallocated by range_vec_get_ptes_async(), indexed by the depth
+// of their parent like the dir_cache in uvm_page_tree_get_ptes_async().
+typedef struct
+{
+    uvm_page_directory_t **dirs[MAX_OPERATION_DEPTH];
+
+    // Number of allocated directories
+    NvU32 count[MAX_OPERATION_DEPTH];
+
+    // Number of directories inserted into the tree
+    NvU32 used[MAX_OPERATION_DEPTH];
+} dir_pool_t;
+
+// Count, per depth of the parent, the directories missing from the tree for
+// all the page tables covering the range vector.
+static void range_vec_count_missing_directories(uvm_page_table_range_vec_t *range_vec, NvU32 *counts)
+{
+    uvm_page_tree_t *tree = range_vec->tree;
+    uvm_mmu_mode_hal_t *hal = tree->hal;
+    NvU64 page_size = range_vec->page_size;
+    NvU32 page_table_depth = hal->page_table_depth(page_size);
+    NvU64 last_key[MAX_OPERATION_DEPTH];
+    size_t i;
+
+    uvm_assert_mutex_locked(&tree->lock);
+
+    memset(counts, 0, sizeof(*counts) * MAX_OPERATION_DEPTH);
+
+    // VAs are much narrower than 64 bits, so no entry can have this key
+    memset(last_key, 0xff, sizeof(last_key));
+
+    for (i = 0; i < range_vec->range_count; ++i) {
+        NvU64 addr = range_vec_calc_range_start(range_vec, i);
+        NvU32 addr_bit_shift = hal->num_va_bits();
+        uvm_page_directory_t *dir = tree->root;
+
+        while (dir->depth != page_table_depth) {
+            NvU32 index_bits = hal->index_bits(dir->depth, page_size);
+            NvU32 index;
+            NvU32 depth;
+
+            addr_bit_shift -= index_bits;
+            index = entry_index_from_vaddr(addr, addr_bit_shift, index_bits);
+
+            if (dir->entries[index_to_entry(hal, index, dir->depth, page_size)] != NULL) {
+                dir = dir->entries[index_to_entry(hal, index, dir->depth, page_size)];
+                continue;
+            }
+
+            // Everything below the missing entry is missing too. Adjacent
+            // subranges share their upper level directories, which are
+            // identified by the VA bits above the entry pointing to them.
+            for (depth = dir->depth; depth < page_table_depth; depth++) {
+                NvU64 key = addr >> addr_bit_shift;
+
+                if (key != last_key[depth]) {
+                    last_key[depth] = key;
+                    counts[depth]++;
+                }
+
+                addr_bit_shift -= hal->index_bits(depth + 1, page_size);
+            }
+
+            break;
+        }
+    }
+}
+
+// Grow the pool so that it holds at least counts[depth] directories for each
+// depth.
+static NV_STATUS dir_pool_grow(uvm_page_tree_t *tree,
+                               dir_pool_t *pool,
+                               NvU64 page_size,
+                               const NvU32 *counts,
+                               uvm_pmm_alloc_flags_t pmm_flags)
+{
+    NV_STATUS status;
+    NvU32 depth;
+
+    for (depth = 0; depth < MAX_OPERATION_DEPTH; depth++) {
+        uvm_page_directory_t **dirs;
+
+        if (counts[depth] <= pool->count[depth])
+            continue;
+
+        dirs = uvm_kvrealloc(pool->dirs[depth], sizeof(*dirs) * counts[depth]);
+        if (!dirs)
+            return NV_ERR_NO_MEMORY;
+
+        pool->dirs[depth] = dirs;
+
+        status = allocate_directories(tree,
+                                      page_size,
+                                      depth + 1,
+                                      counts[depth] - pool->count[depth],
+                                      pmm_flags,
+                                      dirs + pool->count[depth]);
+        if (status != NV_OK)
+            return status;
+
+        pool->count[depth] = counts[depth];
+    }
+
+    return NV_OK;
+}
+
+// Free all the directories from the pool that were not inserted into the tree.
+static void dir_pool_deinit(uvm_page_tree_t *tree, dir_pool_t *pool)
+{
+    NvU32 depth, i;
+
+    uvm_assert_mutex_locked(&tree->lock);
+
+    for (depth = 0; depth < MAX_OPERATION_DEPTH; depth++) {
+        for (i = pool->used[depth]; i < pool->count[depth]; i++) {
+            phys_mem_deallocate(tree, &pool->dirs[depth][i]->phys_alloc);
+            uvm_kvfree(pool->dirs[depth][i]);
+        }
+
+        uvm_kvfree(pool->dirs[depth]);
+    }
+
+    memset(pool, 0, sizeof(*pool));
+}
+
+// Insert directories from the pool into the host tree so that all the page
+// tables covering the range vector are present, and initialize the ranges of
+// the vector. The inserted directories are returned in dirs_used, parents
+// before children.
+static NvU32 range_vec_insert_directories(uvm_page_table_range_vec_t *range_vec,
+                                          dir_pool_t *pool,
+                                          uvm_page_directory_t **dirs_used)
+{
+    uvm_page_tree_t *tree = range_vec->tree;
+    uvm_mmu_mode_hal_t *hal = tree->hal;
+    NvU64 page_size = range_vec->page_size;
+    NvU32 page_table_depth = hal->page_table_depth(page_size);
+    NvU32 used_count = 0;
+    size_t i;
+
+    uvm_assert_mutex_locked(&tree->lock);
+
+    for (i = 0; i < range_vec->range_count; ++i) {
+        NvU64 start = range_vec_calc_range_start(range_vec, i);
+        NvU64 end = range_vec_calc_range_end(range_vec, i);
+        NvU32 addr_bit_shift = hal->num_va_bits();
+        uvm_page_directory_t *dir = tree->root;
+
+        while (true) {
+            NvU32 index_bits = hal->index_bits(dir->depth, page_size);
+            NvU32 start_index, end_index;
+            uvm_page_directory_t **entry;
+
+            addr_bit_shift -= index_bits;
+            start_index = entry_index_from_vaddr(start, addr_bit_shift, index_bits);
+            end_index = entry_index_from_vaddr(end - 1, addr_bit_shift, index_bits);
+
+            if (dir->depth == page_table_depth) {
+                page_table_range_init(&range_vec->ranges[i], page_size, dir, start_index, end_index);
+                break;
+            }
+
+            UVM_ASSERT(start_index == end_index);
+
+            entry = dir->entries + index_to_entry(hal, start_index, dir->depth, page_size);
+            if (*entry == NULL) {
+                UVM_ASSERT(pool->used[dir->depth] < pool->count[dir->depth]);
+
+                *entry = host_pde_write(pool->dirs[dir->depth][pool->used[dir->depth]++], dir, start_index);
+                dirs_used[used_count++] = *entry;
+            }
+
+            dir = *entry;
+        }
+    }
+
+    return used_count;
+}
+
+// Conservative estimate of the push space needed to initialize dir and to write
+// the PDE pointing to it. See phys_mem_init(): the lowest level is always
+// initialized with a memset, while directories that can hold PDEs may be
+// initialized with inline PDE writes.
+static NvU32 dir_init_push_size(uvm_page_tree_t *tree, uvm_page_directory_t *dir)
+{
+    NvU32 size = 512 + tree->hal->entry_size(dir->host_parent->depth);
+
+    if (dir->depth != tree->hal->page_table_depth(UVM_PAGE_SIZE_AGNOSTIC))
+        size += dir->phys_alloc.size;
+
+    return size;
+}
+
+// Initialize the new directories and write the PDEs pointing to them, packing
+// as many directories as possible in each push.
+static NV_STATUS range_vec_write_gpu_state(uvm_page_tree_t *tree,
+                                          NvU64 page_size,
+                                          NvU32 used_count,
+                                          uvm_page_directory_t **dirs_used)
+{
+    NvU32 first = 0;
+
+    // Use as much push space as possible leaving 1K of margin
+    static const NvU32 max_push_size = UVM_MAX_PUSH_SIZE - 1024;
+
+    while (first < used_count) {
+        NV_STATUS status;
+        NvU32 count = 0;
+        NvU32 push_size = 0;
+        NvU32 invalidate_depth = dirs_used[first]->host_parent->depth;
+
+        for (; first + count < used_count; count++) {
+            uvm_page_directory_t *dir = dirs_used[first + count];
+            NvU32 dir_push_size = dir_init_push_size(tree, dir);
+
+            // The CPU path uses the push only for the TLB invalidate
+            if (!uvm_mmu_use_cpu(tree) && count > 0 && push_size + dir_push_size > max_push_size)
+                break;
+
+            push_size += dir_push_size;
+            invalidate_depth = min(invalidate_depth, dir->host_parent->depth);
+        }
+
+        status = write_gpu_state(tree, page_size, invalidate_depth, count, dirs_used + first);
+        if (status != NV_OK)
+            return status;
+
+        first += count;
+    }
+
+    return NV_OK;
+}
+
+// Get the PTEs for all the ranges of the vector. Unlike calling
+// uvm_page_tree_get_ptes_async() for each range, all the missing directories
+// are allocated up front, with a single PMM allocation per level, and they are
+// initialized and inserted into the tree with as few pushes as possible.
+static NV_STATUS range_vec_get_ptes_async(uvm_page_table_range_vec_t *range_vec, uvm_pmm_alloc_flags_t pmm_flags)
+{
+    NV_STATUS status = NV_OK;
+    uvm_page_tree_t *tree = range_vec->tree;
+    NvU32 counts[MAX_OPERATION_DEPTH];
+    NvU32 total_count = 0;
+    NvU32 used_count;
+    NvU32 depth;
+    size_t i;
+    uvm_page_directory_t **dirs_used = NULL;
+    dir_pool_t pool;
+
+    memset(&pool, 0, sizeof(pool));
+
+    uvm_mutex_lock(&tree->lock);
+
+    // The tree lock has to be dropped for allocating the directories, so
+    // recount afterwards in case the tree changed in the meantime.
+    while (true) {
+        range_vec_count_missing_directories(range_vec, counts);
+
+        for (depth = 0; depth < MAX_OPERATION_DEPTH; depth++) {
+            if (counts[depth] > pool.count[depth])
+                break;
+        }
+
+        if (depth == MAX_OPERATION_DEPTH)
+            break;
+
+        uvm_mutex_unlock(&tree->lock);
+        status = dir_pool_grow(tree, &pool, range_vec->page_size, counts, pmm_flags);
+        uvm_mutex_lock(&tree->lock);
+
+        if (status != NV_OK)
+            goto done;
+    }
+
+    for (depth = 0; depth < MAX_OPERATION_DEPTH; depth++)
+        total_count += counts[depth];
+
+    if (total_count > 0) {
+        dirs_used = uvm_kvmalloc(sizeof(*dirs_used) * total_count);
+        if (!dirs_used) {
+            status = NV_ERR_NO_MEMORY;
+            goto done;
+        }
+    }
+
+    used_count = range_vec_insert_directories(range_vec, &pool, dirs_used);
+    UVM_ASSERT(used_count == total_count);
+
+    // Release the directories not needed anymore before writing the GPU state
+    // like try_get_ptes() does.
+    dir_pool_deinit(tree, &pool);
+
+    status = range_vec_write_gpu_state(tree, range_vec->page_size, used_count, dirs_used);
+    if (status != NV_OK)
+        goto done;
+
+    if (tree->gpu->parent->map_remap_larger_page_promotion) {
+        for (i = 0; i < range_vec->range_count; ++i) {
+            NvU64 range_start = range_vec_calc_range_start(range_vec, i);
+            NvU64 range_size = range_vec_calc_range_size(range_vec, i);
+
+            status = map_remap(tree, range_start, range_size, &range_vec->ranges[i]);
+            if (status != NV_OK)
+                goto done;
+        }
+    }
+
+done:
+    dir_pool_deinit(tree, &pool);
+    uvm_mutex_unlock(&tree->lock);
+
+    uvm_kvfree(dirs_used);
+
+    return status;
+}
+
 NV_STATUS uvm_page_table_range_vec_init(uvm_page_tree_t *tree,
                                         NvU64 start,
                                         NvU64 size,
@@ -1825,7 +2305,6 @@ NV_STATUS uvm_page_table_range_vec_init(uvm_page_tree_t *tree,
                                         uvm_page_table_range_vec_t *range_vec)
 {
     NV_STATUS status;
-    size_t i;
 
     UVM_ASSERT(size != 0);
     UVM_ASSERT_MSG(IS_ALIGNED(start, page_size), "start 0x%llx page_size 0x%llx\n", start, page_size);
@@ -1843,28 +2322,14 @@ NV_STATUS uvm_page_table_range_vec_init(uvm_page_tree_t *tree,
         goto out;
     }
 
-    for (i = 0; i < range_vec->range_count; ++i) {
-        uvm_page_table_range_t *range = &range_vec->ranges[i];
-
-        NvU64 range_start = range_vec_calc_range_start(range_vec, i);
-        NvU64 range_size = range_vec_calc_range_size(range_vec, i);
-
-        status = uvm_page_tree_get_ptes_async(tree,
-                                              page_size,
-                                              range_start,
-                                              range_size,
-                                              pmm_flags,
-                                              range);
-        if (status != NV_OK) {
-            UVM_ERR_PRINT("Failed to get PTEs for subrange %zd [0x%llx, 0x%llx) size 0x%llx, part of [0x%llx, 0x%llx)\n",
-                          i,
-                          range_start,
-                          range_start + range_size,
-                          range_size,
-                          start,
-                          size);
-            goto out;
-        }
+    status = range_vec_get_ptes_async(range_vec, pmm_flags);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Failed to get PTEs for [0x%llx, 0x%llx) page_size 0x%llx: %s\n",
+                      start,
+                      start + size,
+                      page_size,
+                      nvstatusToString(status));
+        goto out;
     }
 
     status = uvm_page_tree_wait(tree);
@@ -2074,19 +2539,172 @@ NV_STATUS uvm_page_table_range_vec_clear_ptes(uvm_page_table_range_vec_t *range_
         return uvm_page_table_range_vec_clear_ptes_gpu(range_vec, tlb_membar);
 }
 
-void uvm_page_table_range_vec_deinit(uvm_page_table_range_vec_t *range_vec)
+// Clear the PDEs pointing to dirs[0..*last], walking backwards, with a single
+// push followed by a single TLB invalidate. Adjacent PDE clears are coalesced
+// and as many as fit are packed into the push. *last is updated to the last
+// directory whose PDE still has to be cleared, or -1 if none.
+static NV_STATUS range_vec_clear_pdes(uvm_page_tree_t *tree,
+                                      NvU64 page_size,
+                                      uvm_page_directory_t **dirs,
+                                      NvS32 *last)
+{
+    NV_STATUS status = NV_OK;
+    uvm_push_t push;
+    NvU32 push_size = 0;
+    NvU32 invalidate_depth = dirs[*last]->host_parent->depth;
+
+    // See uvm_page_tree_put_ptes_async() for the membar requirements
+    uvm_membar_t membar_after_pde_clears = UVM_MEMBAR_GPU;
+    uvm_membar_t membar_after_invalidate = UVM_MEMBAR_GPU;
+
+    // Use as much push space as possible leaving 1K of margin
+    static const NvU32 max_push_size = UVM_MAX_PUSH_SIZE - 1024;
+
+    if (uvm_mmu_use_cpu(tree))
+        status = uvm_tracker_wait(&tree->tracker);
+
+    if (status == NV_OK)
+        status = page_tree_begin_acquire(tree, &tree->tracker, &push, "put ptes: %d directories", *last + 1);
+
+    if (status != NV_OK)
+        return status;
+
+    while (*last >= 0) {
+        uvm_page_directory_t *parent = dirs[*last]->host_parent;
+        NvU32 run = pde_write_run_length(dirs, *last);
+        NvU32 run_push_size = 512 + run * tree->hal->entry_size(parent->depth);
+        NvU32 j;
+
+        // The CPU path uses the push only for the TLB invalidate
+        if (!uvm_mmu_use_cpu(tree) && push_size > 0 && push_size + run_push_size > max_push_size)
+            break;
+
+        push_size += run_push_size;
+
+        if (uvm_mmu_use_cpu(tree)) {
+            pde_fill(tree, parent, dirs[*last - run + 1]->index_in_parent, run, NULL, NULL);
+        }
+        else {
+            uvm_push_set_flag(&push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
+            uvm_push_set_flag(&push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
+            pde_fill(tree, parent, dirs[*last - run + 1]->index_in_parent, run, NULL, &push);
+        }
+
+        for (j = 0; j < run; j++) {
+            uvm_page_directory_t *dir = dirs[*last - j];
+            uvm_membar_t this_membar;
+
+            if (uvm_mmu_use_cpu(tree))
+                this_membar = UVM_MEMBAR_SYS;
+            else
+                this_membar = uvm_hal_downgrade_membar_type(tree->gpu, dir->phys_alloc.addr.aperture == UVM_APERTURE_VID);
+
+            membar_after_invalidate = max(membar_after_invalidate, this_membar);
+        }
+
+        if (parent->phys_alloc.addr.aperture == UVM_APERTURE_SYS)
+            membar_after_pde_clears = UVM_MEMBAR_SYS;
+
+        invalidate_depth = min(invalidate_depth, parent->depth);
+        *last -= run;
+    }
+
+    if (uvm_mmu_use_cpu(tree))
+        mb();
+    else
+        uvm_hal_wfi_membar(&push, membar_after_pde_clears);
+
+    tree->gpu->parent->host_hal->tlb_invalidate_all(&push,
+                                                    uvm_page_tree_pdb_address(tree),
+                                                    invalidate_depth,
+                                                    membar_after_invalidate);
+
+    if (!uvm_mmu_use_cpu(tree))
+        uvm_push_set_flag(&push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
+
+    page_tree_end(tree, &push);
+    page_tree_tracker_overwrite_with_push(tree, &push);
+
+    return NV_OK;
+}
+
+// Put the PTEs of all the ranges of the vector. Unlike calling
+// uvm_page_tree_put_ptes_async() for each range, which takes a push and a TLB
+// invalidate per range, the PDEs of all the directories freed by the whole
+// vector are cleared with as few pushes as possible, with adjacent clears
+// coalesced.
+static void range_vec_put_ptes_async(uvm_page_table_range_vec_t *range_vec)
 {
+    uvm_page_tree_t *tree = range_vec->tree;
+    NvU64 page_size = range_vec->page_size;
+    uvm_page_directory_t **dirs;
+    NvU32 free_count = 0;
+    NvS32 last;
     size_t i;
+
+    // Each range can free its page table and all the directories above it
+    dirs = uvm_kvmalloc(sizeof(*dirs) * range_vec->range_count * tree->hal->page_table_depth(page_size));
+    if (!dirs) {
+        for (i = 0; i < range_vec->range_count && range_vec->ranges[i].entry_count; ++i)
+            uvm_page_tree_put_ptes_async(tree, &range_vec->ranges[i]);
+
+        return;
+    }
+
+    uvm_mutex_lock(&tree->lock);
+
+    // Release the ranges and detach the directories that become unused from
+    // the host tree. Siblings end up adjacent in dirs, children before their
+    // parents.
+    for (i = 0; i < range_vec->range_count; ++i) {
+        uvm_page_table_range_t *range = &range_vec->ranges[i];
+        uvm_page_directory_t *dir = range->table;
+
+        if (!range->entry_count)
+            break;
+
+        UVM_ASSERT(dir->ref_count >= range->entry_count);
+        dir->ref_count -= range->entry_count;
+
+        while (dir->host_parent != NULL && dir->ref_count == 0) {
+            host_pde_clear(tree, dir->host_parent, dir->index_in_parent, page_size);
+            dirs[free_count++] = dir;
+            dir = dir->host_parent;
+        }
+    }
+
+    last = (NvS32)free_count - 1;
+    while (last >= 0) {
+        NV_STATUS status = range_vec_clear_pdes(tree, page_size, dirs, &last);
+
+        // Failure to wait for a tracker or get a push can only happen if we've
+        // hit a fatal UVM channel error. We can't perform the unmap, so just
+        // leave the directories allocated for debug.
+        if (status != NV_OK) {
+            UVM_ASSERT(status == uvm_global_get_status());
+            goto done;
+        }
+    }
+
+    // Now that all the PDE clears are tracked, free everything
+    for (i = 0; i < free_count; i++) {
+        phys_mem_deallocate(tree, &dirs[i]->phys_alloc);
+        uvm_kvfree(dirs[i]);
+    }
+
+done:
+    uvm_mutex_unlock(&tree->lock);
+
+    uvm_kvfree(dirs);
+}
+
+void uvm_page_table_range_vec_deinit(uvm_page_table_range_vec_t *range_vec)
+{
     if (!range_vec)
         return;
 
     if (range_vec->ranges) {
-        for (i = 0; i < range_vec->range_count; ++i) {
-            uvm_page_table_range_t *range = &range_vec->ranges[i];
-            if (!range->entry_count)
-                break;
-            uvm_page_tree_put_ptes_async(range_vec->tree, range);
-        }
+        range_vec_put_ptes_async(range_vec);
         (void)uvm_page_tree_wait(range_vec->tree);
 
         uvm_kvfree(range_vec->ranges);
@@ -507,7 +507,10 @@ static uvm_mmu_page_table_alloc_t *uvm_page_tree_pdb_internal(uvm_page_tree_t *t
 // [start, start + size)
 //
 // This splits the VA in the minimum amount of page table ranges required to
-// cover it and calls uvm_page_tree_get_ptes() for each of them.
+// cover it and gets the PTEs for each of them, like uvm_page_tree_get_ptes()
+// would. All the page directories missing for the whole VA range are allocated
+// up front and initialized with as few pushes as possible, and writes of
+// adjacent PDEs are coalesced.
 //
 // The pmm_flags are only used if PTEs are allocated from vidmem
 //
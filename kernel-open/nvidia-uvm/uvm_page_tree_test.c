@@ -115,6 +115,16 @@ typedef struct
     uvm_membar_t membar;
 } fake_tlb_invalidate_t;
 
+// Every push inserting new directories into the tree ends with a single
+// invalidate all, so this also counts those pushes. Unlike the TLB invalidate
+// tracking below, it is always enabled.
+static NvU32 g_fake_invalidate_all_count = 0;
+
+// Host methods generated by the fake TLB invalidates while the tracking is
+// enabled, assuming a single method per invalidate on GPUs supporting VA range
+// invalidates and a method per page otherwise.
+static NvU64 g_fake_tlb_methods_count = 0;
+
 static NvU32 g_fake_invals_count = 0;
 static fake_tlb_invalidate_t *g_fake_invals = NULL;
 static fake_tlb_invalidate_t *g_last_fake_inval;
@@ -143,6 +153,7 @@ static void fake_tlb_invals_reset(void)
     UVM_ASSERT(g_fake_tlb_invals_tracking_enabled);
 
     g_fake_invals_count = 0;
+    g_fake_tlb_methods_count = 0;
 }
 
 static void fake_tlb_invals_enable(void)
@@ -173,6 +184,11 @@ static void fake_tlb_invalidate_va(uvm_push_t *push,
     if (!g_fake_tlb_invals_tracking_enabled)
         return;
 
+    if (page_size == 0 || push->gpu->parent->tlb_batch.va_range_invalidate_supported)
+        ++g_fake_tlb_methods_count;
+    else
+        g_fake_tlb_methods_count += size / page_size;
+
     ++g_fake_invals_count;
 
     if (g_fake_invals_count == FAKE_TLB_INVALS_COUNT_MAX + 1) {
@@ -194,6 +210,7 @@ static void fake_tlb_invalidate_va(uvm_push_t *push,
 
 static void fake_tlb_invalidate_all(uvm_push_t *push, uvm_gpu_phys_address_t pdb, NvU32 depth, uvm_membar_t membar)
 {
+    ++g_fake_invalidate_all_count;
     fake_tlb_invalidate_va(push, pdb, depth, 0, -1, 0, membar);
 }
 
@@ -296,10 +313,33 @@ static bool assert_invalidate_range_specific(fake_tlb_invalidate_t *inval,
     return true;
 }
 
+// Whether any of the tracked targeted invalidates covers the whole range with
+// a page size and depth at least as fine as the range needs.
+static bool invalidate_range_is_covered(NvU64 base, NvU64 size, NvU64 page_size, NvU32 range_depth)
+{
+    NvU32 i;
+
+    for (i = 0; i < min(g_fake_invals_count, (NvU32)FAKE_TLB_INVALS_COUNT_MAX); ++i) {
+        fake_tlb_invalidate_t *inval = &g_fake_invals[i];
+
+        if (inval->page_size == 0)
+            continue;
+
+        if (inval->base <= base &&
+            inval->base + inval->size >= base + size &&
+            inval->page_size <= page_size &&
+            inval->depth <= range_depth)
+            return true;
+    }
+
+    return false;
+}
+
 static bool assert_invalidate_range(NvU64 base,
                                     NvU64 size,
                                     NvU64 page_size,
                                     bool allow_inval_all,
+                                    bool allow_coalesced,
                                     NvU32 range_depth,
                                     NvU32 all_depth,
                                     bool expected_membar)
@@ -323,6 +363,9 @@ static bool assert_invalidate_range(NvU64 base,
     if (g_fake_invals_count == 1 && allow_inval_all)
         return assert_last_invalidate_all(all_depth, expected_membar);
 
+    if (allow_coalesced && invalidate_range_is_covered(base, size, page_size, range_depth))
+        return true;
+
     UVM_TEST_PRINT("Couldn't find an invalidate for range [0x%llx, 0x%llx) in:\n", base, base + size);
     for (i = 0; i < g_fake_invals_count; ++i) {
         fake_tlb_invalidate_t *inval = &g_fake_invals[i];
@@ -1381,10 +1424,14 @@ static NV_STATUS test_tlb_batch_invalidates_case(uvm_page_tree_t *tree,
             bool allow_inval_all = (total_pages > gpu->parent->tlb_batch.max_pages) ||
                                    !gpu->parent->tlb_batch.va_invalidate_supported ||
                                    (i > UVM_TLB_BATCH_MAX_ENTRIES);
+
+            // Past UVM_TLB_BATCH_MAX_ENTRIES ranges get coalesced
+            bool allow_coalesced = i > UVM_TLB_BATCH_MAX_ENTRIES;
             TEST_CHECK_RET(assert_invalidate_range(base + (NvU64)j * 2 * size,
                                                    size,
                                                    min_page_size,
                                                    allow_inval_all,
+                                                   allow_coalesced,
                                                    expected_range_depth,
                                                    expected_inval_all_depth,
                                                    false));
@@ -1398,6 +1445,137 @@ static NV_STATUS test_tlb_batch_invalidates_case(uvm_page_tree_t *tree,
     return status;
 }
 
+// Synthetic unmap pattern: clusters of contiguous pages, with cluster_count
+// clusters of cluster_pages pages, the clusters starting cluster_stride apart.
+typedef struct
+{
+    const char *name;
+    NvU32 cluster_count;
+    NvU32 cluster_pages;
+    NvU64 cluster_stride;
+} tlb_batch_pattern_t;
+
+static NV_STATUS test_tlb_batch_pattern(uvm_page_tree_t *tree,
+                                        NvU64 page_size,
+                                        const tlb_batch_pattern_t *pattern,
+                                        uvm_tlb_batch_plan_t *plan_out,
+                                        NvU64 *methods_out)
+{
+    uvm_parent_gpu_t *parent_gpu = tree->gpu->parent;
+    uvm_push_t push;
+    uvm_tlb_batch_t batch;
+    uvm_tlb_batch_plan_t plan;
+    NvU32 page_table_depth = tree->hal->page_table_depth(page_size);
+    NvU32 total_ranges = pattern->cluster_count * pattern->cluster_pages;
+    NvU64 max_methods;
+    NvU32 i, j;
+
+    if (parent_gpu->tlb_batch.va_range_invalidate_supported)
+        max_methods = parent_gpu->tlb_batch.max_ranges;
+    else
+        max_methods = parent_gpu->tlb_batch.max_pages;
+
+    MEM_NV_CHECK_RET(uvm_push_begin_fake(tree->gpu, &push), NV_OK);
+
+    fake_tlb_invals_enable();
+
+    // Unmap one page at a time, as the page table walks of unmap paths do
+    uvm_tlb_batch_begin(tree, &batch);
+    for (i = 0; i < pattern->cluster_count; ++i) {
+        for (j = 0; j < pattern->cluster_pages; ++j)
+            uvm_tlb_batch_invalidate(&batch, i * pattern->cluster_stride + j * page_size, page_size, page_size, UVM_MEMBAR_NONE);
+    }
+
+    plan = batch.plan;
+    uvm_tlb_batch_end(&batch, &push, UVM_MEMBAR_NONE);
+
+    uvm_push_end_fake(&push);
+
+    if (!parent_gpu->tlb_batch.va_invalidate_supported)
+        TEST_CHECK_RET(plan == UVM_TLB_BATCH_PLAN_ALL);
+
+    if (plan == UVM_TLB_BATCH_PLAN_ALL) {
+        TEST_CHECK_RET(assert_last_invalidate_all(page_table_depth, false));
+        TEST_CHECK_RET(g_fake_tlb_methods_count == 1);
+    }
+    else {
+        TEST_CHECK_RET((plan == UVM_TLB_BATCH_PLAN_TARGETED) == (total_ranges <= UVM_TLB_BATCH_MAX_ENTRIES));
+        TEST_CHECK_RET(g_fake_invals_count <= UVM_TLB_BATCH_MAX_ENTRIES);
+
+        if (g_fake_tlb_methods_count > max_methods) {
+            UVM_TEST_PRINT("Pattern %s generated %llu methods, max %llu\n",
+                           pattern->name,
+                           g_fake_tlb_methods_count,
+                           max_methods);
+            return NV_ERR_INVALID_STATE;
+        }
+
+        for (i = 0; i < pattern->cluster_count; ++i) {
+            for (j = 0; j < pattern->cluster_pages; ++j) {
+                NvU64 base = i * pattern->cluster_stride + j * page_size;
+
+                if (!invalidate_range_is_covered(base, page_size, page_size, page_table_depth)) {
+                    UVM_TEST_PRINT("Pattern %s didn't invalidate [0x%llx, 0x%llx)\n",
+                                   pattern->name,
+                                   base,
+                                   base + page_size);
+                    return NV_ERR_INVALID_STATE;
+                }
+            }
+        }
+    }
+
+    *plan_out = plan;
+    *methods_out = g_fake_tlb_methods_count;
+
+    fake_tlb_invals_disable();
+
+    return NV_OK;
+}
+
+// Check the invalidates generated for synthetic unmap patterns of 64K pages.
+static NV_STATUS test_tlb_batch_patterns(uvm_page_tree_t *tree)
+{
+    uvm_parent_gpu_t *parent_gpu = tree->gpu->parent;
+    NvU64 page_size = UVM_PAGE_SIZE_64K;
+    NvU64 pde_coverage = uvm_mmu_pde_coverage(tree, page_size);
+    NvU32 i;
+
+    const tlb_batch_pattern_t patterns[] =
+    {
+        { "few scattered",        3,    1,   UVM_SIZE_1GB      },
+        { "contiguous",           1,    512, 0                 },
+        { "sparse in page table", 16,   1,   2 * page_size     },
+        { "clustered",            4,    64,  64 * UVM_SIZE_1GB },
+        { "scattered",            4096, 1,   pde_coverage      },
+    };
+
+    if (!uvm_mmu_page_size_supported(tree, page_size))
+        return NV_OK;
+
+    for (i = 0; i < ARRAY_SIZE(patterns); ++i) {
+        uvm_tlb_batch_plan_t plan;
+        NvU64 methods;
+
+        TEST_NV_CHECK_RET(test_tlb_batch_pattern(tree, page_size, &patterns[i], &plan, &methods));
+
+        if (!parent_gpu->tlb_batch.va_range_invalidate_supported || !parent_gpu->tlb_batch.va_invalidate_supported)
+            continue;
+
+        // With range invalidates, contiguous and clustered unmaps are coalesced
+        // into a few targeted invalidates while unmaps scattered across many
+        // page tables fall back to invalidate all.
+        if (i == 0)
+            TEST_CHECK_RET(plan == UVM_TLB_BATCH_PLAN_TARGETED && methods == patterns[i].cluster_count);
+        else if (i == ARRAY_SIZE(patterns) - 1)
+            TEST_CHECK_RET(plan == UVM_TLB_BATCH_PLAN_ALL);
+        else
+            TEST_CHECK_RET(plan == UVM_TLB_BATCH_PLAN_PER_PDE && methods <= patterns[i].cluster_count);
+    }
+
+    return NV_OK;
+}
+
 static NV_STATUS test_tlb_batch_invalidates(uvm_gpu_t *gpu, const NvU64 *page_sizes, const NvU32 page_sizes_count)
 {
     NV_STATUS status = NV_OK;
@@ -1411,6 +1589,8 @@ static NV_STATUS test_tlb_batch_invalidates(uvm_gpu_t *gpu, const NvU64 *page_si
 
     MEM_NV_CHECK_RET(test_page_tree_init(gpu, BIG_PAGE_SIZE_PASCAL, &tree), NV_OK);
 
+    TEST_NV_CHECK_GOTO(test_tlb_batch_patterns(&tree), done);
+
     for (min_index = 0; min_index < page_sizes_count; ++min_index) {
         for (max_index = min_index; max_index < page_sizes_count; ++max_index) {
             for (size_index = 0; size_index < ARRAY_SIZE(sizes_in_max_pages); ++size_index) {
@@ -1682,6 +1862,165 @@ static NV_STATUS test_range_vec(uvm_gpu_t *gpu, NvU32 big_page_size, NvU64 page_
     return status;
 }
 
+// Check that the PDE pointing to each of the directories above range's table
+// matches what the host tree says it should be.
+static bool assert_range_pdes(uvm_page_tree_t *tree, uvm_page_table_range_t *range)
+{
+    uvm_page_directory_t *dir;
+
+    for (dir = range->table; dir->host_parent; dir = dir->host_parent) {
+        uvm_page_directory_t *parent = dir->host_parent;
+        NvU32 entries_per_index = tree->hal->entries_per_index(parent->depth);
+        NvU32 entry_size = tree->hal->entry_size(parent->depth);
+        uvm_mmu_page_table_alloc_t *phys_allocs[2];
+        NvU64 expected[2];
+        NvU32 i;
+        void *pde = phys_to_virt(parent->phys_alloc.addr.address + dir->index_in_parent * entry_size);
+
+        for (i = 0; i < entries_per_index; i++) {
+            uvm_page_directory_t *entry = parent->entries[entries_per_index * dir->index_in_parent + i];
+            phys_allocs[i] = entry ? &entry->phys_alloc : NULL;
+        }
+
+        tree->hal->make_pde(expected, phys_allocs, parent, dir->index_in_parent);
+
+        if (memcmp(pde, expected, entry_size) != 0) {
+            UVM_TEST_PRINT("PDE %u at depth %u is 0x%llx instead of 0x%llx\n",
+                           dir->index_in_parent,
+                           parent->depth,
+                           *(NvU64 *)pde,
+                           expected[0]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Time spent by test_range_vec_bulk() on the per-table and the bulk paths,
+// summed over every configuration and reported by uvm_test_page_tree(). The
+// fake GPUs write the page tables from the CPU, so these are only a relative
+// measure of the CPU-side work of both paths. They are reported rather than
+// compared, since wall-clock time is unreliable under load and in VMs.
+static NvU64 g_range_vec_single_get_ns;
+static NvU64 g_range_vec_single_put_ns;
+static NvU64 g_range_vec_bulk_get_ns;
+static NvU64 g_range_vec_bulk_put_ns;
+
+// Compare getting the PTEs of a VA range spanning many page tables one page
+// table at a time with the bulk path of range vectors, which allocates and
+// initializes all the missing directories up front.
+static NV_STATUS test_range_vec_bulk(uvm_gpu_t *gpu, NvU32 big_page_size, NvU64 page_size)
+{
+    NV_STATUS status = NV_OK;
+    uvm_page_tree_t tree;
+    uvm_page_table_range_vec_t range_vec;
+    uvm_page_table_range_t *ranges = NULL;
+    bool range_vec_initialized = false;
+    NvU64 pde_coverage;
+    NvU64 start;
+    NvU64 size;
+    NvU32 single_pushes;
+    NvU32 bulk_pushes;
+    NvU64 start_time;
+    size_t ranges_held = 0;
+    size_t i;
+    const size_t range_count = 64;
+
+    MEM_NV_CHECK_RET(test_page_tree_init_kernel(gpu, big_page_size, &tree), NV_OK);
+
+    pde_coverage = uvm_mmu_pde_coverage(&tree, page_size);
+    start = pde_coverage * range_count;
+    size = pde_coverage * range_count;
+
+    // The biggest page sizes cover too much VA for this test
+    if (!uvm_gpu_can_address_kernel(gpu, start, size))
+        goto cleanup;
+
+    ranges = uvm_kvmalloc_zero(sizeof(*ranges) * range_count);
+    if (!ranges) {
+        status = NV_ERR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    g_fake_invalidate_all_count = 0;
+    start_time = NV_GETTIME();
+    for (ranges_held = 0; ranges_held < range_count; ranges_held++) {
+        TEST_NV_CHECK_GOTO(test_page_tree_get_ptes(&tree,
+                                                   page_size,
+                                                   start + ranges_held * pde_coverage,
+                                                   pde_coverage,
+                                                   &ranges[ranges_held]),
+                           cleanup);
+    }
+    g_range_vec_single_get_ns += NV_GETTIME() - start_time;
+    single_pushes = g_fake_invalidate_all_count;
+
+    for (i = 0; i < range_count; i++)
+        TEST_CHECK_GOTO(assert_range_pdes(&tree, &ranges[i]), cleanup);
+
+    start_time = NV_GETTIME();
+    for (; ranges_held > 0; ranges_held--)
+        uvm_page_tree_put_ptes(&tree, &ranges[ranges_held - 1]);
+    g_range_vec_single_put_ns += NV_GETTIME() - start_time;
+
+    g_fake_invalidate_all_count = 0;
+    start_time = NV_GETTIME();
+    TEST_NV_CHECK_GOTO(uvm_page_table_range_vec_init(&tree,
+                                                     start,
+                                                     size,
+                                                     page_size,
+                                                     UVM_PMM_ALLOC_FLAGS_EVICT,
+                                                     &range_vec),
+                       cleanup);
+    g_range_vec_bulk_get_ns += NV_GETTIME() - start_time;
+    range_vec_initialized = true;
+    bulk_pushes = g_fake_invalidate_all_count;
+
+    TEST_CHECK_GOTO(range_vec.range_count == range_count, cleanup);
+    for (i = 0; i < range_count; i++) {
+        TEST_CHECK_GOTO(range_vec.ranges[i].entry_count == pde_coverage / page_size, cleanup);
+        TEST_CHECK_GOTO(assert_range_pdes(&tree, &range_vec.ranges[i]), cleanup);
+    }
+
+    TEST_NV_CHECK_GOTO(test_range_vec_write_ptes(&range_vec, UVM_MEMBAR_NONE), cleanup);
+    TEST_NV_CHECK_GOTO(test_range_vec_clear_ptes(&range_vec, UVM_MEMBAR_SYS), cleanup);
+
+    // Every page table was missing, so each of the single gets needed its own
+    // push. The bulk path packs many directories per push.
+    TEST_CHECK_GOTO(single_pushes == range_count, cleanup);
+    if (bulk_pushes * 8 > single_pushes) {
+        UVM_TEST_PRINT("Bulk get took %u pushes, single gets took %u\n", bulk_pushes, single_pushes);
+        status = NV_ERR_INVALID_STATE;
+        goto cleanup;
+    }
+
+    // Putting the whole vector frees every directory again, also with far
+    // fewer pushes than one per page table.
+    g_fake_invalidate_all_count = 0;
+    start_time = NV_GETTIME();
+    uvm_page_table_range_vec_deinit(&range_vec);
+    g_range_vec_bulk_put_ns += NV_GETTIME() - start_time;
+    range_vec_initialized = false;
+    if (g_fake_invalidate_all_count * 8 > single_pushes) {
+        UVM_TEST_PRINT("Bulk put took %u pushes\n", g_fake_invalidate_all_count);
+        status = NV_ERR_INVALID_STATE;
+        goto cleanup;
+    }
+
+cleanup:
+    if (range_vec_initialized)
+        uvm_page_table_range_vec_deinit(&range_vec);
+
+    for (; ranges_held > 0; ranges_held--)
+        uvm_page_tree_put_ptes(&tree, &ranges[ranges_held - 1]);
+
+    uvm_kvfree(ranges);
+    uvm_page_tree_deinit(&tree);
+
+    return status;
+}
+
 static NV_STATUS alloc_64k_memory_maxwell(uvm_gpu_t *gpu)
 {
     uvm_page_tree_t tree;
@@ -2650,6 +2989,7 @@ static NV_STATUS maxwell_test_page_tree(uvm_gpu_t *maxwell)
             MEM_NV_CHECK_RET(shrink_test(maxwell, big_page_size, page_size), NV_OK);
             MEM_NV_CHECK_RET(get_upper_test(maxwell, big_page_size, page_size), NV_OK);
             MEM_NV_CHECK_RET(test_range_vec(maxwell, big_page_size, page_size), NV_OK);
+            MEM_NV_CHECK_RET(test_range_vec_bulk(maxwell, big_page_size, page_size), NV_OK);
         }
     }
 
@@ -2705,6 +3045,7 @@ static NV_STATUS pascal_test_page_tree(uvm_gpu_t *pascal)
         MEM_NV_CHECK_RET(shrink_test(pascal, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
         MEM_NV_CHECK_RET(get_upper_test(pascal, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
         MEM_NV_CHECK_RET(test_range_vec(pascal, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
+        MEM_NV_CHECK_RET(test_range_vec_bulk(pascal, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
     }
 
     return NV_OK;
@@ -2772,6 +3113,7 @@ static NV_STATUS ampere_test_page_tree(uvm_gpu_t *ampere)
         MEM_NV_CHECK_RET(shrink_test(ampere, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
         MEM_NV_CHECK_RET(get_upper_test(ampere, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
         MEM_NV_CHECK_RET(test_range_vec(ampere, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
+        MEM_NV_CHECK_RET(test_range_vec_bulk(ampere, BIG_PAGE_SIZE_PASCAL, page_sizes[i]), NV_OK);
     }
 
     return NV_OK;
@@ -2846,6 +3188,7 @@ static NV_STATUS blackwell_test_page_tree(uvm_gpu_t *blackwell)
             MEM_NV_CHECK_RET(shrink_test(blackwell, BIG_PAGE_SIZE_PASCAL, page_sizes[j]), NV_OK);
             MEM_NV_CHECK_RET(get_upper_test(blackwell, BIG_PAGE_SIZE_PASCAL, page_sizes[j]), NV_OK);
             MEM_NV_CHECK_RET(test_range_vec(blackwell, BIG_PAGE_SIZE_PASCAL, page_sizes[j]), NV_OK);
+            MEM_NV_CHECK_RET(test_range_vec_bulk(blackwell, BIG_PAGE_SIZE_PASCAL, page_sizes[j]), NV_OK);
         }
     }
 
@@ -2881,6 +3224,11 @@ NV_STATUS uvm_test_page_tree(UVM_TEST_PAGE_TREE_PARAMS *params, struct file *fil
     // calls.
     TEST_NV_CHECK_GOTO(fake_tlb_invals_alloc(), done);
 
+    g_range_vec_single_get_ns = 0;
+    g_range_vec_single_put_ns = 0;
+    g_range_vec_bulk_get_ns = 0;
+    g_range_vec_bulk_put_ns = 0;
+
     // We prevent the maxwell_test_page_tree test from running on ATS-enabled
     // systems. On "fake" Maxwell-based ATS systems pde_fill() may push more
     // methods than what we support in UVM. Specifically, on
@@ -2898,6 +3246,11 @@ NV_STATUS uvm_test_page_tree(UVM_TEST_PAGE_TREE_PARAMS *params, struct file *fil
 done:
     fake_tlb_invals_free();
 
+    params->range_vec_single_get_ns = g_range_vec_single_get_ns;
+    params->range_vec_single_put_ns = g_range_vec_single_put_ns;
+    params->range_vec_bulk_get_ns = g_range_vec_bulk_get_ns;
+    params->range_vec_bulk_put_ns = g_range_vec_bulk_put_ns;
+
     uvm_mutex_unlock(&g_uvm_global.global_lock);
 
     uvm_kvfree(gpu);
@@ -24,26 +24,113 @@
 #include "uvm_range_allocator.h"
 #include "uvm_kvmalloc.h"
 
+static uvm_range_allocator_node_t *get_allocator_node(uvm_range_tree_node_t *node)
+{
+    return container_of(node, uvm_range_allocator_node_t, node);
+}
+
+static uvm_range_allocator_node_t *get_size_node(struct rb_node *rb_node)
+{
+    return rb_entry(rb_node, uvm_range_allocator_node_t, size_node);
+}
+
+// Order of the free ranges in the size tree: by size, then by start address
+static bool free_range_less(uvm_range_tree_node_t *a, uvm_range_tree_node_t *b)
+{
+    NvU64 a_size = uvm_range_tree_node_size(a);
+    NvU64 b_size = uvm_range_tree_node_size(b);
+
+    return a_size < b_size || (a_size == b_size && a->start < b->start);
+}
+
+static void free_range_add(uvm_range_allocator_t *range_allocator, uvm_range_tree_node_t *node)
+{
+    struct rb_node **link = &range_allocator->size_tree.rb_node;
+    struct rb_node *parent = NULL;
+
+    // Free ranges never cover the whole 64-bit space, see
+    // uvm_range_allocator_init().
+    UVM_ASSERT(uvm_range_tree_node_size(node) > 0);
+
+    while (*link) {
+        parent = *link;
+
+        if (free_range_less(node, &get_size_node(parent)->node))
+            link = &parent->rb_left;
+        else
+            link = &parent->rb_right;
+    }
+
+    rb_link_node(&get_allocator_node(node)->size_node, parent, link);
+    rb_insert_color(&get_allocator_node(node)->size_node, &range_allocator->size_tree);
+
+    range_allocator->free_size += uvm_range_tree_node_size(node);
+    range_allocator->free_ranges++;
+}
+
+static void free_range_remove(uvm_range_allocator_t *range_allocator, uvm_range_tree_node_t *node)
+{
+    rb_erase(&get_allocator_node(node)->size_node, &range_allocator->size_tree);
+
+    range_allocator->free_size -= uvm_range_tree_node_size(node);
+    range_allocator->free_ranges--;
+}
+
+static uvm_range_tree_node_t *free_range_next_by_size(uvm_range_tree_node_t *node)
+{
+    struct rb_node *rb_node = rb_next(&get_allocator_node(node)->size_node);
+
+    return rb_node ? &get_size_node(rb_node)->node : NULL;
+}
+
+// Find the smallest free range of at least size bytes, the lowest one among
+// those of the same size.
+static uvm_range_tree_node_t *free_range_lower_bound(uvm_range_allocator_t *range_allocator, NvU64 size)
+{
+    struct rb_node *rb_node = range_allocator->size_tree.rb_node;
+    uvm_range_tree_node_t *found = NULL;
+
+    while (rb_node) {
+        uvm_range_tree_node_t *node = &get_size_node(rb_node)->node;
+
+        if (uvm_range_tree_node_size(node) >= size) {
+            found = node;
+            rb_node = rb_node->rb_left;
+        }
+        else {
+            rb_node = rb_node->rb_right;
+        }
+    }
+
+    return found;
+}
+
 NV_STATUS uvm_range_allocator_init(NvU64 size, uvm_range_allocator_t *range_allocator)
 {
     NV_STATUS status;
-    uvm_range_tree_node_t *node;
+    uvm_range_allocator_node_t *node;
 
     uvm_spin_lock_init(&range_allocator->lock, UVM_LOCK_ORDER_LEAF);
     uvm_range_tree_init(&range_allocator->range_tree);
 
+    range_allocator->size_tree = RB_ROOT;
+    range_allocator->free_size = 0;
+    range_allocator->free_ranges = 0;
+
     UVM_ASSERT(size > 0);
 
     node = uvm_kvmalloc(sizeof(*node));
     if (!node)
         return NV_ERR_NO_MEMORY;
 
-    node->start = 0;
-    node->end = size - 1;
+    node->node.start = 0;
+    node->node.end = size - 1;
 
-    status = uvm_range_tree_add(&range_allocator->range_tree, node);
+    status = uvm_range_tree_add(&range_allocator->range_tree, &node->node);
     UVM_ASSERT(status == NV_OK);
 
+    free_range_add(range_allocator, &node->node);
+
     range_allocator->size = size;
 
     return NV_OK;
@@ -59,15 +146,75 @@ void uvm_range_allocator_deinit(uvm_range_allocator_t *range_allocator)
 
     // Remove the node for completeness even though after deinit the state of
     // tree doesn't matter anyway.
+    free_range_remove(range_allocator, node);
     uvm_range_tree_remove(&range_allocator->range_tree, node);
 
-    uvm_kvfree(node);
+    uvm_kvfree(get_allocator_node(node));
+}
+
+// Check whether an aligned range of size fits in the free range, returning its
+// start in aligned_start if so.
+static bool free_range_fits(uvm_range_tree_node_t *node, NvU64 size, NvU64 alignment, NvU64 *aligned_start)
+{
+    NvU64 start = UVM_ALIGN_UP(node->start, alignment);
+    NvU64 end = start + size - 1;
+
+    // Check for overflow of start and end
+    if (start < node->start || end < start)
+        return false;
+
+    // Check whether it fits
+    if (end > node->end)
+        return false;
+
+    *aligned_start = start;
+    return true;
+}
+
+// Number of free ranges big enough for size but too small once aligned that are
+// skipped while looking for the best fit, before moving on to the free ranges
+// big enough to fit regardless of the alignment.
+#define BEST_FIT_MAX_MISFITS 16
+
+static uvm_range_tree_node_t *free_range_find_best_fit(uvm_range_allocator_t *range_allocator,
+                                                       NvU64 size,
+                                                       NvU64 alignment,
+                                                       NvU64 *aligned_start)
+{
+    uvm_range_tree_node_t *node;
+    NvU64 fit_size;
+    NvU32 misfits = 0;
+
+    for (node = free_range_lower_bound(range_allocator, size); node; node = free_range_next_by_size(node)) {
+        if (free_range_fits(node, size, alignment, aligned_start))
+            return node;
+
+        if (++misfits == BEST_FIT_MAX_MISFITS)
+            break;
+    }
+
+    if (!node)
+        return NULL;
+
+    // Any free range of at least size + alignment - 1 bytes fits. All the
+    // misfits so far are smaller than that, so none of them is visited again.
+    fit_size = size + alignment - 1;
+    if (fit_size < size)
+        return NULL;
+
+    node = free_range_lower_bound(range_allocator, fit_size);
+    if (node && free_range_fits(node, size, alignment, aligned_start))
+        return node;
+
+    return NULL;
 }
 
 NV_STATUS uvm_range_allocator_alloc(uvm_range_allocator_t *range_allocator, NvU64 size, NvU64 alignment, uvm_range_allocation_t *range_alloc)
 {
+    uvm_range_allocator_node_t *alloc_node;
     uvm_range_tree_node_t *node;
-    bool found = false;
+    NvU64 aligned_start = 0;
+    NvU64 aligned_end;
 
     UVM_ASSERT(size > 0);
 
@@ -81,58 +228,46 @@ NV_STATUS uvm_range_allocator_alloc(uvm_range_allocator_t *range_allocator, NvU6
 
     // Pre-allocate a tree node as part of the allocation so that freeing the
     // range won't require allocating memory and will always succeed.
-    range_alloc->node = uvm_kvmalloc(sizeof(*range_alloc->node));
-    if (!range_alloc->node)
+    alloc_node = uvm_kvmalloc(sizeof(*alloc_node));
+    if (!alloc_node)
         return NV_ERR_NO_MEMORY;
 
     uvm_spin_lock(&range_allocator->lock);
 
-    // This is a very simple brute force going over all the free ranges in
-    // address order and returning the first one that's big enough.
-    // This could be improved by e.g. also maintaining a binary tree of free
-    // ranges ordered by their size.
-    uvm_range_tree_for_each_in(node, &range_allocator->range_tree, 0, range_allocator->size - size) {
-        NvU64 aligned_start = UVM_ALIGN_UP(node->start, alignment);
-        NvU64 aligned_end = aligned_start + size - 1;
-
-        // Check for overflow of aligned_start and aligned_end
-        if (aligned_start < node->start || aligned_end < aligned_start)
-            continue;
-
-        // Check whether it fits
-        if (aligned_end > node->end)
-            continue;
-
-        // The allocation always wastes the [node->start, aligned_start) space,
-        // but it's expected that there will always be plenty of free space to
-        // allocate from and wasting that space should help avoid fragmentation.
-
-        range_alloc->aligned_start = aligned_start;
-        range_alloc->node->start = node->start;
-        range_alloc->node->end = aligned_end;
-
-        if (aligned_end < node->end) {
-            // Shrink the node if the claimed size is smaller than the node.
-            uvm_range_tree_shrink_node(&range_allocator->range_tree, node, aligned_end + 1, node->end);
-        }
-        else {
-            // Otherwise just remove it. The removal is safe to do in the loop
-            // over nodes as a break is following immediately.
-            UVM_ASSERT(node->end == aligned_end);
-            uvm_range_tree_remove(&range_allocator->range_tree, node);
-            uvm_kvfree(node);
-        }
-        found = true;
-        break;
+    node = free_range_find_best_fit(range_allocator, size, alignment, &aligned_start);
+    if (!node) {
+        uvm_spin_unlock(&range_allocator->lock);
+        uvm_kvfree(alloc_node);
+        range_alloc->node = NULL;
+        return NV_ERR_UVM_ADDRESS_IN_USE;
     }
 
-    uvm_spin_unlock(&range_allocator->lock);
+    aligned_end = aligned_start + size - 1;
 
-    if (!found) {
-        uvm_kvfree(range_alloc->node);
-        range_alloc->node = NULL;
-        return NV_ERR_UVM_ADDRESS_IN_USE;
+    // The allocation always wastes the [node->start, aligned_start) space,
+    // but it's expected that there will always be plenty of free space to
+    // allocate from and wasting that space should help avoid fragmentation.
+
+    range_alloc->aligned_start = aligned_start;
+    range_alloc->node = &alloc_node->node;
+    range_alloc->node->start = node->start;
+    range_alloc->node->end = aligned_end;
+
+    free_range_remove(range_allocator, node);
+
+    if (aligned_end < node->end) {
+        // Shrink the node if the claimed size is smaller than the node.
+        uvm_range_tree_shrink_node(&range_allocator->range_tree, node, aligned_end + 1, node->end);
+        free_range_add(range_allocator, node);
     }
+    else {
+        // Otherwise just remove it
+        UVM_ASSERT(node->end == aligned_end);
+        uvm_range_tree_remove(&range_allocator->range_tree, node);
+        uvm_kvfree(get_allocator_node(node));
+    }
+
+    uvm_spin_unlock(&range_allocator->lock);
 
     return NV_OK;
 }
@@ -155,14 +290,36 @@ void uvm_range_allocator_free(uvm_range_allocator_t *range_allocator, uvm_range_
 
     // And try merging it with adjacent nodes
     adjacent_node = uvm_range_tree_merge_prev(&range_allocator->range_tree, range_alloc->node);
-    if (adjacent_node)
-        uvm_kvfree(adjacent_node);
+    if (adjacent_node) {
+        free_range_remove(range_allocator, adjacent_node);
+        uvm_kvfree(get_allocator_node(adjacent_node));
+    }
 
     adjacent_node = uvm_range_tree_merge_next(&range_allocator->range_tree, range_alloc->node);
-    if (adjacent_node)
-        uvm_kvfree(adjacent_node);
+    if (adjacent_node) {
+        free_range_remove(range_allocator, adjacent_node);
+        uvm_kvfree(get_allocator_node(adjacent_node));
+    }
+
+    free_range_add(range_allocator, range_alloc->node);
 
     uvm_spin_unlock(&range_allocator->lock);
 
     range_alloc->node = NULL;
 }
+
+void uvm_range_allocator_get_stats(uvm_range_allocator_t *range_allocator, uvm_range_allocator_stats_t *stats)
+{
+    struct rb_node *largest;
+
+    uvm_spin_lock(&range_allocator->lock);
+
+    stats->free_size = range_allocator->free_size;
+    stats->free_ranges = range_allocator->free_ranges;
+
+    // The largest free range is the last one in the size tree
+    largest = rb_last(&range_allocator->size_tree);
+    stats->largest_free_range = largest ? uvm_range_tree_node_size(&get_size_node(largest)->node) : 0;
+
+    uvm_spin_unlock(&range_allocator->lock);
+}
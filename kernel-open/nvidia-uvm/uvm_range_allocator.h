@@ -27,6 +27,24 @@
 #include "uvm_range_tree.h"
 #include "uvm_lock.h"
 
+typedef struct {
+    uvm_range_tree_node_t node;
+
+    // Entry of the free range in the size tree
+    struct rb_node size_node;
+} uvm_range_allocator_node_t;
+
+typedef struct {
+    // Total size of the free ranges
+    NvU64 free_size;
+
+    // Number of free ranges
+    NvU64 free_ranges;
+
+    // Size of the largest free range
+    NvU64 largest_free_range;
+} uvm_range_allocator_stats_t;
+
 typedef struct {
     // Lock protecting the state of the range allocator
     uvm_spinlock_t lock;
@@ -36,6 +54,13 @@ typedef struct {
 
     // Range tree tracking all the free ranges
     uvm_range_tree_t range_tree;
+
+    // Tree of the uvm_range_allocator_node_t's of the free ranges, ordered by
+    // size and then by start address.
+    struct rb_root size_tree;
+
+    NvU64 free_size;
+    NvU64 free_ranges;
 } uvm_range_allocator_t;
 
 // A free range allocation
@@ -45,7 +70,8 @@ typedef struct {
 
     // A tree node allocated at the time of range allocation and used by the
     // range allocator when the range allocation is freed. This allows to
-    // guarantee that uvm_range_allocator_free() always succeeds.
+    // guarantee that uvm_range_allocator_free() always succeeds. It is embedded
+    // in a uvm_range_allocator_node_t.
     uvm_range_tree_node_t *node;
 } uvm_range_allocation_t;
 
@@ -59,6 +85,12 @@ void uvm_range_allocator_deinit(uvm_range_allocator_t *range_allocator);
 
 // Alloc a free range of the given size and alignment
 //
+// The range is carved out of the smallest free range it fits in once aligned,
+// ties going to the lowest address. If many of the free ranges big enough for
+// size don't fit once aligned, the smallest free range that fits regardless of
+// the alignment is used instead, which keeps the lookup logarithmic in the
+// number of free ranges.
+//
 // Size needs to be greater or equal to 1.
 // Alignment needs to be a power of 2 or 0. Alignment of 0 is converted into
 // alignment of 1.
@@ -70,4 +102,7 @@ NV_STATUS uvm_range_allocator_alloc(uvm_range_allocator_t *range_allocator, NvU6
 // Free a previously allocated range
 void uvm_range_allocator_free(uvm_range_allocator_t *range_allocator, uvm_range_allocation_t *range_alloc);
 
+// Get a snapshot of the fragmentation of the free space
+void uvm_range_allocator_get_stats(uvm_range_allocator_t *range_allocator, uvm_range_allocator_stats_t *stats);
+
 #endif // __UVM_RANGE_ALLOCATOR_H__
@@ -78,6 +78,31 @@ static NvU64 test_free_range(uvm_range_allocator_t *range_allocator, uvm_range_a
     return size;
 }
 
+// Verify the allocator statistics against the free ranges in the tree
+static NV_STATUS test_check_stats(uvm_range_allocator_t *range_allocator, NvU64 expected_free_size)
+{
+    uvm_range_allocator_stats_t stats;
+    uvm_range_tree_node_t *node;
+    NvU64 free_size = 0;
+    NvU64 free_ranges = 0;
+    NvU64 largest_free_range = 0;
+
+    uvm_range_allocator_get_stats(range_allocator, &stats);
+
+    uvm_range_tree_for_each(node, &range_allocator->range_tree) {
+        free_size += uvm_range_tree_node_size(node);
+        free_ranges++;
+        largest_free_range = max(largest_free_range, uvm_range_tree_node_size(node));
+    }
+
+    TEST_CHECK_RET(stats.free_size == expected_free_size);
+    TEST_CHECK_RET(stats.free_size == free_size);
+    TEST_CHECK_RET(stats.free_ranges == free_ranges);
+    TEST_CHECK_RET(stats.largest_free_range == largest_free_range);
+
+    return NV_OK;
+}
+
 #define BASIC_TEST_SIZE UVM_SIZE_1GB
 #define BASIC_TEST_MAX_ALLOCS (128)
 
@@ -193,6 +218,63 @@ static NV_STATUS basic_test(void)
     return NV_OK;
 }
 
+#define BEST_FIT_TEST_SIZE 1000
+
+// Check that allocations go to the smallest free range that fits, rather than
+// the lowest one.
+static NV_STATUS best_fit_test(void)
+{
+    uvm_range_allocator_t range_allocator;
+    uvm_range_allocation_t range_allocs[6];
+    uvm_range_allocation_t best_fit_allocs[4];
+    static const NvU64 sizes[] = { 100, 10, 300, 10, 50, 10 };
+    NvU32 i;
+
+    TEST_NV_CHECK_RET(uvm_range_allocator_init(BEST_FIT_TEST_SIZE, &range_allocator));
+
+    // [0-99][100-109][110-409][410-419][420-469][470-479] [480-999]
+    for (i = 0; i < ARRAY_SIZE(sizes); ++i)
+        TEST_CHECK_RET(test_alloc_range(&range_allocator, sizes[i], 1, &range_allocs[i]) == NV_OK);
+
+    TEST_CHECK_RET(range_allocs[5].aligned_start == 470);
+
+    // Free ranges: [0-99] [110-409] [420-469] [480-999]
+    test_free_range(&range_allocator, &range_allocs[0]);
+    test_free_range(&range_allocator, &range_allocs[2]);
+    test_free_range(&range_allocator, &range_allocs[4]);
+    TEST_CHECK_RET(test_check_stats(&range_allocator, 100 + 300 + 50 + 520) == NV_OK);
+
+    TEST_CHECK_RET(test_alloc_range(&range_allocator, 40, 1, &best_fit_allocs[0]) == NV_OK);
+    TEST_CHECK_RET(best_fit_allocs[0].aligned_start == 420);
+
+    TEST_CHECK_RET(test_alloc_range(&range_allocator, 90, 1, &best_fit_allocs[1]) == NV_OK);
+    TEST_CHECK_RET(best_fit_allocs[1].aligned_start == 0);
+
+    TEST_CHECK_RET(test_alloc_range(&range_allocator, 200, 1, &best_fit_allocs[2]) == NV_OK);
+    TEST_CHECK_RET(best_fit_allocs[2].aligned_start == 110);
+
+    // [310-409] is the smallest free range left that's big enough, but not
+    // once aligned.
+    TEST_CHECK_RET(test_alloc_range(&range_allocator, 100, 64, &best_fit_allocs[3]) == NV_OK);
+    TEST_CHECK_RET(best_fit_allocs[3].aligned_start == 512);
+
+    TEST_CHECK_RET(test_check_stats(&range_allocator, 10 + 10 + 100 + 520 - (512 - 480) - 100) == NV_OK);
+
+    for (i = 0; i < ARRAY_SIZE(best_fit_allocs); ++i)
+        test_free_range(&range_allocator, &best_fit_allocs[i]);
+
+    test_free_range(&range_allocator, &range_allocs[1]);
+    test_free_range(&range_allocator, &range_allocs[3]);
+    test_free_range(&range_allocator, &range_allocs[5]);
+
+    TEST_CHECK_RET(test_check_range_allocator_empty(&range_allocator) == NV_OK);
+    TEST_CHECK_RET(test_check_stats(&range_allocator, BEST_FIT_TEST_SIZE) == NV_OK);
+
+    uvm_range_allocator_deinit(&range_allocator);
+
+    return NV_OK;
+}
+
 #define RANDOM_TEST_SIZE 1024
 
 typedef struct
@@ -327,6 +409,8 @@ static NV_STATUS random_test(NvU32 iters, NvU32 seed, bool verbose)
             // Random alloc is expected to fail some times.
             TEST_CHECK_RET(status == NV_OK || status == NV_ERR_UVM_ADDRESS_IN_USE);
         }
+
+        TEST_CHECK_RET(test_check_stats(&state.range_allocator, state.free_size) == NV_OK);
     }
 
     while (state.allocated_ranges > 0)
@@ -342,10 +426,100 @@ static NV_STATUS random_test(NvU32 iters, NvU32 seed, bool verbose)
     return NV_OK;
 }
 
+#define STRESS_TEST_SIZE       (UVM_SIZE_1GB * 4)
+#define STRESS_TEST_MAX_ALLOCS (4 * 1024)
+#define STRESS_TEST_ITERS      (64 * 1024)
+
+// Churn through allocations of mixed sizes and alignments, as done by the
+// sub-allocations of the UVM internal VA, and report the allocation cost and
+// the resulting fragmentation.
+static NV_STATUS stress_test(NvU32 seed, bool verbose)
+{
+    uvm_range_allocator_t range_allocator;
+    uvm_range_allocator_stats_t stats;
+    uvm_range_allocation_t *range_allocs;
+    uvm_test_rng_t rng;
+    NvU64 free_size = STRESS_TEST_SIZE;
+    NvU64 failed_allocs = 0;
+    NvU64 alloc_ns = 0;
+    size_t allocated_ranges = 0;
+    NvU32 i;
+
+    uvm_test_rng_init(&rng, seed);
+
+    range_allocs = uvm_kvmalloc(sizeof(*range_allocs) * STRESS_TEST_MAX_ALLOCS);
+    if (!range_allocs)
+        return NV_ERR_NO_MEMORY;
+
+    TEST_NV_CHECK_RET(uvm_range_allocator_init(STRESS_TEST_SIZE, &range_allocator));
+
+    for (i = 0; i < STRESS_TEST_ITERS; ++i) {
+        bool do_alloc = allocated_ranges == 0 ||
+                        (allocated_ranges < STRESS_TEST_MAX_ALLOCS && uvm_test_rng_range_32(&rng, 0, 1));
+
+        if (do_alloc) {
+            NvU64 size = uvm_test_rng_range_log64(&rng, UVM_PAGE_SIZE_4K, UVM_SIZE_1MB);
+            NvU64 alignment = 1ULL << uvm_test_rng_range_32(&rng, 12, 16);
+            NvU64 start_ns;
+            NV_STATUS status;
+
+            start_ns = NV_GETTIME();
+            status = test_alloc_range(&range_allocator, size, alignment, &range_allocs[allocated_ranges]);
+            alloc_ns += NV_GETTIME() - start_ns;
+
+            if (status == NV_ERR_UVM_ADDRESS_IN_USE) {
+                failed_allocs++;
+                continue;
+            }
+
+            TEST_CHECK_RET(status == NV_OK);
+
+            free_size -= range_alloc_size(&range_allocs[allocated_ranges]);
+            allocated_ranges++;
+        }
+        else {
+            size_t index = uvm_test_rng_range_ptr(&rng, 0, allocated_ranges - 1);
+
+            free_size += test_free_range(&range_allocator, &range_allocs[index]);
+
+            allocated_ranges--;
+            range_allocs[index] = range_allocs[allocated_ranges];
+        }
+    }
+
+    TEST_CHECK_RET(test_check_stats(&range_allocator, free_size) == NV_OK);
+    uvm_range_allocator_get_stats(&range_allocator, &stats);
+
+    if (verbose) {
+        UVM_TEST_PRINT("Iters %u, %llu ns per alloc, %llu failed allocs, %zu allocated ranges, "
+                       "%llu free ranges, largest free range %llu of %llu free\n",
+                       STRESS_TEST_ITERS,
+                       alloc_ns / STRESS_TEST_ITERS,
+                       failed_allocs,
+                       allocated_ranges,
+                       stats.free_ranges,
+                       stats.largest_free_range,
+                       stats.free_size);
+    }
+
+    while (allocated_ranges > 0)
+        test_free_range(&range_allocator, &range_allocs[--allocated_ranges]);
+
+    TEST_CHECK_RET(test_check_range_allocator_empty(&range_allocator) == NV_OK);
+    TEST_CHECK_RET(test_check_stats(&range_allocator, STRESS_TEST_SIZE) == NV_OK);
+
+    uvm_range_allocator_deinit(&range_allocator);
+    uvm_kvfree(range_allocs);
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_test_range_allocator_sanity(UVM_TEST_RANGE_ALLOCATOR_SANITY_PARAMS *params, struct file *filp)
 {
     TEST_CHECK_RET(basic_test() == NV_OK);
+    TEST_CHECK_RET(best_fit_test() == NV_OK);
     TEST_CHECK_RET(random_test(params->iters, params->seed, params->verbose > 0) == NV_OK);
+    TEST_CHECK_RET(stress_test(params->seed, params->verbose > 0) == NV_OK);
 
     return NV_OK;
 }
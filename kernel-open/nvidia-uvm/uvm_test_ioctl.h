@@ -273,6 +273,14 @@ typedef struct
 #define UVM_TEST_PAGE_TREE                               UVM_TEST_IOCTL_BASE(10)
 typedef struct
 {
+    // Time taken to get and put the PTEs of the range vector test one page
+    // table at a time and through the range vector bulk path, summed over
+    // every configuration tested.
+    NvU64     range_vec_single_get_ns NV_ALIGN_BYTES(8); // Out
+    NvU64     range_vec_single_put_ns NV_ALIGN_BYTES(8); // Out
+    NvU64     range_vec_bulk_get_ns   NV_ALIGN_BYTES(8); // Out
+    NvU64     range_vec_bulk_put_ns   NV_ALIGN_BYTES(8); // Out
+
     NV_STATUS rmStatus;                     // Out
 } UVM_TEST_PAGE_TREE_PARAMS;
 
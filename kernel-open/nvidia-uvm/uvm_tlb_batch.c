@@ -86,28 +86,160 @@ static void tlb_batch_flush_invalidate_all(uvm_tlb_batch_t *batch, uvm_push_t *p
     gpu->parent->host_hal->tlb_invalidate_all(push, uvm_page_tree_pdb_address(tree), page_table_depth, batch->membar);
 }
 
-static bool tlb_batch_should_invalidate_all(uvm_tlb_batch_t *batch)
+// Number of Host methods needed to invalidate the queued up ranges with
+// targeted invalidates
+static NvU64 tlb_batch_targeted_cost(uvm_tlb_batch_t *batch)
 {
-    if (!batch->tree->gpu->parent->tlb_batch.va_invalidate_supported)
-        return true;
+    NvU64 cost = 0;
+    NvU32 i;
+
+    if (batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
+        return batch->count;
+
+    for (i = 0; i < batch->count; ++i)
+        cost += uvm_div_pow2_64(batch->ranges[i].size, smallest_page_size(batch->ranges[i].page_sizes));
+
+    return cost;
+}
+
+static uvm_tlb_batch_plan_t tlb_batch_plan(uvm_tlb_batch_t *batch)
+{
+    uvm_parent_gpu_t *parent_gpu = batch->tree->gpu->parent;
+    NvU64 max_cost;
+
+    if (!parent_gpu->tlb_batch.va_invalidate_supported)
+        return UVM_TLB_BATCH_PLAN_ALL;
+
+    if (parent_gpu->tlb_batch.va_range_invalidate_supported)
+        max_cost = parent_gpu->tlb_batch.max_ranges;
+    else
+        max_cost = parent_gpu->tlb_batch.max_pages;
+
+    if (tlb_batch_targeted_cost(batch) > max_cost)
+        return UVM_TLB_BATCH_PLAN_ALL;
+
+    if (batch->total_ranges <= UVM_TLB_BATCH_MAX_ENTRIES)
+        return UVM_TLB_BATCH_PLAN_TARGETED;
 
-    if (batch->count > UVM_TLB_BATCH_MAX_ENTRIES)
-        return true;
+    // The cost of range invalidates doesn't depend on their size, so the
+    // spread of the coalesced ranges is what decides whether they are still
+    // worth it.
+    if (parent_gpu->tlb_batch.va_range_invalidate_supported) {
+        NvU64 covered = 0;
+        NvU64 max_covered = 0;
+        NvU32 i;
 
+        for (i = 0; i < batch->count; ++i) {
+            uvm_tlb_batch_range_t *entry = &batch->ranges[i];
+            NvU64 pde_coverage = uvm_mmu_pde_coverage(batch->tree, smallest_page_size(entry->page_sizes));
+
+            covered += entry->size;
+            max_covered = max(max_covered, pde_coverage * UVM_TLB_BATCH_MAX_COALESCED_PDES);
+        }
+
+        if (covered > max_covered)
+            return UVM_TLB_BATCH_PLAN_ALL;
+    }
+
+    return UVM_TLB_BATCH_PLAN_PER_PDE;
+}
+
+// Granularity at which ranges are coalesced. A single range invalidate costs the
+// same regardless of its size, so ranges are extended to the VA covered by
+// their page tables to make neighbouring ranges merge. Otherwise each
+// invalidated page costs a Host method and ranges are kept as tight as
+// possible.
+static NvU64 tlb_batch_coalesce_granularity(uvm_tlb_batch_t *batch, NvU64 page_sizes)
+{
     if (batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
-        return batch->total_ranges > batch->tree->gpu->parent->tlb_batch.max_ranges;
+        return uvm_mmu_pde_coverage(batch->tree, smallest_page_size(page_sizes));
+
+    return smallest_page_size(page_sizes);
+}
+
+static void tlb_batch_range_merge(uvm_tlb_batch_range_t *dst, uvm_tlb_batch_range_t *src)
+{
+    NvU64 end = max(dst->start + dst->size, src->start + src->size);
+
+    dst->start = min(dst->start, src->start);
+    dst->size = end - dst->start;
+    dst->page_sizes |= src->page_sizes;
+}
+
+// Add a range to a batch that already has UVM_TLB_BATCH_MAX_ENTRIES ranges
+// queued up. All the ranges are aligned to their coalescing granularity and
+// overlapping or adjacent ones are merged. If that's not enough to make room,
+// the two ranges with the smallest gap between them are merged.
+static void tlb_batch_coalesce(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, NvU64 page_sizes)
+{
+    uvm_tlb_batch_range_t ranges[UVM_TLB_BATCH_MAX_ENTRIES + 1];
+    NvU32 count = batch->count + 1;
+    NvU32 i, j;
+
+    UVM_ASSERT(batch->count == UVM_TLB_BATCH_MAX_ENTRIES);
 
-    return batch->total_pages > batch->tree->gpu->parent->tlb_batch.max_pages;
+    memcpy(ranges, batch->ranges, sizeof(batch->ranges));
+    ranges[batch->count].start = start;
+    ranges[batch->count].size = size;
+    ranges[batch->count].page_sizes = page_sizes;
+
+    for (i = 0; i < count; ++i) {
+        NvU64 granularity = tlb_batch_coalesce_granularity(batch, ranges[i].page_sizes);
+        NvU64 end = UVM_ALIGN_UP(ranges[i].start + ranges[i].size, granularity);
+
+        ranges[i].start = UVM_ALIGN_DOWN(ranges[i].start, granularity);
+        ranges[i].size = end - ranges[i].start;
+    }
+
+    // Insertion sort by start address
+    for (i = 1; i < count; ++i) {
+        uvm_tlb_batch_range_t range = ranges[i];
+
+        for (j = i; j > 0 && ranges[j - 1].start > range.start; --j)
+            ranges[j] = ranges[j - 1];
+
+        ranges[j] = range;
+    }
+
+    // Merge overlapping and adjacent ranges
+    for (i = 0, j = 1; j < count; ++j) {
+        if (ranges[j].start <= ranges[i].start + ranges[i].size)
+            tlb_batch_range_merge(&ranges[i], &ranges[j]);
+        else
+            ranges[++i] = ranges[j];
+    }
+    count = i + 1;
+
+    if (count > UVM_TLB_BATCH_MAX_ENTRIES) {
+        NvU32 closest = 0;
+        NvU64 closest_gap = ~0ULL;
+
+        for (i = 0; i < count - 1; ++i) {
+            NvU64 gap = ranges[i + 1].start - (ranges[i].start + ranges[i].size);
+
+            if (gap < closest_gap) {
+                closest_gap = gap;
+                closest = i;
+            }
+        }
+
+        tlb_batch_range_merge(&ranges[closest], &ranges[closest + 1]);
+        memmove(&ranges[closest + 1], &ranges[closest + 2], sizeof(ranges[0]) * (count - closest - 2));
+        count--;
+    }
+
+    memcpy(batch->ranges, ranges, sizeof(ranges[0]) * count);
+    batch->count = count;
 }
 
 void uvm_tlb_batch_end(uvm_tlb_batch_t *batch, uvm_push_t *push, uvm_membar_t tlb_membar)
 {
-    if (batch->count == 0)
+    if (batch->total_ranges == 0)
         return;
 
     batch->membar = uvm_membar_max(tlb_membar, batch->membar);
 
-    if (tlb_batch_should_invalidate_all(batch))
+    if (batch->plan == UVM_TLB_BATCH_PLAN_ALL)
         tlb_batch_flush_invalidate_all(batch, push);
     else
         tlb_batch_flush_invalidate_per_va(batch, push);
@@ -119,20 +251,24 @@ void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, N
 
     batch->membar = uvm_membar_max(tlb_membar, batch->membar);
 
-    ++batch->count;
-
-    if (batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
-        batch->total_ranges++;
-    else
-        batch->total_pages += uvm_div_pow2_64(size, smallest_page_size(page_sizes));
+    ++batch->total_ranges;
 
     batch->biggest_page_size = max(batch->biggest_page_size, biggest_page_size(page_sizes));
 
-    if (tlb_batch_should_invalidate_all(batch))
+    // Once everything is going to be invalidated there is no need to track
+    // the ranges anymore.
+    if (batch->plan == UVM_TLB_BATCH_PLAN_ALL)
         return;
 
-    new_entry = &batch->ranges[batch->count - 1];
-    new_entry->start = start;
-    new_entry->size = size;
-    new_entry->page_sizes = page_sizes;
+    if (batch->count < UVM_TLB_BATCH_MAX_ENTRIES) {
+        new_entry = &batch->ranges[batch->count++];
+        new_entry->start = start;
+        new_entry->size = size;
+        new_entry->page_sizes = page_sizes;
+    }
+    else {
+        tlb_batch_coalesce(batch, start, size, page_sizes);
+    }
+
+    batch->plan = tlb_batch_plan(batch);
 }
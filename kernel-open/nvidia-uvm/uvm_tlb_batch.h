@@ -35,6 +35,12 @@
 //       implemented, verify whether it makes sense.
 #define UVM_TLB_BATCH_MAX_ENTRIES 4
 
+// Max number of page tables worth of VA that coalesced ranges can cover before
+// falling back to invalidate all. Targeted invalidates covering more than a
+// full directory above the page tables evict most of the relevant TLB entries
+// anyway.
+#define UVM_TLB_BATCH_MAX_COALESCED_PDES 512
+
 typedef struct
 {
     NvU64 start;
@@ -44,24 +50,38 @@ typedef struct
     NvU64 page_sizes;
 } uvm_tlb_batch_range_t;
 
-struct uvm_tlb_batch_struct
+// How the queued up invalidates of a batch are going to be pushed
+typedef enum
 {
-    uvm_page_tree_t *tree;
+    // Each queued up range is invalidated separately
+    UVM_TLB_BATCH_PLAN_TARGETED,
 
-    union
-    {
-        // Total number of pages covered by the queued up ranges so far
-        NvU32 total_pages;
+    // More ranges than UVM_TLB_BATCH_MAX_ENTRIES were queued up. They have been
+    // coalesced, at page table granularity when VA range invalidates are
+    // supported, and each coalesced range is invalidated separately.
+    UVM_TLB_BATCH_PLAN_PER_PDE,
 
-        // Total number of ranges that have been invalidated so far
-        // Each range can be invalidated using a single Host method on supported GPUs
-        NvU32 total_ranges;
-    };
+    // A single invalidate of all VAs
+    UVM_TLB_BATCH_PLAN_ALL,
+} uvm_tlb_batch_plan_t;
 
-    // Queued up ranges to invalidate
+struct uvm_tlb_batch_struct
+{
+    uvm_page_tree_t *tree;
+
+    // Queued up ranges to invalidate, sorted by start address once coalesced
     uvm_tlb_batch_range_t ranges[UVM_TLB_BATCH_MAX_ENTRIES];
     NvU32 count;
 
+    // Total number of ranges queued up so far, before coalescing
+    NvU32 total_ranges;
+
+    // How the batch is going to be invalidated given the ranges queued up so
+    // far. The plan is picked based on the number of ranges and their spread,
+    // trading the Host methods needed for targeted invalidates against the
+    // TLB entries needlessly evicted by broader ones.
+    uvm_tlb_batch_plan_t plan;
+
     // Biggest page size across all queued up invalidates
     NvU64 biggest_page_size;
 
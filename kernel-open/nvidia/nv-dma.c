@@ -26,6 +26,7 @@
 #include "os-interface.h"
 #include "nv-linux.h"
 #include "nv-reg.h"
+#include "nv-procfs.h"
 
 #if IS_ENABLED(CONFIG_DRM)
 #include <drm/drm_device.h>
@@ -46,6 +47,23 @@
 
 NvU32 nv_dma_remap_peer_mmio = NV_DMA_REMAP_PEER_MMIO_ENABLE;
 
+/*
+ * Statistics for system memory DMA mappings, for all devices. Page arrays that
+ * turn out to be physically contiguous are mapped with a single dma_map_page()
+ * call and counted as coalesced; the rest go through a scatterlist and their
+ * number of mapped DMA segments is accumulated. Mapping time only covers
+ * nv_dma_map_pages().
+ */
+static struct
+{
+    atomic64_t sg_maps;
+    atomic64_t sg_pages;
+    atomic64_t sg_segments;
+    atomic64_t coalesced_maps;
+    atomic64_t coalesced_pages;
+    atomic64_t map_time_ns;
+} nv_dma_stats;
+
 NV_STATUS   nv_create_dma_map_scatterlist (nv_dma_map_t *dma_map);
 void        nv_destroy_dma_map_scatterlist(nv_dma_map_t *dma_map);
 NV_STATUS   nv_map_dma_map_scatterlist    (nv_dma_map_t *dma_map);
@@ -327,6 +345,8 @@ static NV_STATUS nv_dma_map_scatterlist(
 )
 {
     NV_STATUS status;
+    nv_dma_submap_t *submap;
+    NvU64 segment_count = 0;
     NvU64 i;
 
     status = nv_create_dma_map_scatterlist(dma_map);
@@ -348,20 +368,38 @@ static NV_STATUS nv_dma_map_scatterlist(
 
     nv_load_dma_map_scatterlist(dma_map, va_array);
 
-    for (i = 0; i < dma_map->page_count; i++)
+    //
+    // Check addressability per mapped segment rather than per page, segments
+    // can cover up to 4GB.
+    //
+    NV_FOR_EACH_DMA_SUBMAP(dma_map, submap, i)
     {
-        if (!nv_dma_is_addressable(dma_dev, va_array[i], PAGE_SIZE))
+        struct scatterlist *sg;
+        unsigned int j;
+
+        for_each_sg(submap->sgt.sgl, sg, submap->sg_map_count, j)
         {
-            NV_DMA_DEV_PRINTF(NV_DBG_ERRORS, dma_dev,
-                    "DMA address not in addressable range of device "
-                    "(0x%llx, 0x%llx-0x%llx)\n",
-                    va_array[i], dma_dev->addressable_range.start,
-                    dma_dev->addressable_range.limit);
-            nv_dma_unmap_scatterlist(dma_map);
-            return NV_ERR_INVALID_ADDRESS;
+            if (!nv_dma_is_addressable(dma_dev, sg_dma_address(sg), sg_dma_len(sg)))
+            {
+                NV_DMA_DEV_PRINTF(NV_DBG_ERRORS, dma_dev,
+                        "DMA address not in addressable range of device "
+                        "(0x%llx-0x%llx, 0x%llx-0x%llx)\n",
+                        (NvU64)sg_dma_address(sg),
+                        (NvU64)sg_dma_address(sg) + sg_dma_len(sg) - 1,
+                        dma_dev->addressable_range.start,
+                        dma_dev->addressable_range.limit);
+                nv_dma_unmap_scatterlist(dma_map);
+                return NV_ERR_INVALID_ADDRESS;
+            }
         }
+
+        segment_count += submap->sg_map_count;
     }
 
+    atomic64_inc(&nv_dma_stats.sg_maps);
+    atomic64_add(dma_map->page_count, &nv_dma_stats.sg_pages);
+    atomic64_add(segment_count, &nv_dma_stats.sg_segments);
+
     return NV_OK;
 }
 
@@ -447,6 +485,57 @@ static NV_STATUS NV_API_CALL nv_dma_unmap_sgt(
     return NV_OK;
 }
 
+/*
+ * Xen dom0 needs single-page segments (see NV_ALLOC_DMA_SUBMAP_SCATTERLIST), so
+ * never treat a page array as one contiguous segment there.
+ */
+static NvBool nv_dma_pages_are_contiguous(
+    struct page **pages,
+    NvU64 page_count
+)
+{
+#if !defined(NV_DOM0_KERNEL_PRESENT)
+    unsigned long first_pfn = page_to_pfn(pages[0]);
+    NvU64 i;
+
+    // dma_map_page_attrs() takes the size as a size_t
+    if (page_count > (SIZE_MAX >> PAGE_SHIFT))
+    {
+        return NV_FALSE;
+    }
+
+    for (i = 1; i < page_count; i++)
+    {
+        if (page_to_pfn(pages[i]) != first_pfn + i)
+        {
+            return NV_FALSE;
+        }
+    }
+
+    return NV_TRUE;
+#else
+    return NV_FALSE;
+#endif
+}
+
+#if defined(CONFIG_PROC_FS)
+void nv_dma_procfs_print(struct seq_file *s)
+{
+    seq_printf(s, "Scatterlist mappings:  %lld\n",
+               (long long)atomic64_read(&nv_dma_stats.sg_maps));
+    seq_printf(s, "Scatterlist pages:     %lld\n",
+               (long long)atomic64_read(&nv_dma_stats.sg_pages));
+    seq_printf(s, "Scatterlist segments:  %lld\n",
+               (long long)atomic64_read(&nv_dma_stats.sg_segments));
+    seq_printf(s, "Coalesced mappings:    %lld\n",
+               (long long)atomic64_read(&nv_dma_stats.coalesced_maps));
+    seq_printf(s, "Coalesced pages:       %lld\n",
+               (long long)atomic64_read(&nv_dma_stats.coalesced_pages));
+    seq_printf(s, "Mapping time (us):     %lld\n",
+               (long long)(atomic64_read(&nv_dma_stats.map_time_ns) / NSEC_PER_USEC));
+}
+#endif
+
 static NV_STATUS NV_API_CALL nv_dma_map_pages(
     nv_dma_device_t *dma_dev,
     NvU64            page_count,
@@ -458,6 +547,8 @@ static NV_STATUS NV_API_CALL nv_dma_map_pages(
 {
     NV_STATUS status;
     nv_dma_map_t *dma_map = NULL;
+    NvU64 start_ns;
+    NvU64 i;
 
     if (priv == NULL)
     {
@@ -490,7 +581,29 @@ static NV_STATUS NV_API_CALL nv_dma_map_pages(
     dma_map->contiguous = contig;
     dma_map->cache_type = cache_type;
 
-    if (dma_map->page_count > 1 && !dma_map->contiguous)
+    start_ns = nv_ktime_get_raw_ns();
+
+    if (dma_map->page_count > 1 && !dma_map->contiguous &&
+        nv_dma_pages_are_contiguous(dma_map->pages, dma_map->page_count) &&
+        (nv_dma_map_contig(dma_dev, dma_map, va_array) == NV_OK))
+    {
+        //
+        // The page array is physically contiguous, so it was mapped as a
+        // single segment without building a scatterlist. Callers of
+        // discontiguous mappings expect an address per page.
+        //
+        dma_map->contiguous = NV_TRUE;
+
+        for (i = 1; i < dma_map->page_count; i++)
+        {
+            va_array[i] = va_array[0] + (i << PAGE_SHIFT);
+        }
+
+        atomic64_inc(&nv_dma_stats.coalesced_maps);
+        atomic64_add(dma_map->page_count, &nv_dma_stats.coalesced_pages);
+        status = NV_OK;
+    }
+    else if (dma_map->page_count > 1 && !dma_map->contiguous)
     {
         dma_map->mapping.discontig.submap_count = 0;
         status = nv_dma_map_scatterlist(dma_dev, dma_map, va_array);
@@ -506,6 +619,8 @@ static NV_STATUS NV_API_CALL nv_dma_map_pages(
         status = nv_dma_map_contig(dma_dev, dma_map, va_array);
     }
 
+    atomic64_add(nv_ktime_get_raw_ns() - start_ns, &nv_dma_stats.map_time_ns);
+
     if (status != NV_OK)
     {
         os_free_mem(dma_map);
@@ -25,6 +25,7 @@
 
 #include "os-interface.h"
 #include "nv-linux.h"
+#include "nv-procfs.h"
 #include "nv_speculation_barrier.h"
 
 /*
@@ -204,8 +205,367 @@ found:
     return length;
 }
 
-static vm_fault_t nvidia_fault(
-    struct vm_fault *vmf
+/*
+ * Huge PFN mappings of GPU memory.
+ *
+ * Kernels with special PMD/PUD entry support (CONFIG_ARCH_SUPPORTS_PMD_PFNMAP
+ * and CONFIG_ARCH_SUPPORTS_PUD_PFNMAP, v6.12) can map VM_PFNMAP VMAs with
+ * PMD/PUD-sized entries from the huge_fault() callback. On those kernels, BAR
+ * mappings that contain at least one PMD-sized chunk with matching virtual
+ * and physical alignment are not populated by nvidia_mmap_helper(). They get
+ * nv_huge_pfn_vm_ops and are filled in on demand instead, with the largest
+ * entry the physical contiguity and alignment of the mapping allow at the
+ * faulting address. nvidia_get_unmapped_area() places such mappings at
+ * PMD-aligned addresses.
+ *
+ * The mappings are also marked VM_HUGEPAGE so that the core mm calls
+ * huge_fault() when THP is in madvise mode. Userspace can clear that flag
+ * with madvise(), so the driver identifies the mappings by their vm_ops.
+ */
+#if defined(CONFIG_ARCH_SUPPORTS_PMD_PFNMAP)
+#define NV_MMAP_HUGE_PFN_SUPPORTED 1
+#else
+#define NV_MMAP_HUGE_PFN_SUPPORTED 0
+#endif
+
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+#include <linux/pfn_t.h>
+#endif
+
+typedef enum
+{
+    NV_MMAP_ENTRY_PTE = 0,
+    NV_MMAP_ENTRY_PMD,
+    NV_MMAP_ENTRY_PUD,
+    NV_MMAP_ENTRY_COUNT
+} nv_mmap_entry_t;
+
+// Number of user page table entries installed by the driver, per entry size
+static atomic64_t nv_mmap_entries[NV_MMAP_ENTRY_COUNT];
+
+static void nv_mmap_count_entries(nv_mmap_entry_t type, NvU64 count)
+{
+    atomic64_add(count, &nv_mmap_entries[type]);
+}
+
+#if defined(CONFIG_PROC_FS)
+static void nv_mmap_procfs_print_entries(
+    struct seq_file *s,
+    NvU64 entry_size,
+    nv_mmap_entry_t type
+)
+{
+    static const char *units[] = { "KB", "MB", "GB", "TB" };
+    char label[32];
+    unsigned int unit = 0;
+
+    entry_size >>= 10;
+    while ((unit + 1 < ARRAY_SIZE(units)) && (entry_size >= 1024) &&
+           ((entry_size & 1023) == 0))
+    {
+        entry_size >>= 10;
+        unit++;
+    }
+
+    snprintf(label, sizeof(label), "%llu %s entries:", entry_size, units[unit]);
+    seq_printf(s, "%-19s%lld\n", label,
+               (long long)atomic64_read(&nv_mmap_entries[type]));
+}
+
+void nv_mmap_procfs_print(struct seq_file *s)
+{
+    seq_printf(s, "Huge PFN mappings: %s\n",
+               NV_MMAP_HUGE_PFN_SUPPORTED ? "supported" : "not supported");
+    nv_mmap_procfs_print_entries(s, PAGE_SIZE, NV_MMAP_ENTRY_PTE);
+    nv_mmap_procfs_print_entries(s, PMD_SIZE, NV_MMAP_ENTRY_PMD);
+    nv_mmap_procfs_print_entries(s, PUD_SIZE, NV_MMAP_ENTRY_PUD);
+}
+#endif
+
+//
+// Look up the physical address backing the given offset into the mapping,
+// and how many bytes from there on are physically contiguous.
+//
+static NvBool nv_mmap_lookup_offset(
+    const nv_alloc_mapping_context_t *mmap_context,
+    NvU64 offset,
+    NvU64 *phys_addr,
+    NvU64 *contig_size
+)
+{
+    NvU64 idx;
+    NvU64 curOffs = 0;
+
+    for (idx = 0; idx < mmap_context->memArea.numRanges; idx++)
+    {
+        NvU64 rangeSize = mmap_context->memArea.pRanges[idx].size;
+
+        if (offset < curOffs + rangeSize)
+        {
+            *phys_addr = mmap_context->memArea.pRanges[idx].start + (offset - curOffs);
+            *contig_size = curOffs + rangeSize - offset;
+            return NV_TRUE;
+        }
+        curOffs += rangeSize;
+    }
+
+    return NV_FALSE;
+}
+
+#if NV_MMAP_HUGE_PFN_SUPPORTED
+//
+// Check whether a mapping of the context at vm_start would have at least one
+// PMD-sized chunk with matching virtual and physical alignment.
+//
+static NvBool nv_mmap_has_huge_chunk(
+    NvU64 vm_start,
+    const nv_alloc_mapping_context_t *mmap_context
+)
+{
+    NvU64 idx;
+    NvU64 curOffs = 0;
+
+    for (idx = 0; idx < mmap_context->memArea.numRanges; idx++)
+    {
+        NvU64 virt = vm_start + curOffs;
+        NvU64 phys = mmap_context->memArea.pRanges[idx].start;
+        NvU64 size = mmap_context->memArea.pRanges[idx].size;
+
+        if (((virt ^ phys) & (PMD_SIZE - 1)) == 0 &&
+            NV_ALIGN_UP(virt, PMD_SIZE) + PMD_SIZE <= virt + size)
+        {
+            return NV_TRUE;
+        }
+        curOffs += size;
+    }
+
+    return NV_FALSE;
+}
+
+static vm_fault_t nv_insert_pfn_huge(
+    struct vm_fault *vmf,
+    NvU64 pfn,
+    unsigned int order
+)
+{
+    NvBool write = !!(vmf->flags & FAULT_FLAG_WRITE);
+
+    if (order == PMD_SHIFT - PAGE_SHIFT)
+    {
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+        return vmf_insert_pfn_pmd(vmf, __pfn_to_pfn_t(pfn, PFN_DEV), write);
+#else
+        return vmf_insert_pfn_pmd(vmf, pfn, write);
+#endif
+    }
+
+#if defined(CONFIG_ARCH_SUPPORTS_PUD_PFNMAP)
+    if (order == PUD_SHIFT - PAGE_SHIFT)
+    {
+#if defined(NV_VMF_INSERT_PFN_PMD_HAS_PFN_T_ARG)
+        return vmf_insert_pfn_pud(vmf, __pfn_to_pfn_t(pfn, PFN_DEV), write);
+#else
+        return vmf_insert_pfn_pud(vmf, pfn, write);
+#endif
+    }
+#endif
+
+    return VM_FAULT_FALLBACK;
+}
+
+//
+// Place GPU mappings that can use huge PFN entries at PMD-aligned addresses.
+// Everything else, including all control device mappings, gets the default
+// placement.
+//
+unsigned long nvidia_get_unmapped_area(
+    struct file *file,
+    unsigned long addr,
+    unsigned long len,
+    unsigned long pgoff,
+    unsigned long flags
+)
+{
+    nv_linux_file_private_t *nvlfp = NV_GET_LINUX_FILE_PRIVATE(file);
+    const nv_alloc_mapping_context_t *mmap_context = &nvlfp->mmap_context;
+
+    //
+    // The mapping context is set up by RM before mmap(). A PMD-aligned
+    // address lines the mapping up with the physical alignment of its ranges,
+    // so checking for huge chunks at offset 0 is enough.
+    //
+    if (!nv_is_control_device(NV_FILE_INODE(file)) &&
+        mmap_context->valid && (pgoff == 0) && (len >= PMD_SIZE) &&
+        nv_mmap_has_huge_chunk(0, mmap_context))
+    {
+        return thp_get_unmapped_area(file, addr, len, pgoff, flags);
+    }
+
+#if defined(NV_MM_GET_UNMAPPED_AREA_HAS_MM_ARG)
+    return mm_get_unmapped_area(current->mm, file, addr, len, pgoff, flags);
+#else
+    return mm_get_unmapped_area(file, addr, len, pgoff, flags);
+#endif
+}
+#endif // NV_MMAP_HUGE_PFN_SUPPORTED
+
+//
+// Set up a BAR mapping to be filled in by the fault handlers with huge entries
+// instead of being populated up front. Returns NV_FALSE if the mapping has no
+// chunk that could use a huge entry, or huge PFN mappings are not supported.
+//
+static NvBool nv_mmap_setup_huge_pfn_mapping(
+    struct vm_area_struct *vma,
+    const nv_alloc_mapping_context_t *mmap_context
+)
+{
+#if NV_MMAP_HUGE_PFN_SUPPORTED
+    if (!nv_mmap_has_huge_chunk(vma->vm_start, mmap_context))
+    {
+        return NV_FALSE;
+    }
+
+    // Match the protection nv_io_remap_page_range() would have used
+    vma->vm_page_prot = nv_adjust_pgprot(vma->vm_page_prot);
+    nv_vm_flags_set(vma, VM_HUGEPAGE);
+
+    return NV_TRUE;
+#else
+    return NV_FALSE;
+#endif
+}
+
+static struct vm_operations_struct nv_huge_pfn_vm_ops;
+
+static NvBool nv_vma_is_huge_pfn_mapping(struct vm_area_struct *vma)
+{
+    return (vma->vm_ops == &nv_huge_pfn_vm_ops);
+}
+
+//
+// Reinstate the whole mapping at base page granularity. Used for mappings that
+// were populated at mmap time and later revoked.
+//
+static vm_fault_t nvidia_fault_insert_all(
+    struct vm_area_struct *vma,
+    nv_linux_state_t *nvl,
+    const nv_alloc_mapping_context_t *mmap_context
+)
+{
+    vm_fault_t ret = VM_FAULT_NOPAGE;
+    NvU64 idx;
+    NvU64 curOffs = 0;
+    NvU64 numInserted = 0;
+    NvBool bRevoked = NV_TRUE;
+
+    for(idx = 0; idx < mmap_context->memArea.numRanges; idx++)
+    {
+        NvU64 nextOffs = curOffs + mmap_context->memArea.pRanges[idx].size;
+        NvU64 pfn = mmap_context->memArea.pRanges[idx].start >> PAGE_SHIFT;
+        NvU64 numPages = mmap_context->memArea.pRanges[idx].size >> PAGE_SHIFT;
+        while (numPages != 0)
+        {
+            ret = nv_insert_pfn(vma, curOffs + vma->vm_start, pfn);
+            if (ret != VM_FAULT_NOPAGE)
+            {
+                goto err;
+            }
+            bRevoked = NV_FALSE;
+            numInserted++;
+            curOffs += PAGE_SIZE;
+            pfn++;
+            numPages--;
+        }
+        curOffs = nextOffs;
+    }
+err:
+    nvl->all_mappings_revoked &= bRevoked;
+    nv_mmap_count_entries(NV_MMAP_ENTRY_PTE, numInserted);
+
+    return ret;
+}
+
+//
+// Install the entry covering the faulting address of a huge PFN mapping.
+// Order 0 faults come from ranges that can't be mapped with a huge entry, so
+// the rest of the surrounding PMD-sized window is prefaulted as well to avoid
+// taking one fault per base page.
+//
+static vm_fault_t nvidia_fault_insert_entry(
+    struct vm_fault *vmf,
+    nv_linux_state_t *nvl,
+    const nv_alloc_mapping_context_t *mmap_context,
+    unsigned int order
+)
+{
+    struct vm_area_struct *vma = vmf->vma;
+    vm_fault_t ret = VM_FAULT_NOPAGE;
+    NvU64 phys_addr;
+    NvU64 contig_size;
+    NvU64 addr;
+    NvU64 end;
+
+#if NV_MMAP_HUGE_PFN_SUPPORTED
+    if (order != 0)
+    {
+        NvU64 size = PAGE_SIZE << order;
+
+        addr = vmf->address & ~(size - 1);
+
+        if (addr < vma->vm_start || addr + size > vma->vm_end ||
+            !nv_mmap_lookup_offset(mmap_context, addr - vma->vm_start,
+                                   &phys_addr, &contig_size) ||
+            contig_size < size || (phys_addr & (size - 1)) != 0)
+        {
+            return VM_FAULT_FALLBACK;
+        }
+
+        ret = nv_insert_pfn_huge(vmf, phys_addr >> PAGE_SHIFT, order);
+        if (ret == VM_FAULT_NOPAGE)
+        {
+            nvl->all_mappings_revoked = NV_FALSE;
+            nv_mmap_count_entries((order == PMD_SHIFT - PAGE_SHIFT) ?
+                                  NV_MMAP_ENTRY_PMD : NV_MMAP_ENTRY_PUD, 1);
+        }
+        return ret;
+    }
+#endif
+
+    addr = NV_MAX(vmf->address & PMD_MASK, vma->vm_start);
+    end = NV_MIN((vmf->address & PMD_MASK) + PMD_SIZE, vma->vm_end);
+
+    while (addr < end)
+    {
+        NvU64 numPages;
+
+        if (!nv_mmap_lookup_offset(mmap_context, addr - vma->vm_start,
+                                   &phys_addr, &contig_size))
+        {
+            return VM_FAULT_SIGBUS;
+        }
+
+        numPages = NV_MIN(contig_size, end - addr) >> PAGE_SHIFT;
+        while (numPages != 0)
+        {
+            ret = nv_insert_pfn(vma, addr, phys_addr >> PAGE_SHIFT);
+            if (ret != VM_FAULT_NOPAGE)
+            {
+                return ret;
+            }
+            nvl->all_mappings_revoked = NV_FALSE;
+            nv_mmap_count_entries(NV_MMAP_ENTRY_PTE, 1);
+            addr += PAGE_SIZE;
+            phys_addr += PAGE_SIZE;
+            numPages--;
+        }
+    }
+
+    return ret;
+}
+
+static vm_fault_t nvidia_fault_common(
+    struct vm_fault *vmf,
+    unsigned int order
 )
 {
     struct vm_area_struct *vma = vmf->vma;
@@ -225,6 +585,11 @@ static vm_fault_t nvidia_fault(
         return VM_FAULT_SIGBUS;
     }
 
+    // Only mappings set up for it are mapped with huge entries.
+    if ((order != 0) && !nv_vma_is_huge_pfn_mapping(vma))
+    {
+        return VM_FAULT_FALLBACK;
+    }
 
     // Wake up GPU and reinstate mappings only if we are not in S3/S4 entry
     if (!down_read_trylock(&nv_system_pm_lock))
@@ -267,32 +632,14 @@ static vm_fault_t nvidia_fault(
         up_read(&nv_system_pm_lock);
         return VM_FAULT_NOPAGE;
     }
+
+    if (nv_vma_is_huge_pfn_mapping(vma))
     {
-        NvU64 idx;
-        NvU64 curOffs = 0;
-        NvBool bRevoked = NV_TRUE;
-        nv_alloc_mapping_context_t *mmap_context = &nvlfp->mmap_context;
-        for(idx = 0; idx < mmap_context->memArea.numRanges; idx++)
-        {
-            NvU64 nextOffs = curOffs + mmap_context->memArea.pRanges[idx].size;
-            NvU64 pfn = mmap_context->memArea.pRanges[idx].start >> PAGE_SHIFT;
-            NvU64 numPages = mmap_context->memArea.pRanges[idx].size >> PAGE_SHIFT;
-            while (numPages != 0)
-            {
-                ret = nv_insert_pfn(vma, curOffs + vma->vm_start, pfn);
-                if (ret != VM_FAULT_NOPAGE)
-                {
-                    goto err;
-                }
-                bRevoked = NV_FALSE;
-                curOffs += PAGE_SIZE;
-                pfn++;
-                numPages--;
-            }
-            curOffs = nextOffs;
-        }
-err:
-        nvl->all_mappings_revoked &= bRevoked;
+        ret = nvidia_fault_insert_entry(vmf, nvl, &nvlfp->mmap_context, order);
+    }
+    else
+    {
+        ret = nvidia_fault_insert_all(vma, nvl, &nvlfp->mmap_context);
     }
 
     up(&nvl->mmap_lock);
@@ -301,6 +648,23 @@ err:
     return ret;
 }
 
+static vm_fault_t nvidia_fault(
+    struct vm_fault *vmf
+)
+{
+    return nvidia_fault_common(vmf, 0);
+}
+
+#if NV_MMAP_HUGE_PFN_SUPPORTED
+static vm_fault_t nvidia_huge_fault(
+    struct vm_fault *vmf,
+    unsigned int order
+)
+{
+    return nvidia_fault_common(vmf, order);
+}
+#endif
+
 static struct vm_operations_struct nv_vm_ops = {
     .open   = nvidia_vma_open,
     .close  = nvidia_vma_release,
@@ -308,6 +672,17 @@ static struct vm_operations_struct nv_vm_ops = {
     .access = nvidia_vma_access,
 };
 
+// Operations of the BAR mappings set up by nv_mmap_setup_huge_pfn_mapping()
+static struct vm_operations_struct nv_huge_pfn_vm_ops = {
+    .open   = nvidia_vma_open,
+    .close  = nvidia_vma_release,
+    .fault  = nvidia_fault,
+#if NV_MMAP_HUGE_PFN_SUPPORTED
+    .huge_fault = nvidia_huge_fault,
+#endif
+    .access = nvidia_vma_access,
+};
+
 int nv_encode_caching(
     pgprot_t *prot,
     NvU32     cache_type,
@@ -399,6 +774,10 @@ static int nvidia_mmap_peer_io(
     size = pages * PAGE_SIZE;
 
     ret = nv_io_remap_page_range(vma, start, size, vma->vm_start);
+    if (ret == 0)
+    {
+        nv_mmap_count_entries(NV_MMAP_ENTRY_PTE, pages);
+    }
 
     return ret;
 }
@@ -458,6 +837,8 @@ static int nvidia_mmap_sysmem(
         start += PAGE_SIZE;
     }
 
+    nv_mmap_count_entries(NV_MMAP_ENTRY_PTE, pages);
+
     return ret;
 }
 
@@ -489,6 +870,8 @@ static int nvidia_mmap_numa(
         }
     }
 
+    nv_mmap_count_entries(NV_MMAP_ENTRY_PTE, pages);
+
     return 0;
 }
 
@@ -504,6 +887,7 @@ int nvidia_mmap_helper(
     int ret;
     const nv_alloc_mapping_context_t *mmap_context = &nvlfp->mmap_context;
     nv_linux_state_t *nvl = NV_GET_NVL_FROM_NV_STATE(nv);
+    NvBool huge_pfn_mapping = NV_FALSE;
     NV_STATUS status;
 
     if (nvlfp == NULL)
@@ -607,6 +991,11 @@ int nvidia_mmap_helper(
                     return ret;
                 }
             }
+            else if (nv_mmap_setup_huge_pfn_mapping(vma, mmap_context))
+            {
+                // Mapped on access by nvidia_fault()/nvidia_huge_fault()
+                huge_pfn_mapping = NV_TRUE;
+            }
             else
             {
                 NvU64 idx = 0;
@@ -622,6 +1011,8 @@ int nvidia_mmap_helper(
                         up(&nvl->mmap_lock);
                         return -EAGAIN;
                     }
+                    nv_mmap_count_entries(NV_MMAP_ENTRY_PTE,
+                        mmap_context->memArea.pRanges[idx].size >> PAGE_SHIFT);
                     curOffs = nextOffs;
                 }
             }
@@ -720,7 +1111,7 @@ int nvidia_mmap_helper(
         nv_vm_flags_clear(vma, VM_MAYWRITE);
     }
 
-    vma->vm_ops = &nv_vm_ops;
+    vma->vm_ops = huge_pfn_mapping ? &nv_huge_pfn_vm_ops : &nv_vm_ops;
 
     return 0;
 }
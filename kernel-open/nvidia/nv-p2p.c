@@ -26,12 +26,17 @@
 #include "os-interface.h"
 #include "nv-linux.h"
 #include "nv-rsync.h"
+#include "nv-hash.h"
+#include "nv-procfs.h"
 
 #include "nv-p2p.h"
 #include "rmp2pdefines.h"
 
 #include "nvmisc.h"
 
+// linux/sched/mm.h is needed for mmgrab and mmdrop
+#include <linux/sched/mm.h>
+
 typedef enum nv_p2p_page_table_type {
     NV_P2P_PAGE_TABLE_TYPE_NON_PERSISTENT = 0,
     NV_P2P_PAGE_TABLE_TYPE_PERSISTENT,
@@ -40,6 +45,9 @@ typedef enum nv_p2p_page_table_type {
 typedef struct nv_p2p_dma_mapping {
     struct list_head list_node;
     struct nvidia_p2p_dma_mapping *dma_mapping;
+
+    // Number of nvidia_p2p_dma_map_pages() callers sharing dma_mapping
+    NvU32 refcount;
 } nv_p2p_dma_mapping_t;
 
 typedef struct nv_p2p_mem_info {
@@ -53,11 +61,252 @@ typedef struct nv_p2p_mem_info {
     void *private;
     void *mig_info;
     NvBool force_pcie;
+
+    // Registration cache linkage, see nv_p2p_reg_cache_lookup()
+    struct {
+        struct hlist_node hash_node;
+        struct mm_struct *mm;
+        NvU64 virtual_address;
+        NvU64 length;
+        NvU64 vidmem_id;
+        NvU32 flags;
+        NvU32 refcount;
+        NvBool cached;
+    } reg_cache;
 } nv_p2p_mem_info_t;
 
 // declared and created in nv.c
 extern void *nvidia_p2p_page_t_cache;
 
+/*
+ * Persistent page tables are cached by (process, GPU, virtual address,
+ * length, flags) so that repeated registrations of the same buffer, as done
+ * by RDMA frameworks, share one page table (and its DMA mappings) instead of
+ * walking the RM allocation every time. Each registration holds a reference;
+ * the entry is invalidated when the last reference is put or when the page
+ * table is torn down.
+ *
+ * RM resolves the virtual address in the address space of the calling
+ * process, so the process is identified by its mm, which the cache entry
+ * holds a reference on to keep it from being reused by another process. The
+ * GPU comes from rm_p2p_get_gpu_info(), which also checks that the address
+ * is valid for the caller before any cached page table is handed out.
+ *
+ * The address alone does not identify the memory: it can be freed and
+ * another allocation registered at the same range. Every lookup therefore
+ * re-resolves the range through rm_p2p_get_vidmem_id() and only matches
+ * entries created for the same RM vidmem registration. Stale entries stay
+ * unreachable until their last reference is put.
+ *
+ * Non-persistent page tables are not cached: each registration carries its
+ * own free callback, and nvidia_p2p_put_pages() does not identify which
+ * registration is being released.
+ *
+ * Zero-initialized hlist heads are empty.
+ */
+#define NV_P2P_REG_CACHE_HASH_BITS 6
+static NV_DECLARE_HASHTABLE(nv_p2p_reg_cache, NV_P2P_REG_CACHE_HASH_BITS);
+static NV_DEFINE_SPINLOCK(nv_p2p_reg_cache_lock);
+
+static struct
+{
+    atomic64_t page_table_hits;
+    atomic64_t page_table_misses;
+    atomic64_t dma_mapping_hits;
+    atomic64_t dma_mapping_misses;
+    atomic64_t invalidations;
+} nv_p2p_reg_cache_stats;
+
+static NvBool nv_p2p_reg_cache_match(
+    struct nv_p2p_mem_info *mem_info,
+    struct mm_struct *mm,
+    const NvU8 *gpu_uuid,
+    uint64_t virtual_address,
+    uint64_t length,
+    NvU64 vidmem_id,
+    uint32_t flags
+)
+{
+    return (mem_info->reg_cache.mm == mm) &&
+           (mem_info->reg_cache.virtual_address == virtual_address) &&
+           (mem_info->reg_cache.length == length) &&
+           (mem_info->reg_cache.vidmem_id == vidmem_id) &&
+           (mem_info->reg_cache.flags == flags) &&
+           (memcmp(mem_info->page_table.gpu_uuid, gpu_uuid,
+                   NVIDIA_P2P_GPU_UUID_LEN) == 0);
+}
+
+static struct nvidia_p2p_page_table *nv_p2p_reg_cache_lookup(
+    struct mm_struct *mm,
+    const NvU8 *gpu_uuid,
+    uint64_t virtual_address,
+    uint64_t length,
+    NvU64 vidmem_id,
+    uint32_t flags
+)
+{
+    struct nv_p2p_mem_info *mem_info;
+    struct nvidia_p2p_page_table *page_table = NULL;
+
+    NV_SPIN_LOCK(&nv_p2p_reg_cache_lock);
+
+    nv_hash_for_each_possible(nv_p2p_reg_cache, mem_info, reg_cache.hash_node,
+                              virtual_address)
+    {
+        if (nv_p2p_reg_cache_match(mem_info, mm, gpu_uuid, virtual_address,
+                                   length, vidmem_id, flags))
+        {
+            mem_info->reg_cache.refcount++;
+            page_table = &mem_info->page_table;
+            break;
+        }
+    }
+
+    NV_SPIN_UNLOCK(&nv_p2p_reg_cache_lock);
+
+    if (page_table != NULL)
+    {
+        atomic64_inc(&nv_p2p_reg_cache_stats.page_table_hits);
+    }
+    else
+    {
+        atomic64_inc(&nv_p2p_reg_cache_stats.page_table_misses);
+    }
+
+    return page_table;
+}
+
+static void nv_p2p_reg_cache_insert(
+    struct nv_p2p_mem_info *mem_info,
+    struct mm_struct *mm,
+    uint64_t virtual_address,
+    uint64_t length,
+    NvU64 vidmem_id,
+    uint32_t flags
+)
+{
+    struct nv_p2p_mem_info *cur;
+    const NvU8 *gpu_uuid = mem_info->page_table.gpu_uuid;
+
+    NV_SPIN_LOCK(&nv_p2p_reg_cache_lock);
+
+    //
+    // A concurrent registration of the same buffer may have won the race;
+    // leave this page table uncached in that case.
+    //
+    nv_hash_for_each_possible(nv_p2p_reg_cache, cur, reg_cache.hash_node,
+                              virtual_address)
+    {
+        if (nv_p2p_reg_cache_match(cur, mm, gpu_uuid, virtual_address,
+                                   length, vidmem_id, flags))
+        {
+            goto done;
+        }
+    }
+
+    mmgrab(mm);
+
+    mem_info->reg_cache.mm = mm;
+    mem_info->reg_cache.virtual_address = virtual_address;
+    mem_info->reg_cache.length = length;
+    mem_info->reg_cache.vidmem_id = vidmem_id;
+    mem_info->reg_cache.flags = flags;
+    mem_info->reg_cache.refcount = 1;
+    mem_info->reg_cache.cached = NV_TRUE;
+
+    nv_hash_add(nv_p2p_reg_cache, &mem_info->reg_cache.hash_node,
+                virtual_address);
+
+done:
+    NV_SPIN_UNLOCK(&nv_p2p_reg_cache_lock);
+}
+
+/*
+ * Removes a cached page table from the cache. Returns the mm reference held
+ * by the entry, which the caller drops after releasing the cache lock.
+ */
+static struct mm_struct *nv_p2p_reg_cache_remove_locked(
+    struct nv_p2p_mem_info *mem_info
+)
+{
+    struct mm_struct *mm = mem_info->reg_cache.mm;
+
+    hlist_del(&mem_info->reg_cache.hash_node);
+    mem_info->reg_cache.cached = NV_FALSE;
+    mem_info->reg_cache.mm = NULL;
+    atomic64_inc(&nv_p2p_reg_cache_stats.invalidations);
+
+    return mm;
+}
+
+static NvBool nv_p2p_reg_cache_release(
+    struct nv_p2p_mem_info *mem_info
+)
+{
+    struct mm_struct *mm = NULL;
+    NvBool last = NV_TRUE;
+
+    NV_SPIN_LOCK(&nv_p2p_reg_cache_lock);
+
+    if (mem_info->reg_cache.cached)
+    {
+        if (--mem_info->reg_cache.refcount > 0)
+        {
+            last = NV_FALSE;
+        }
+        else
+        {
+            mm = nv_p2p_reg_cache_remove_locked(mem_info);
+        }
+    }
+
+    NV_SPIN_UNLOCK(&nv_p2p_reg_cache_lock);
+
+    if (mm != NULL)
+    {
+        mmdrop(mm);
+    }
+
+    return last;
+}
+
+static void nv_p2p_reg_cache_invalidate(
+    struct nv_p2p_mem_info *mem_info
+)
+{
+    struct mm_struct *mm = NULL;
+
+    NV_SPIN_LOCK(&nv_p2p_reg_cache_lock);
+
+    if (mem_info->reg_cache.cached)
+    {
+        mm = nv_p2p_reg_cache_remove_locked(mem_info);
+    }
+
+    NV_SPIN_UNLOCK(&nv_p2p_reg_cache_lock);
+
+    if (mm != NULL)
+    {
+        mmdrop(mm);
+    }
+}
+
+#if defined(CONFIG_PROC_FS)
+void nv_p2p_procfs_print(struct seq_file *s)
+{
+    seq_printf(s, "Page table hits:       %lld\n",
+               (long long)atomic64_read(&nv_p2p_reg_cache_stats.page_table_hits));
+    seq_printf(s, "Page table misses:     %lld\n",
+               (long long)atomic64_read(&nv_p2p_reg_cache_stats.page_table_misses));
+    seq_printf(s, "DMA mapping hits:      %lld\n",
+               (long long)atomic64_read(&nv_p2p_reg_cache_stats.dma_mapping_hits));
+    seq_printf(s, "DMA mapping misses:    %lld\n",
+               (long long)atomic64_read(&nv_p2p_reg_cache_stats.dma_mapping_misses));
+    seq_printf(s, "Invalidations:         %lld\n",
+               (long long)atomic64_read(&nv_p2p_reg_cache_stats.invalidations));
+}
+#endif
+
 static struct nvidia_status_mapping {
     NV_STATUS status;
     int error;
@@ -134,6 +383,7 @@ static NV_STATUS nv_p2p_insert_dma_mapping(
     down(&mem_info->dma_mapping_list.lock);
 
     node->dma_mapping = dma_mapping;
+    node->refcount = 1;
     list_add_tail(&node->list_node, &mem_info->dma_mapping_list.list_head);
 
     up(&mem_info->dma_mapping_list.lock);
@@ -141,6 +391,40 @@ static NV_STATUS nv_p2p_insert_dma_mapping(
     return NV_OK;
 }
 
+/*
+ * Returns an existing DMA mapping of the page table for the given peer, with
+ * an extra reference taken, or NULL if there is none.
+ */
+static struct nvidia_p2p_dma_mapping* nv_p2p_get_dma_mapping(
+    struct nv_p2p_mem_info *mem_info,
+    struct pci_dev *peer
+)
+{
+    struct nv_p2p_dma_mapping *cur;
+    struct nvidia_p2p_dma_mapping *ret_dma_mapping = NULL;
+
+    down(&mem_info->dma_mapping_list.lock);
+
+    list_for_each_entry(cur, &mem_info->dma_mapping_list.list_head, list_node)
+    {
+        if (cur->dma_mapping->pci_dev == peer)
+        {
+            cur->refcount++;
+            ret_dma_mapping = cur->dma_mapping;
+            break;
+        }
+    }
+
+    up(&mem_info->dma_mapping_list.lock);
+
+    return ret_dma_mapping;
+}
+
+/*
+ * Unlinks dma_mapping, or the first mapping if dma_mapping is NULL, from
+ * mem_info and returns it. A specific dma_mapping is only unlinked once its
+ * last reference is dropped; NULL is returned while other references remain.
+ */
 static struct nvidia_p2p_dma_mapping* nv_p2p_remove_dma_mapping(
     struct nv_p2p_mem_info *mem_info,
     struct nvidia_p2p_dma_mapping *dma_mapping
@@ -155,6 +439,11 @@ static struct nvidia_p2p_dma_mapping* nv_p2p_remove_dma_mapping(
     {
         if (dma_mapping == NULL || dma_mapping == cur->dma_mapping)
         {
+            if ((dma_mapping != NULL) && (--cur->refcount > 0))
+            {
+                break;
+            }
+
             ret_dma_mapping = cur->dma_mapping;
             list_del(&cur->list_node);
             os_free_mem(cur);
@@ -263,6 +552,8 @@ static void nv_p2p_free_page_table(
 
     mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
 
+    nv_p2p_reg_cache_invalidate(mem_info);
+
     dma_mapping = nv_p2p_remove_dma_mapping(mem_info, NULL);
     while (dma_mapping != NULL)
     {
@@ -317,6 +608,14 @@ static NV_STATUS nv_p2p_put_pages(
          * callback which can free it unlike non-persistent page_table.
          */
         mem_info = container_of(*page_table, nv_p2p_mem_info_t, page_table);
+
+        // Other registrations still share this cached page_table
+        if (!nv_p2p_reg_cache_release(mem_info))
+        {
+            *page_table = NULL;
+            return NV_OK;
+        }
+
         status = rm_p2p_put_pages_persistent(sp, mem_info->private, *page_table, mem_info->mig_info);
     }
     else
@@ -413,6 +712,9 @@ static int nv_p2p_get_pages(
     NvU32 page_size_index;
     NvU64 temp_length;
     NvU8 *gpu_uuid = NULL;
+    void *gpu_info = NULL;
+    NvU64 vidmem_id = 0;
+    NvBool bCacheable = NV_FALSE;
     NvU8 uuid[NVIDIA_P2P_GPU_UUID_LEN] = {0};
     NvBool force_pcie = !!(flags & NVIDIA_P2P_FLAGS_FORCE_BAR1_MAPPING);
     NvBool cpu_cacheable;
@@ -442,9 +744,74 @@ static int nv_p2p_get_pages(
     }
 
     *page_table = NULL;
+
+    if (pt_type == NV_P2P_PAGE_TABLE_TYPE_PERSISTENT)
+    {
+        if ((p2p_token != 0) || (va_space != 0))
+        {
+            status = -ENOTSUPP;
+            goto failed;
+        }
+
+        //
+        // RM resolves the address in the calling process. Look the GPU up
+        // first, it's part of the registration cache key.
+        //
+        status = rm_p2p_get_gpu_info(sp, virtual_address, length,
+                                     &gpu_uuid, &gpu_info);
+        if (status != NV_OK)
+        {
+            goto failed;
+        }
+
+        //
+        // Resolve the range to its RM vidmem registration so that a cached
+        // page table is never returned for memory that has been freed and
+        // replaced at the same address.
+        //
+        if ((current->mm != NULL) &&
+            (rm_p2p_get_vidmem_id(sp, virtual_address, length, gpu_info,
+                                  &vidmem_id) == NV_OK))
+        {
+            bCacheable = NV_TRUE;
+            *page_table = nv_p2p_reg_cache_lookup(current->mm, gpu_uuid,
+                                                  virtual_address, length,
+                                                  vidmem_id, flags);
+        }
+
+        if (*page_table != NULL)
+        {
+            os_free_mem(gpu_uuid);
+
+            //
+            // Each registration holds its own device reference, which
+            // nvidia_p2p_put_pages_persistent() drops.
+            //
+            rc = nvidia_dev_get_uuid((*page_table)->gpu_uuid, sp);
+            if (rc != 0)
+            {
+                (void)nv_p2p_put_pages(pt_type, sp, p2p_token, va_space,
+                                       virtual_address, page_table);
+                status = NV_ERR_GPU_UUID_NOT_FOUND;
+            }
+            else
+            {
+                status = NV_OK;
+            }
+
+            nv_kmem_cache_free_stack(sp);
+
+            return nvidia_p2p_map_status(status);
+        }
+    }
+
     status = os_alloc_mem((void **)&mem_info, sizeof(*mem_info));
     if (status != NV_OK)
     {
+        if (gpu_uuid != NULL)
+        {
+            os_free_mem(gpu_uuid);
+        }
         goto failed;
     }
 
@@ -489,21 +856,6 @@ static int nv_p2p_get_pages(
 
     if (pt_type == NV_P2P_PAGE_TABLE_TYPE_PERSISTENT)
     {
-        void *gpu_info = NULL;
-
-        if ((p2p_token != 0) || (va_space != 0))
-        {
-            status = -ENOTSUPP;
-            goto failed;
-        }
-
-        status = rm_p2p_get_gpu_info(sp, virtual_address, length,
-                                     &gpu_uuid, &gpu_info);
-        if (status != NV_OK)
-        {
-            goto failed;
-        }
-
         (*page_table)->gpu_uuid = gpu_uuid;
 
         rc = nvidia_dev_get_uuid(gpu_uuid, sp);
@@ -605,6 +957,11 @@ static int nv_p2p_get_pages(
             goto failed;
         }
     }
+    else if ((pt_type == NV_P2P_PAGE_TABLE_TYPE_PERSISTENT) && bCacheable)
+    {
+        nv_p2p_reg_cache_insert(mem_info, current->mm, virtual_address,
+                                length, vidmem_id, flags);
+    }
 
     nv_kmem_cache_free_stack(sp);
 
@@ -801,6 +1158,19 @@ int nvidia_p2p_dma_map_pages(
         return -ENOTSUPP;
     }
 
+    //
+    // Page tables shared through the registration cache are commonly mapped
+    // for the same peer by every registration; reuse the existing mapping.
+    //
+    *dma_mapping = nv_p2p_get_dma_mapping(mem_info, peer);
+    if (*dma_mapping != NULL)
+    {
+        atomic64_inc(&nv_p2p_reg_cache_stats.dma_mapping_hits);
+        return 0;
+    }
+
+    atomic64_inc(&nv_p2p_reg_cache_stats.dma_mapping_misses);
+
     rc = nv_kmem_cache_alloc_stack(&sp);
     if (rc != 0)
     {
@@ -911,7 +1281,7 @@ int nvidia_p2p_dma_unmap_pages(
      * This ensures that the RM's tear-down path does not race with this path.
      *
      * nv_p2p_remove_dma_mappings returns NULL if the dma_mapping was already
-     * unlinked.
+     * unlinked, or if other callers still share it.
      */
     if (nv_p2p_remove_dma_mapping(mem_info, dma_mapping) == NULL)
     {
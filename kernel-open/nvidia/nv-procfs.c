@@ -239,6 +239,71 @@ nv_procfs_read_version(
 
 NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(version);
 
+static int
+nv_procfs_read_sysmem_pools(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_mem_pool_procfs_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(sysmem_pools);
+
+static int
+nv_procfs_read_mmap_stats(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_mmap_procfs_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(mmap_stats);
+
+static int
+nv_procfs_read_dma_stats(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_dma_procfs_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(dma_stats);
+
+static int
+nv_procfs_read_pin_stats(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_pin_procfs_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(pin_stats);
+
+static int
+nv_procfs_read_p2p_cache(
+    struct seq_file *s,
+    void *v
+)
+{
+    nv_p2p_procfs_print(s);
+
+    return 0;
+}
+
+NV_DEFINE_SINGLE_NVRM_PROCFS_FILE(p2p_cache);
+
 static void
 nv_procfs_close_file(
     nv_procfs_private_t *nvpp
@@ -1364,6 +1429,26 @@ int nv_procfs_init(void)
     if (!entry)
         goto failed;
 
+    entry = NV_CREATE_PROC_FILE("sysmem_pools", proc_nvidia, sysmem_pools, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("mmap_stats", proc_nvidia, mmap_stats, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("dma_stats", proc_nvidia, dma_stats, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("pin_stats", proc_nvidia, pin_stats, NULL);
+    if (!entry)
+        goto failed;
+
+    entry = NV_CREATE_PROC_FILE("p2p_cache", proc_nvidia, p2p_cache, NULL);
+    if (!entry)
+        goto failed;
+
     proc_nvidia_gpus = NV_CREATE_PROC_DIR("gpus", proc_nvidia);
     if (!proc_nvidia_gpus)
         goto failed;
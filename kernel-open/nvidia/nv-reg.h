@@ -974,6 +974,42 @@
 #define NV_ENABLE_SYSTEM_MEMORY_POOLS_DEFAULT 0x00000211
 #define NV_ENABLE_SYSTEM_MEMORY_POOLS_SHIFT 12
 
+/*
+ * Option: NVreg_SystemMemoryPoolPrefillMB
+ *
+ * Description:
+ *
+ * This option controls how much memory, in megabytes, each enabled system
+ * memory page pool keeps allocated and zeroed ahead of time on its NUMA node
+ * Once allocations drain a pool below half of this amount, a background
+ * worker refills it back up, so that large allocations can be served from
+ * already cleared pages instead of allocating and clearing them inline
+ * Pools are still trimmed by the kernel shrinker under memory pressure
+ *
+ * This feature is only supported by OpenRM driver
+ *
+ * By default this is 0 and pools only hold memory returned by frees
+ */
+#define __NV_SYSTEM_MEMORY_POOL_PREFILL_MB SystemMemoryPoolPrefillMB
+#define NV_SYSTEM_MEMORY_POOL_PREFILL_MB NV_REG_STRING(__NV_SYSTEM_MEMORY_POOL_PREFILL_MB)
+
+/*
+ * Option: NVreg_PinUserPagesThreads
+ *
+ * Description:
+ *
+ * This option sets the number of kernel threads used to pin large user memory
+ * ranges, e.g. for host memory registration. Requests of 1 GB or more are
+ * split into 256 MB chunks that are pinned concurrently by these threads
+ *
+ * This feature is only supported by OpenRM driver on kernels providing
+ * pin_user_pages_remote()
+ *
+ * By default this is 0 and user memory is always pinned by the calling thread
+ */
+#define __NV_PIN_USER_PAGES_THREADS PinUserPagesThreads
+#define NV_PIN_USER_PAGES_THREADS NV_REG_STRING(__NV_PIN_USER_PAGES_THREADS)
+
 #if defined(NV_DEFINE_REGISTRY_KEY_TABLE)
 
 /*
@@ -1030,6 +1066,8 @@ NV_DEFINE_REG_ENTRY_GLOBAL(__NV_CREATE_IMEX_CHANNEL_0, 0);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_GRDMA_PCI_TOPO_CHECK_OVERRIDE,
                            NV_REG_GRDMA_PCI_TOPO_CHECK_OVERRIDE_DEFAULT);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_ENABLE_SYSTEM_MEMORY_POOLS, NV_ENABLE_SYSTEM_MEMORY_POOLS_DEFAULT);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_SYSTEM_MEMORY_POOL_PREFILL_MB, 0);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_PIN_USER_PAGES_THREADS, 0);
 
 /*
  *----------------registry database definition----------------------
@@ -1081,6 +1119,8 @@ nv_parm_t nv_parms[] = {
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_CREATE_IMEX_CHANNEL_0),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_GRDMA_PCI_TOPO_CHECK_OVERRIDE),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_ENABLE_SYSTEM_MEMORY_POOLS),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_SYSTEM_MEMORY_POOL_PREFILL_MB),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_PIN_USER_PAGES_THREADS),
     {NULL, NULL}
 };
 
@@ -25,8 +25,10 @@
 #include "nv.h"
 #include "nv-linux.h"
 #include "nv-reg.h"
+#include "nv-procfs.h"
 
 extern NvU32 NVreg_EnableSystemMemoryPools;
+extern NvU32 NVreg_SystemMemoryPoolPrefillMB;
 
 static inline void nv_set_contig_memory_uc(nvidia_pte_t *page_ptr, NvU32 num_pages)
 {
@@ -399,6 +401,21 @@ typedef struct nv_page_pool_t
     int node_id;
     unsigned int order;
     unsigned long pages_owned;
+
+    // Refill thresholds in pool pages, both 0 if prefill is disabled. The
+    // scrubber tops the pool back up to high_watermark with freshly cleared
+    // pages once an allocation leaves fewer than low_watermark pages.
+    unsigned long low_watermark;
+    unsigned long high_watermark;
+
+    // Statistics, in pool pages
+    unsigned long pages_allocated_clean;
+    unsigned long pages_allocated_dirty;
+    unsigned long pages_refilled;
+
+    // Set by nv_mem_pool_destroy() to stop a refill in progress
+    NvBool shutting_down;
+
     void *lock;
     struct shrinker *shrinker;
 
@@ -409,6 +426,16 @@ typedef struct nv_page_pool_t
 
 nv_page_pool_t *sysmem_page_pools[MAX_NUMNODES][NV_MAX_PAGE_ORDER + 1];
 
+// Protects sysmem_page_pools against procfs readers during init and teardown
+static DECLARE_RWSEM(sysmem_page_pools_lock);
+
+// Latency histogram of nv_alloc_system_pages() per page order. Bucket 0 counts
+// allocations that took less than 1us, bucket i > 0 the ones that took
+// [2^(i - 1), 2^i) us, and the last bucket everything slower.
+#define NV_MEM_POOL_LATENCY_BUCKETS 20
+
+static atomic64_t sysmem_alloc_latency[NV_MAX_PAGE_ORDER + 1][NV_MEM_POOL_LATENCY_BUCKETS];
+
 #ifdef NV_SHRINKER_ALLOC_PRESENT
 static nv_page_pool_t *nv_mem_pool_get_from_shrinker(struct shrinker *shrinker)
 {
@@ -581,6 +608,13 @@ nv_mem_pool_clear_page(unsigned long virt_addr, unsigned int order)
     }
 }
 
+static void
+nv_mem_pool_queue_worker(nv_page_pool_t *mem_pool)
+{
+    nv_kthread_q_schedule_q_item(&mem_pool->scrubber_queue,
+                                 &mem_pool->scrubber_queue_item);
+}
+
 unsigned int
 nv_mem_pool_alloc_pages
 (
@@ -598,6 +632,7 @@ nv_mem_pool_alloc_pages
     unsigned int i = 0;
     struct list_head alloc_clean_pages;
     struct list_head alloc_dirty_pages;
+    NvBool queue_refill;
     NV_STATUS status;
 
     if (!NV_MAY_SLEEP())
@@ -616,9 +651,17 @@ nv_mem_pool_alloc_pages
     pages_remaining = nv_mem_pool_move_pages(&alloc_dirty_pages, &mem_pool->dirty_list, pages_remaining);
     pages_allocated = (max_num_pages - pages_remaining);
     mem_pool->pages_owned -= pages_allocated;
+    mem_pool->pages_allocated_clean += pages_allocated_clean;
+    mem_pool->pages_allocated_dirty += pages_allocated - pages_allocated_clean;
     pages_owned = mem_pool->pages_owned;
+    queue_refill = (pages_owned < mem_pool->low_watermark);
     os_release_mutex(mem_pool->lock);
 
+    if (queue_refill)
+    {
+        nv_mem_pool_queue_worker(mem_pool);
+    }
+
     while ((pool_entry = NV_MEM_POOL_LIST_HEAD(&alloc_clean_pages)))
     {
         nv_alloc_set_page(at, i, pool_entry->virt_addr);
@@ -650,11 +693,67 @@ nv_mem_pool_alloc_pages
     return pages_allocated;
 }
 
+//
+// Allocate and clear pages on the pool's node until the pool holds
+// high_watermark pages. Gives up at the first allocation failure: the refill
+// is only opportunistic and must not push the node into reclaim, which would
+// just have the shrinker hand the pages back.
+//
 static void
-nv_mem_pool_queue_worker(nv_page_pool_t *mem_pool)
+nv_mem_pool_refill(nv_page_pool_t *mem_pool)
 {
-    nv_kthread_q_schedule_q_item(&mem_pool->scrubber_queue,
-                                 &mem_pool->scrubber_queue_item);
+    unsigned int gfp_mask = NV_GFP_KERNEL | __GFP_THISNODE | __GFP_NORETRY | __GFP_NOWARN;
+    nv_page_pool_entry_t *pool_entry;
+    unsigned long pages_refilled = 0;
+    unsigned long pages_owned;
+    NvBool shutting_down;
+    NV_STATUS status;
+
+    if (mem_pool->order > 0)
+        gfp_mask |= __GFP_COMP;
+
+    for (;;)
+    {
+        unsigned long ptr = 0;
+
+        status = os_acquire_mutex(mem_pool->lock);
+        WARN_ON(status != NV_OK);
+        pages_owned = mem_pool->pages_owned;
+        shutting_down = mem_pool->shutting_down;
+        os_release_mutex(mem_pool->lock);
+
+        if (shutting_down || (pages_owned >= mem_pool->high_watermark))
+            break;
+
+        NV_KZALLOC(pool_entry, sizeof(*pool_entry));
+        if (pool_entry == NULL)
+            break;
+
+        NV_ALLOC_PAGES_NODE(ptr, mem_pool->node_id, mem_pool->order, gfp_mask);
+        if (ptr == 0)
+        {
+            NV_KFREE(pool_entry, sizeof(*pool_entry));
+            break;
+        }
+
+        pool_entry->virt_addr = (unsigned long)page_address((void *)ptr);
+        nv_mem_pool_clear_page(pool_entry->virt_addr, mem_pool->order);
+
+        status = os_acquire_mutex(mem_pool->lock);
+        WARN_ON(status != NV_OK);
+        list_add(&pool_entry->list_node, &mem_pool->clean_list);
+        mem_pool->pages_owned++;
+        mem_pool->pages_refilled++;
+        os_release_mutex(mem_pool->lock);
+
+        pages_refilled++;
+    }
+
+    if (pages_refilled != 0)
+    {
+        nv_printf(NV_DBG_MEMINFO, "NVRM: VM: %s: node=%d order=%u: %lu pages refilled (%lu now in pool)\n",
+                  __FUNCTION__, mem_pool->node_id, mem_pool->order, pages_refilled, pages_owned);
+    }
 }
 
 static void
@@ -685,6 +784,11 @@ nv_mem_pool_worker(void *arg)
 
         nv_mem_pool_clear_page(pool_entry->virt_addr, mem_pool->order);
     }
+
+    if (mem_pool->high_watermark != 0)
+    {
+        nv_mem_pool_refill(mem_pool);
+    }
 }
 
 void
@@ -694,10 +798,12 @@ nv_mem_pool_destroy(nv_page_pool_t *mem_pool)
 
     status = os_acquire_mutex(mem_pool->lock);
     WARN_ON(status != NV_OK);
+    mem_pool->shutting_down = NV_TRUE;
     nv_mem_pool_free_page_list(&mem_pool->dirty_list, mem_pool->order);
     os_release_mutex(mem_pool->lock);
 
-    // All pages are freed, so scrubber won't attempt to requeue
+    // All pages are freed and a pending refill bails out at its next page, so
+    // scrubber won't attempt to requeue
     nv_kthread_q_stop(&mem_pool->scrubber_queue);
 
     status = os_acquire_mutex(mem_pool->lock);
@@ -717,6 +823,7 @@ nv_page_pool_t* nv_mem_pool_init(int node_id, unsigned int order)
 {
     struct shrinker *shrinker;
     nv_page_pool_t *mem_pool;
+    unsigned long prefill_pages;
 
     NV_KZALLOC(mem_pool, sizeof(*mem_pool));
     if (mem_pool == NULL)
@@ -728,6 +835,10 @@ nv_page_pool_t* nv_mem_pool_init(int node_id, unsigned int order)
     mem_pool->node_id = node_id;
     mem_pool->order = order;
 
+    prefill_pages = ((NvU64)NVreg_SystemMemoryPoolPrefillMB << 20) >> (PAGE_SHIFT + order);
+    mem_pool->high_watermark = prefill_pages;
+    mem_pool->low_watermark = prefill_pages / 2;
+
     INIT_LIST_HEAD(&mem_pool->clean_list);
     INIT_LIST_HEAD(&mem_pool->dirty_list);
 
@@ -759,6 +870,13 @@ nv_page_pool_t* nv_mem_pool_init(int node_id, unsigned int order)
      nv_mem_pool_shrinker_register(mem_pool, shrinker);
 
      mem_pool->shrinker = shrinker;
+
+    if (mem_pool->high_watermark != 0)
+    {
+        // Prefill in the background, module load shouldn't wait for it
+        nv_mem_pool_queue_worker(mem_pool);
+    }
+
      return mem_pool;
 
 failed:
@@ -845,9 +963,12 @@ nv_mem_pool_free_pages
 
 NV_STATUS nv_init_page_pools(void)
 {
+    NV_STATUS status = NV_OK;
     int node_id;
     unsigned int order;
 
+    down_write(&sysmem_page_pools_lock);
+
     for_each_node(node_id)
     {
         for (order = 0; order <= NV_MAX_PAGE_ORDER; order++)
@@ -861,12 +982,16 @@ NV_STATUS nv_init_page_pools(void)
 
             if (sysmem_page_pools[node_id][order] == NULL)
             {
-                return NV_ERR_NO_MEMORY;
+                status = NV_ERR_NO_MEMORY;
+                goto done;
             }
         }
     }
 
-    return NV_OK;
+done:
+    up_write(&sysmem_page_pools_lock);
+
+    return status;
 }
 
 void nv_destroy_page_pools(void)
@@ -874,15 +999,101 @@ void nv_destroy_page_pools(void)
     int node_id;
     unsigned int order;
 
+    down_write(&sysmem_page_pools_lock);
+
     for_each_node(node_id)
     {
         for (order = 0; order <= NV_MAX_PAGE_ORDER; order++)
         {
             if (sysmem_page_pools[node_id][order])
                 nv_mem_pool_destroy(sysmem_page_pools[node_id][order]);
+
+            sysmem_page_pools[node_id][order] = NULL;
+        }
+    }
+
+    up_write(&sysmem_page_pools_lock);
+}
+
+static void
+nv_mem_pool_record_alloc_latency(unsigned int order, NvU64 elapsed_ns)
+{
+    unsigned int bucket = fls64(elapsed_ns / NSEC_PER_USEC);
+
+    if (order > NV_MAX_PAGE_ORDER)
+        return;
+
+    bucket = NV_MIN(bucket, NV_MEM_POOL_LATENCY_BUCKETS - 1);
+    atomic64_inc(&sysmem_alloc_latency[order][bucket]);
+}
+
+#if defined(CONFIG_PROC_FS)
+void nv_mem_pool_procfs_print(struct seq_file *s)
+{
+    int node_id;
+    unsigned int order;
+    unsigned int i;
+
+    down_read(&sysmem_page_pools_lock);
+
+    for_each_node(node_id)
+    {
+        for (order = 0; order <= NV_MAX_PAGE_ORDER; order++)
+        {
+            nv_page_pool_t *mem_pool = sysmem_page_pools[node_id][order];
+            unsigned long pages_owned;
+            unsigned long pages_allocated_clean;
+            unsigned long pages_allocated_dirty;
+            unsigned long pages_refilled;
+
+            if (mem_pool == NULL)
+                continue;
+
+            if (os_acquire_mutex(mem_pool->lock) != NV_OK)
+                continue;
+            pages_owned = mem_pool->pages_owned;
+            pages_allocated_clean = mem_pool->pages_allocated_clean;
+            pages_allocated_dirty = mem_pool->pages_allocated_dirty;
+            pages_refilled = mem_pool->pages_refilled;
+            os_release_mutex(mem_pool->lock);
+
+            seq_printf(s, "Node %d, %lu KB pages:\n", node_id, (PAGE_SIZE << order) >> 10);
+            seq_printf(s, "    Pages in pool:        %lu\n", pages_owned);
+            seq_printf(s, "    Watermarks:           %lu/%lu\n",
+                       mem_pool->low_watermark, mem_pool->high_watermark);
+            seq_printf(s, "    Allocated clean:      %lu\n", pages_allocated_clean);
+            seq_printf(s, "    Allocated dirty:      %lu\n", pages_allocated_dirty);
+            seq_printf(s, "    Refilled:             %lu\n", pages_refilled);
+        }
+    }
+
+    up_read(&sysmem_page_pools_lock);
+
+    for (order = 0; order <= NV_MAX_PAGE_ORDER; order++)
+    {
+        NvBool header_printed = NV_FALSE;
+
+        for (i = 0; i < NV_MEM_POOL_LATENCY_BUCKETS; i++)
+        {
+            NvU64 count = atomic64_read(&sysmem_alloc_latency[order][i]);
+
+            if (count == 0)
+                continue;
+
+            if (!header_printed)
+            {
+                seq_printf(s, "Allocation latency, %lu KB pages:\n", (PAGE_SIZE << order) >> 10);
+                header_printed = NV_TRUE;
+            }
+
+            if (i == NV_MEM_POOL_LATENCY_BUCKETS - 1)
+                seq_printf(s, "    >= %llu us: %llu\n", 1ULL << (i - 1), count);
+            else
+                seq_printf(s, "    < %llu us: %llu\n", 1ULL << i, count);
         }
     }
 }
+#endif
 
 static nv_page_pool_t *nv_mem_pool_get(int node_id, unsigned int order)
 {
@@ -974,6 +1185,7 @@ nv_alloc_system_pages
     // OS allocator tries CPU node first by default, mirror that
     int preferred_node_id = at->flags.node ? at->node_id : numa_mem_id();
     nv_page_pool_t *page_pool = nv_mem_pool_get(preferred_node_id, at->order);
+    NvU64 start_ns = nv_ktime_get_raw_ns();
 
     // Remember if pool allocation was attempted and use it on free to avoid hoarding memory
     // Avoid unwanted scrubbing, especially important for onlined FB
@@ -1033,6 +1245,8 @@ nv_alloc_system_pages
         nv_set_memory_type(at, NV_MEMORY_UNCACHED);
     }
 
+    nv_mem_pool_record_alloc_latency(at->order, nv_ktime_get_raw_ns() - start_ns);
+
     return NV_OK;
 
 failed:
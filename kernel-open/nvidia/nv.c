@@ -246,6 +246,9 @@ static struct file_operations nvidia_fops = {
     .compat_ioctl = nvidia_unlocked_ioctl,
 #endif
     .mmap      = nvidia_mmap,
+#if defined(CONFIG_ARCH_SUPPORTS_PMD_PFNMAP)
+    .get_unmapped_area = nvidia_get_unmapped_area,
+#endif
     .open      = nvidia_open,
     .release   = nvidia_close,
 };
@@ -530,6 +533,8 @@ nvlink_drivers_init(void)
 
 int nv_init_page_pools(void);
 void nv_destroy_page_pools(void);
+int nv_init_pin_workers(void);
+void nv_destroy_pin_workers(void);
 
 static void
 nv_module_state_exit(nv_stack_t *sp)
@@ -540,6 +545,7 @@ nv_module_state_exit(nv_stack_t *sp)
 
     nv_kthread_q_stop(&nv_deferred_close_kthread_q);
     nv_kthread_q_stop(&nv_kthread_q);
+    nv_destroy_pin_workers();
 
     nv_destroy_page_pools();
 
@@ -586,6 +592,9 @@ nv_module_state_init(nv_stack_t *sp)
         goto exit;
     }
 
+    // Falls back to pinning from the calling thread on failure
+    nv_init_pin_workers();
+
     nv_linux_devices = NULL;
     memset(nv_linux_minor_num_table, 0, sizeof(nv_linux_minor_num_table));
     NV_INIT_MUTEX(&nv_linux_devices_lock);
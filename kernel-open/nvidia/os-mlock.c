@@ -25,6 +25,9 @@
 
 #include "os-interface.h"
 #include "nv-linux.h"
+#include "nv-procfs.h"
+
+extern NvU32 NVreg_PinUserPagesThreads;
 
 #if defined(NVCPU_FAMILY_X86) && defined(NV_FOLL_LONGTERM_PRESENT) && \
     (defined(NV_PIN_USER_PAGES_HAS_ARGS_VMAS) ||                      \
@@ -213,6 +216,231 @@ done:
     return rmStatus;
 }
 
+/*
+ * Parallel pinning of large user memory ranges.
+ *
+ * With NVreg_PinUserPagesThreads set, os_lock_user_pages() splits requests of
+ * at least NV_PIN_PARALLEL_MIN_SIZE into NV_PIN_CHUNK_SIZE chunks, pinned by a
+ * pool of workers with pin_user_pages_remote() on the caller's mm. Every
+ * worker takes the mmap lock for reading around its own chunk, so the chunks
+ * are pinned concurrently, and the caller waits for all of them before
+ * returning, which keeps the mm alive for the workers.
+ */
+#if defined(NV_PIN_USER_PAGES_REMOTE_PRESENT)
+#define NV_PIN_PARALLEL_SUPPORTED 1
+#else
+#define NV_PIN_PARALLEL_SUPPORTED 0
+#endif
+
+#define NV_PIN_CHUNK_SIZE           (256ULL << 20)
+#define NV_PIN_PARALLEL_MIN_SIZE    (4 * NV_PIN_CHUNK_SIZE)
+
+typedef struct
+{
+    struct mm_struct *mm;
+    unsigned int gup_flags;
+    atomic_t chunks_remaining;
+    struct completion done;
+} nv_pin_request_t;
+
+typedef struct
+{
+    nv_kthread_q_item_t q_item;
+    nv_pin_request_t *request;
+    unsigned long start;
+    struct page **pages;
+    NvU64 page_count;
+    NvU64 pinned;
+    NvU64 pin_time_ns;
+} nv_pin_chunk_t;
+
+static nv_kthread_mq_t nv_pin_mq;
+static NvBool nv_pin_mq_initialized;
+static unsigned int nv_pin_num_workers;
+
+// Statistics exposed through procfs, in nanoseconds where applicable
+static struct
+{
+    atomic64_t requests;
+    atomic64_t pages;
+    atomic64_t time_ns;
+    atomic64_t parallel_requests;
+    atomic64_t parallel_pages;
+    atomic64_t parallel_time_ns;
+    atomic64_t chunks;
+    atomic64_t chunk_time_ns;
+} nv_pin_stats;
+
+int nv_init_pin_workers(void)
+{
+    int rc;
+
+    if (!NV_PIN_PARALLEL_SUPPORTED || (NVreg_PinUserPagesThreads == 0))
+        return 0;
+
+    nv_pin_num_workers = NV_MIN(NVreg_PinUserPagesThreads, NV_KTHREAD_MQ_MAX_WORKERS);
+
+    rc = nv_kthread_mq_init(&nv_pin_mq, "nv_pin_mq", nv_pin_num_workers);
+    if (rc != 0)
+    {
+        nv_printf(NV_DBG_ERRORS,
+                  "NVRM: failed to start user page pinning threads, "
+                  "falling back to pinning from the calling thread.\n");
+        nv_kthread_mq_stop(&nv_pin_mq);
+        return 0;
+    }
+
+    nv_pin_mq_initialized = NV_TRUE;
+
+    return 0;
+}
+
+void nv_destroy_pin_workers(void)
+{
+    if (nv_pin_mq_initialized)
+    {
+        nv_pin_mq_initialized = NV_FALSE;
+        nv_kthread_mq_stop(&nv_pin_mq);
+    }
+}
+
+#if defined(CONFIG_PROC_FS)
+void nv_pin_procfs_print(struct seq_file *s)
+{
+    seq_printf(s, "Pinning threads:       %u\n",
+               nv_pin_mq_initialized ? nv_pin_num_workers : 0);
+    seq_printf(s, "Requests:              %lld\n",
+               (long long)atomic64_read(&nv_pin_stats.requests));
+    seq_printf(s, "Pages:                 %lld\n",
+               (long long)atomic64_read(&nv_pin_stats.pages));
+    seq_printf(s, "Time (us):             %lld\n",
+               (long long)(atomic64_read(&nv_pin_stats.time_ns) / NSEC_PER_USEC));
+    seq_printf(s, "Parallel requests:     %lld\n",
+               (long long)atomic64_read(&nv_pin_stats.parallel_requests));
+    seq_printf(s, "Parallel pages:        %lld\n",
+               (long long)atomic64_read(&nv_pin_stats.parallel_pages));
+    seq_printf(s, "Parallel time (us):    %lld\n",
+               (long long)(atomic64_read(&nv_pin_stats.parallel_time_ns) / NSEC_PER_USEC));
+    seq_printf(s, "Chunks:                %lld\n",
+               (long long)atomic64_read(&nv_pin_stats.chunks));
+    seq_printf(s, "Chunk pin time (us):   %lld\n",
+               (long long)(atomic64_read(&nv_pin_stats.chunk_time_ns) / NSEC_PER_USEC));
+
+    if (nv_pin_mq_initialized)
+    {
+        nv_kthread_mq_stats_t mq_stats;
+
+        nv_kthread_mq_get_stats(&nv_pin_mq, &mq_stats);
+
+        seq_printf(s, "Chunk queue time (us): %llu\n",
+                   mq_stats.total_latency_ns / NSEC_PER_USEC);
+        seq_printf(s, "Max chunk queue time (us): %llu\n",
+                   mq_stats.max_latency_ns / NSEC_PER_USEC);
+    }
+}
+#endif
+
+#if NV_PIN_PARALLEL_SUPPORTED
+static void nv_pin_chunk_worker(void *args)
+{
+    nv_pin_chunk_t *chunk = args;
+    nv_pin_request_t *request = chunk->request;
+    NvU64 start_ns = nv_ktime_get_raw_ns();
+    long ret;
+
+    nv_mmap_read_lock(request->mm);
+
+    // pin_user_pages_remote() may pin fewer pages than requested
+    while (chunk->pinned < chunk->page_count)
+    {
+        ret = NV_PIN_USER_PAGES_REMOTE(request->mm,
+                                       chunk->start + (chunk->pinned << PAGE_SHIFT),
+                                       chunk->page_count - chunk->pinned,
+                                       request->gup_flags,
+                                       &chunk->pages[chunk->pinned],
+                                       NULL);
+        if (ret <= 0)
+            break;
+
+        chunk->pinned += ret;
+    }
+
+    nv_mmap_read_unlock(request->mm);
+
+    chunk->pin_time_ns = nv_ktime_get_raw_ns() - start_ns;
+
+    if (atomic_dec_and_test(&request->chunks_remaining))
+        complete(&request->done);
+}
+
+//
+// Pin page_count pages at address into user_pages using the pinning workers.
+// On failure, no page is left pinned.
+//
+static NV_STATUS nv_lock_user_pages_parallel(
+    NvUPtr address,
+    NvU64 page_count,
+    unsigned int gup_flags,
+    struct page **user_pages
+)
+{
+    NvU64 chunk_pages = NV_PIN_CHUNK_SIZE >> PAGE_SHIFT;
+    NvU64 num_chunks = NV_CEIL(page_count, chunk_pages);
+    nv_pin_chunk_t *chunks;
+    nv_pin_request_t request;
+    NV_STATUS status;
+    NvU64 i, j;
+
+    status = os_alloc_mem((void **)&chunks, num_chunks * sizeof(*chunks));
+    if (status != NV_OK)
+        return status;
+
+    request.mm = current->mm;
+    request.gup_flags = gup_flags;
+    atomic_set(&request.chunks_remaining, num_chunks);
+    init_completion(&request.done);
+
+    for (i = 0; i < num_chunks; i++)
+    {
+        nv_pin_chunk_t *chunk = &chunks[i];
+
+        chunk->request = &request;
+        chunk->start = address + ((i * chunk_pages) << PAGE_SHIFT);
+        chunk->pages = &user_pages[i * chunk_pages];
+        chunk->page_count = NV_MIN(chunk_pages, page_count - i * chunk_pages);
+        chunk->pinned = 0;
+        chunk->pin_time_ns = 0;
+
+        nv_kthread_q_item_init(&chunk->q_item, nv_pin_chunk_worker, chunk);
+        nv_kthread_mq_schedule_q_item(&nv_pin_mq, &chunk->q_item);
+    }
+
+    wait_for_completion(&request.done);
+
+    for (i = 0; i < num_chunks; i++)
+    {
+        if (chunks[i].pinned != chunks[i].page_count)
+            status = NV_ERR_INVALID_ADDRESS;
+
+        atomic64_add(chunks[i].pin_time_ns, &nv_pin_stats.chunk_time_ns);
+    }
+    atomic64_add(num_chunks, &nv_pin_stats.chunks);
+
+    if (status != NV_OK)
+    {
+        for (i = 0; i < num_chunks; i++)
+        {
+            for (j = 0; j < chunks[i].pinned; j++)
+                NV_UNPIN_USER_PAGE(chunks[i].pages[j]);
+        }
+    }
+
+    os_free_mem(chunks);
+
+    return status;
+}
+#endif // NV_PIN_PARALLEL_SUPPORTED
+
 NV_STATUS NV_API_CALL os_lock_user_pages(
     void   *address,
     NvU64   page_count,
@@ -227,6 +455,7 @@ NV_STATUS NV_API_CALL os_lock_user_pages(
     NvU64 npages = page_count;
     NvU64 pinned = 0;
     unsigned int gup_flags = DRF_VAL(_LOCK_USER_PAGES, _FLAGS, _WRITE, flags) ? FOLL_WRITE : 0;
+    NvU64 start_ns = nv_ktime_get_raw_ns();
     long ret;
 
 #if defined(NVCPU_FAMILY_X86) && defined(NV_FOLL_LONGTERM_PRESENT)
@@ -249,6 +478,28 @@ NV_STATUS NV_API_CALL os_lock_user_pages(
         return rmStatus;
     }
 
+#if NV_PIN_PARALLEL_SUPPORTED
+    if (nv_pin_mq_initialized &&
+        ((page_count << PAGE_SHIFT) >= NV_PIN_PARALLEL_MIN_SIZE))
+    {
+        rmStatus = nv_lock_user_pages_parallel((NvUPtr)address, page_count,
+                                               gup_flags, user_pages);
+        if (rmStatus != NV_OK)
+        {
+            os_free_mem(user_pages);
+            return rmStatus;
+        }
+
+        atomic64_inc(&nv_pin_stats.parallel_requests);
+        atomic64_add(page_count, &nv_pin_stats.parallel_pages);
+        atomic64_add(nv_ktime_get_raw_ns() - start_ns, &nv_pin_stats.parallel_time_ns);
+
+        *page_array = user_pages;
+
+        return NV_OK;
+    }
+#endif
+
     nv_mmap_read_lock(mm);
     ret = NV_PIN_USER_PAGES((unsigned long)address,
                             npages, gup_flags, user_pages);
@@ -303,6 +554,10 @@ NV_STATUS NV_API_CALL os_lock_user_pages(
         return NV_ERR_INVALID_ADDRESS;
     }
 
+    atomic64_inc(&nv_pin_stats.requests);
+    atomic64_add(page_count, &nv_pin_stats.pages);
+    atomic64_add(nv_ktime_get_raw_ns() - start_ns, &nv_pin_stats.time_ns);
+
     *page_array = user_pages;
 
     return NV_OK;
@@ -124,28 +124,217 @@ nvlink_core_discover_and_get_remote_end
     }
 }
 
+//
+// Index of the registered links used by topology discovery to find the
+// remote end of a link in constant time, rather than by scanning every
+// registered link for every link.
+//
+// Links are looked up either by (localSid, linkNumber), to match the
+// (remoteSid, remoteLinkId) of the other end, or by the discovery token
+// read from their RX sublink. The index is an open-addressed hash table
+// sized to at least twice the number of entries.
+//
+typedef struct
+{
+    NvU64        key0;
+    NvU32        key1;
+    nvlink_link *link;
+} nvlink_discovery_index_entry;
+
+typedef struct
+{
+    nvlink_discovery_index_entry *entries;
+    NvU32                         mask;
+} nvlink_discovery_index;
+
+static NvBool
+_nvlink_core_discovery_index_init
+(
+    nvlink_discovery_index *index,
+    NvU32                   numEntries
+)
+{
+    NvU32 size = 16;
+
+    while (size < 2 * numEntries)
+    {
+        size <<= 1;
+    }
+
+    index->entries = (nvlink_discovery_index_entry *)
+                     nvlink_malloc(sizeof(*index->entries) * size);
+    if (index->entries == NULL)
+    {
+        return NV_FALSE;
+    }
+
+    nvlink_memset(index->entries, 0, sizeof(*index->entries) * size);
+    index->mask = size - 1;
+
+    return NV_TRUE;
+}
+
+static void
+_nvlink_core_discovery_index_destroy
+(
+    nvlink_discovery_index *index
+)
+{
+    if (index->entries != NULL)
+    {
+        nvlink_free((void *)index->entries);
+        index->entries = NULL;
+    }
+}
+
+static NvU32
+_nvlink_core_discovery_index_hash
+(
+    NvU64 key0,
+    NvU32 key1
+)
+{
+    NvU64 h = key0 ^ ((NvU64)key1 * 0x9E3779B97F4A7C15ULL);
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+
+    return (NvU32)h;
+}
+
+//
+// Add a link to the index. If another link was already added with the same
+// key, the first one is kept, which matches the registration order the
+// pairwise scan used to pick the first match in.
+//
+static void
+_nvlink_core_discovery_index_add
+(
+    nvlink_discovery_index *index,
+    NvU64                   key0,
+    NvU32                   key1,
+    nvlink_link            *link
+)
+{
+    NvU32 i = _nvlink_core_discovery_index_hash(key0, key1) & index->mask;
+
+    while (index->entries[i].link != NULL)
+    {
+        if ((index->entries[i].key0 == key0) &&
+            (index->entries[i].key1 == key1))
+        {
+            return;
+        }
+
+        i = (i + 1) & index->mask;
+    }
+
+    index->entries[i].key0 = key0;
+    index->entries[i].key1 = key1;
+    index->entries[i].link = link;
+}
+
+static nvlink_link *
+_nvlink_core_discovery_index_find
+(
+    nvlink_discovery_index *index,
+    NvU64                   key0,
+    NvU32                   key1
+)
+{
+    NvU32 i = _nvlink_core_discovery_index_hash(key0, key1) & index->mask;
+
+    while (index->entries[i].link != NULL)
+    {
+        if ((index->entries[i].key0 == key0) &&
+            (index->entries[i].key1 == key1))
+        {
+            return index->entries[i].link;
+        }
+
+        i = (i + 1) & index->mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * Whether the link is discovered through the SIDs reported by minion
+ * (NVLink 3.0+) rather than by injecting an AN0 packet with its token
+ *
+ * @param[in]  link  NVLink Link pointer
+ */
+static NvBool
+_nvlink_core_link_uses_sid_discovery
+(
+    nvlink_link *link
+)
+{
+    return ((link->version >= NVLINK_DEVICE_VERSION_30) &&
+            (link->localSid != 0) && (link->remoteSid != 0));
+}
+
 /**
  * Discovery process to determine topology
  *
  *    Involves sending and reading back AN0 packets/SID values
+ *
+ *    This runs in three passes:
+ *      1. Pick the links whose remote end is to be discovered and send the
+ *         AN0 packet on the ones that use token based discovery.
+ *      2. Index all candidate remote ends by (localSid, linkNumber) and, if
+ *         any AN0 packets were sent, by the token read back from their RX
+ *         sublink. Each RX sublink is read only once.
+ *      3. Look up the remote end of each link picked in pass 1.
+ *
+ *    Unlike a serial discovery, pass 1 also sends the AN0 packet on links
+ *    that turn out to be the remote end of another link picked in the same
+ *    pass. Packet injection retries are therefore only counted once pass 3
+ *    is done, for the links still left without a connection.
  */
 static void
 _nvlink_core_discover_topology(void)
 {
-    nvlink_device         *dev0         = NULL;
-    nvlink_device         *dev1         = NULL;
-    nvlink_link           *end0         = NULL;
-    nvlink_link           *end1         = NULL;
-    nvlink_intranode_conn *conn         = NULL;
-    NvU64                  linkMode     = NVLINK_LINKSTATE_OFF;
-    NvBool                 isTokenFound = NV_FALSE;
-    NvU64                  token        = 0;
+    nvlink_device          *dev          = NULL;
+    nvlink_link            *end0         = NULL;
+    nvlink_link            *end1         = NULL;
+    nvlink_intranode_conn  *conn         = NULL;
+    nvlink_link           **pEnds        = NULL;
+    nvlink_discovery_index  sidIndex     = { 0 };
+    nvlink_discovery_index  tokenIndex   = { 0 };
+    NvU64                   linkMode     = NVLINK_LINKSTATE_OFF;
+    NvU64                   token        = 0;
+    NvU32                   numEnds      = 0;
+    NvU32                   numTokenEnds = 0;
+    NvU32                   numLinks     = 0;
+    NvU32                   i;
 
     nvlinkLibCtx.notConnectedEndpoints = 0;
 
-    FOR_EACH_DEVICE_REGISTERED(dev0, nvlinkLibCtx.nv_devicelist_head, node)
+    FOR_EACH_DEVICE_REGISTERED(dev, nvlinkLibCtx.nv_devicelist_head, node)
     {
-        FOR_EACH_LINK_REGISTERED(end0, dev0, node)
+        FOR_EACH_LINK_REGISTERED(end0, dev, node)
+        {
+            numLinks++;
+        }
+    }
+
+    pEnds = (nvlink_link **)nvlink_malloc(sizeof(nvlink_link *) * (numLinks + 1));
+    if ((pEnds == NULL) ||
+        !_nvlink_core_discovery_index_init(&sidIndex, numLinks) ||
+        !_nvlink_core_discovery_index_init(&tokenIndex, numLinks))
+    {
+        NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_ERRORS,
+            "%s: Failed to allocate the discovery index for %d links\n",
+            __FUNCTION__, numLinks));
+        goto discover_topology_exit;
+    }
+
+    // Pass 1: pick the links to discover and send the AN0 packets
+    FOR_EACH_DEVICE_REGISTERED(dev, nvlinkLibCtx.nv_devicelist_head, node)
+    {
+        FOR_EACH_LINK_REGISTERED(end0, dev, node)
         {
             //
             // If receiver detect failed for the link or if clocks could not be set
@@ -194,68 +383,87 @@ _nvlink_core_discover_topology(void)
             {
                 end0->link_handlers->write_discovery_token(end0, end0->token);
             }
-            end0->packet_injection_retries++;
-            isTokenFound = NV_FALSE;
 
-            FOR_EACH_DEVICE_REGISTERED(dev1, nvlinkLibCtx.nv_devicelist_head, node)
+            if (!_nvlink_core_link_uses_sid_discovery(end0))
             {
-                FOR_EACH_LINK_REGISTERED(end1, dev1, node)
-                {
-                    //
-                    // If receiver detect failed for the link or if clocks could not be
-                    // set up for the link, then move to next link
-                    //
-                    if (!end1->bRxDetected || end1->bTxCommonModeFail)
-                        continue;
+                numTokenEnds++;
+            }
 
-                    token = 0;
+            pEnds[numEnds++] = end0;
+        }
+    }
 
-                    if ((end0->version >= NVLINK_DEVICE_VERSION_30) &&
-                        (end0->localSid != 0) && (end0->remoteSid != 0))
-                    {
-                        if ((end0->remoteSid    == end1->localSid) &&
-                            (end0->remoteLinkId == end1->linkNumber))
-                        {
-                            // Make sure the below token check passes.
-                            token = end0->token;
-                        }
-                    }
-                    else
-                    {
-                        // Read the RX sublink for the AN0 packet
-                        end1->link_handlers->read_discovery_token(end1, (NvU64 *) &token);
-                    }
+    // Pass 2: index the candidate remote ends
+    FOR_EACH_DEVICE_REGISTERED(dev, nvlinkLibCtx.nv_devicelist_head, node)
+    {
+        FOR_EACH_LINK_REGISTERED(end1, dev, node)
+        {
+            //
+            // If receiver detect failed for the link or if clocks could not be
+            // set up for the link, then move to next link
+            //
+            if (!end1->bRxDetected || end1->bTxCommonModeFail)
+                continue;
 
-                    // If token matches, establish the connection
-                    if (token == end0->token)
-                    {
-                        isTokenFound = NV_TRUE;
-
-                        //
-                        // If R4 tokens were used for NVLink3.0+, then mark initnegotiate
-                        // passed, since ALT training won't get kicked off without it.
-                        //
-                        if ((end0->version >= NVLINK_DEVICE_VERSION_30) &&
-                            ((end0->localSid == 0) || (end0->remoteSid == 0)))
-                        {
-                            end0->bInitnegotiateConfigGood = NV_TRUE;
-                            end1->bInitnegotiateConfigGood = NV_TRUE;
-                        }
-
-                        // Add to the connections list
-                        nvlink_core_add_intranode_conn(end0, end1);
-                        break;
-                    }
-                }
+            if (end1->localSid != 0)
+            {
+                _nvlink_core_discovery_index_add(&sidIndex, end1->localSid,
+                                                 end1->linkNumber, end1);
+            }
 
-                if (isTokenFound) break;
+            if (numTokenEnds != 0)
+            {
+                // Read the RX sublink for the AN0 packet
+                token = 0;
+                end1->link_handlers->read_discovery_token(end1, (NvU64 *) &token);
+
+                if (token != 0)
+                {
+                    _nvlink_core_discovery_index_add(&tokenIndex, token, 0, end1);
+                }
             }
+        }
+    }
+
+    // Pass 3: match each link with its remote end
+    for (i = 0; i < numEnds; i++)
+    {
+        end0 = pEnds[i];
 
-            if (nvlinkLibCtx.connectedEndpoints ==
-               (nvlinkLibCtx.registeredEndpoints - nvlinkLibCtx.notConnectedEndpoints))
+        // The link may have been found as the remote end of an earlier one
+        conn = NULL;
+        nvlink_core_get_intranode_conn(end0, &conn);
+        if (conn != NULL)
+        {
+            continue;
+        }
+
+        if (_nvlink_core_link_uses_sid_discovery(end0))
+        {
+            end1 = _nvlink_core_discovery_index_find(&sidIndex, end0->remoteSid,
+                                                     end0->remoteLinkId);
+        }
+        else
+        {
+            end1 = _nvlink_core_discovery_index_find(&tokenIndex, end0->token, 0);
+        }
+
+        // If token matches, establish the connection
+        if (end1 != NULL)
+        {
+            //
+            // If R4 tokens were used for NVLink3.0+, then mark initnegotiate
+            // passed, since ALT training won't get kicked off without it.
+            //
+            if ((end0->version >= NVLINK_DEVICE_VERSION_30) &&
+                ((end0->localSid == 0) || (end0->remoteSid == 0)))
             {
-                break;
+                end0->bInitnegotiateConfigGood = NV_TRUE;
+                end1->bInitnegotiateConfigGood = NV_TRUE;
             }
+
+            // Add to the connections list
+            nvlink_core_add_intranode_conn(end0, end1);
         }
 
         if (nvlinkLibCtx.connectedEndpoints ==
@@ -264,6 +472,29 @@ _nvlink_core_discover_topology(void)
             break;
         }
     }
+
+    // Count a failed packet injection for the links still not connected
+    for (i = 0; i < numEnds; i++)
+    {
+        end0 = pEnds[i];
+
+        conn = NULL;
+        nvlink_core_get_intranode_conn(end0, &conn);
+        if (conn == NULL)
+        {
+            end0->packet_injection_retries++;
+        }
+    }
+
+discover_topology_exit:
+
+    _nvlink_core_discovery_index_destroy(&sidIndex);
+    _nvlink_core_discovery_index_destroy(&tokenIndex);
+
+    if (pEnds != NULL)
+    {
+        nvlink_free((void *)pEnds);
+    }
 }
 
 /**
@@ -369,6 +369,104 @@ nvlink_core_poll_link_state
     return NVL_SUCCESS;
 }
 
+/**
+ * Poll a group of links to reach the specified state within a single,
+ * shared timeout. Every pending link is checked on each pass, so links
+ * transitioning concurrently are waited on together rather than one after
+ * the other with a timeout each.
+ *
+ * @param[in]   links       Array of NVLink link pointers
+ * @param[in]   linkCount   Number of links in the array
+ * @param[in]   linkState   Target Link state
+ * @param[in]   timeout     Timeout shared by all the links
+ * @param[out]  linkStatus  Poll status of each link in the array
+ *
+ * return NVL_SUCCESS if all the links transitioned to the target state
+ */
+NvlStatus
+nvlink_core_poll_links_state
+(
+    nvlink_link **links,
+    NvU32         linkCount,
+    NvU64         linkState,
+    NvU32         timeout,
+    NvlStatus    *linkStatus
+)
+{
+    NvlStatus status           = NVL_SUCCESS;
+    NvU64     currentLinkState = ~0;
+    NvU32     pending;
+    NvU32     i;
+
+    if ((links == NULL) || (linkStatus == NULL))
+    {
+        return NVL_BAD_ARGS;
+    }
+
+    for (i = 0; i < linkCount; i++)
+    {
+        linkStatus[i] = NVL_MORE_PROCESSING_REQUIRED;
+
+        if (links[i] == NULL)
+        {
+            linkStatus[i] = NVL_SUCCESS;
+        }
+        // Skip poll for linkstates not supported by device
+        else if (!nvlink_core_link_state_supported(links[i], linkState))
+        {
+            linkStatus[i] = NVL_ERR_NOT_SUPPORTED;
+            status        = NVL_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    while (NV_TRUE)
+    {
+        pending = 0;
+
+        for (i = 0; i < linkCount; i++)
+        {
+            if (linkStatus[i] != NVL_MORE_PROCESSING_REQUIRED)
+                continue;
+
+            links[i]->link_handlers->get_dl_link_mode(links[i], &currentLinkState);
+
+            if (currentLinkState == linkState)
+            {
+                linkStatus[i] = NVL_SUCCESS;
+                continue;
+            }
+
+            if (!timeout)
+            {
+                NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_ERRORS,
+                    "%s: Timeout occured while polling on link.\n",
+                    __FUNCTION__));
+
+                NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_ERRORS,
+                    "%s: Link info: device: %s link: %s link state "
+                    "expected: 0x%08llx actual: 0x%08llx.\n",
+                    __FUNCTION__, links[i]->dev->deviceName, links[i]->linkName,
+                    linkState, currentLinkState));
+
+                linkStatus[i] = NVL_ERR_INVALID_STATE;
+                status        = NVL_ERR_INVALID_STATE;
+                continue;
+            }
+
+            pending++;
+        }
+
+        if (pending == 0)
+            break;
+
+        nvlink_sleep(1);
+
+        timeout--;
+    }
+
+    return status;
+}
+
 /**
  * Poll for a given timeout period for the sublink to reach a given
  * state. Sublink state transition is considered as failed once the
@@ -31,6 +31,123 @@ static void _nvlink_core_set_sublink_pre_hs_settings(nvlink_link *, NvU32);
 static void _nvlink_core_set_link_pre_active_settings(nvlink_link *, NvU32);
 static void _nvlink_core_set_link_post_active_settings(nvlink_link *, NvU32);
 
+/**
+ * Log the time spent in a phase of link training and start the next one
+ *
+ * @param[in]      func         Training function the phase belongs to
+ * @param[in]      phase        Name of the phase that just completed
+ * @param[in,out]  pPhaseStart  Start time of the phase, in ns
+ */
+static void
+_nvlink_core_end_training_phase
+(
+    const char *func,
+    const char *phase,
+    NvU64      *pPhaseStart
+)
+{
+    NvU64 now = nvlink_get_platform_time();
+
+    NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_INFO,
+        "%s: %s took %llu us\n",
+        func, phase, (now - *pPhaseStart) / 1000));
+
+    *pPhaseStart = now;
+}
+
+/**
+ * Poll the ends of a list of intranode connections to reach the given
+ * link state, with a single timeout shared by all the connections
+ *
+ * @param[in]  conns      Array of connections to poll
+ * @param[in]  connCount  Number of connections in the array
+ * @param[in]  skipConn   Connections not to poll, may be NULL
+ * @param[in]  bPollEnd0  Poll end0 as well as end1 of the connections
+ * @param[in]  linkState  Target link state
+ * @param[in]  timeout    Timeout shared by all the connections
+ *
+ * return NVL_SUCCESS if all the polled ends transitioned to the target state
+ */
+static NvlStatus
+_nvlink_core_poll_intranode_conns_state
+(
+    nvlink_intranode_conn **conns,
+    NvU32                   connCount,
+    NvBool                 *skipConn,
+    NvBool                  bPollEnd0,
+    NvU64                   linkState,
+    NvU32                   timeout
+)
+{
+    nvlink_link **links      = NULL;
+    NvlStatus    *linkStatus = NULL;
+    NvlStatus     status     = NVL_SUCCESS;
+    NvlStatus     pollStatus = NVL_SUCCESS;
+    NvU32         linkCount  = 0;
+    NvU32         i;
+
+    links      = (nvlink_link **)nvlink_malloc(sizeof(nvlink_link *) * 2 * connCount);
+    linkStatus = (NvlStatus *)nvlink_malloc(sizeof(NvlStatus) * 2 * connCount);
+
+    for (i = 0; i < connCount; i++)
+    {
+        if ((conns[i] == NULL) || ((skipConn != NULL) && skipConn[i]))
+        {
+            continue;
+        }
+
+        if ((links == NULL) || (linkStatus == NULL))
+        {
+            //
+            // Could not allocate the list of links to poll together, so poll
+            // each of the ends in turn instead
+            //
+            if (bPollEnd0)
+            {
+                pollStatus = nvlink_core_poll_link_state(conns[i]->end0,
+                                                         linkState, timeout);
+                if (pollStatus != NVL_SUCCESS)
+                {
+                    status = pollStatus;
+                }
+            }
+
+            pollStatus = nvlink_core_poll_link_state(conns[i]->end1,
+                                                     linkState, timeout);
+            if (pollStatus != NVL_SUCCESS)
+            {
+                status = pollStatus;
+            }
+            continue;
+        }
+
+        if (bPollEnd0)
+        {
+            links[linkCount++] = conns[i]->end0;
+        }
+
+        links[linkCount++] = conns[i]->end1;
+    }
+
+    if ((links != NULL) && (linkStatus != NULL))
+    {
+        status = nvlink_core_poll_links_state(links, linkCount, linkState,
+                                              timeout, linkStatus);
+    }
+
+    if (links != NULL)
+    {
+        nvlink_free((void *)links);
+    }
+
+    if (linkStatus != NULL)
+    {
+        nvlink_free((void *)linkStatus);
+    }
+
+    return status;
+}
+
 NvlStatus
 nvlink_core_train_check_link_ready_ALI
 (
@@ -796,6 +913,7 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_non_ALI
 {
     NvlStatus status     = NVL_SUCCESS;
     NvlStatus pollStatus = NVL_SUCCESS;
+    NvU64     phaseStart = nvlink_get_platform_time();
     NvU32     i;
 
     if ((conns == NULL) || (connCount == 0))
@@ -826,6 +944,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_non_ALI
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "INITOPTIMIZE", &phaseStart);
+
     // Trigger POST_INITOPTIMIZE (Checks INITOPTIMIZE was successful) on both ends of the connection
     for (i = 0; i < connCount; i++)
     {
@@ -845,6 +965,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_non_ALI
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "POST_INITOPTIMIZE", &phaseStart);
+
     // Set link modes to ACTIVE
     for (i = 0; i < connCount; i++)
     {
@@ -870,28 +992,25 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_non_ALI
 
     }
 
-    // Verify link mode HS on the endpoints
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS request", &phaseStart);
+
+    // Verify link mode HS on the endpoints of all the connections together
+    pollStatus = _nvlink_core_poll_intranode_conns_state(conns, connCount, NULL,
+                                                         NV_TRUE,
+                                                         NVLINK_LINKSTATE_HS,
+                                                         NVLINK_TRANSITION_HS_TIMEOUT);
+    if (pollStatus != NVL_SUCCESS)
+    {
+        status = pollStatus;
+    }
+
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS poll", &phaseStart);
+
     for (i = 0; i < connCount; i++)
     {
         if (conns[i] == NULL)
             continue;
 
-        pollStatus = nvlink_core_poll_link_state(conns[i]->end0,
-                                                NVLINK_LINKSTATE_HS,
-                                                NVLINK_TRANSITION_HS_TIMEOUT);
-        if (pollStatus != NVL_SUCCESS)
-        {
-            status = pollStatus;
-        }
-
-        pollStatus = nvlink_core_poll_link_state(conns[i]->end1,
-                                                NVLINK_LINKSTATE_HS,
-                                                NVLINK_TRANSITION_HS_TIMEOUT);
-        if (pollStatus != NVL_SUCCESS)
-        {
-            status = pollStatus;
-        }
-
         conns[i]->end0->link_handlers->set_dl_link_mode(conns[i]->end0,
                                                         NVLINK_LINKSTATE_INITTL,
                                                         flags);
@@ -935,6 +1054,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_non_ALI
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "post HS", &phaseStart);
+
     return status;
 }
 
@@ -1011,6 +1132,7 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
     NvlStatus status     = NVL_SUCCESS;
     NvlStatus pollStatus = NVL_SUCCESS;
     NvU64     linkMode   = NVLINK_LINKSTATE_OFF;
+    NvU64     phaseStart = nvlink_get_platform_time();
     NvU32     i;
     NvBool    skipConn[NVLINK_MAX_SYSTEM_LINK_NUM] = {0};
 
@@ -1068,6 +1190,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "INITOPTIMIZE", &phaseStart);
+
     // Trigger POST_INITOPTIMIZE (Checks INITOPTIMIZE was successful) on both ends of the connection
     for (i = 0; i < connCount; i++)
     {
@@ -1089,6 +1213,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "POST_INITOPTIMIZE", &phaseStart);
+
     // Set link modes to ACTIVE
     for (i = 0; i < connCount; i++)
     {
@@ -1110,7 +1236,20 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
                                                         flags);
     }
 
-    // Verify link mode HS on the endpoints
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS request", &phaseStart);
+
+    // Verify link mode HS on the endpoints of all the connections together
+    pollStatus = _nvlink_core_poll_intranode_conns_state(conns, connCount, skipConn,
+                                                         NV_FALSE,
+                                                         NVLINK_LINKSTATE_HS,
+                                                         NVLINK_TRANSITION_HS_TIMEOUT);
+    if (pollStatus != NVL_SUCCESS)
+    {
+        status = pollStatus;
+    }
+
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS poll", &phaseStart);
+
     for (i = 0; i < connCount; i++)
     {
         if ((conns[i] == NULL) || skipConn[i])
@@ -1118,14 +1257,7 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
             continue;
         }
 
-        pollStatus = nvlink_core_poll_link_state(conns[i]->end1,
-                                                NVLINK_LINKSTATE_HS,
-                                                NVLINK_TRANSITION_HS_TIMEOUT);
-        if (pollStatus != NVL_SUCCESS)
-        {
-            status = pollStatus;
-        }
-        else
+        if (nvlink_core_check_link_state(conns[i]->end1, NVLINK_LINKSTATE_HS))
         {
             NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_INFO,
                 "%s: Successfully able to set linkstate to ACTIVE for links"
@@ -1177,6 +1309,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_ALT
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "post HS", &phaseStart);
+
     return status;
 }
 
@@ -1200,6 +1334,7 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_legacy
 {
     NvlStatus status     = NVL_SUCCESS;
     NvlStatus pollStatus = NVL_SUCCESS;
+    NvU64     phaseStart = nvlink_get_platform_time();
     NvU32     i;
 
     if ((conns == NULL) || (connCount == 0))
@@ -1274,6 +1409,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_legacy
         }
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "sublinks to HS", &phaseStart);
+
     // Some settings required before moving to ACTIVE
     for (i = 0; i < connCount; i++)
     {
@@ -1292,16 +1429,22 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_legacy
                                                         flags);
     }
 
-    // Verify link mode HS on the endpoints
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS request", &phaseStart);
+
+    // Verify link mode HS on the endpoints of all the connections together
+    (void)_nvlink_core_poll_intranode_conns_state(conns, connCount, NULL,
+                                                  NV_FALSE,
+                                                  NVLINK_LINKSTATE_HS,
+                                                  NVLINK_TRANSITION_HS_TIMEOUT);
+
+    _nvlink_core_end_training_phase(__FUNCTION__, "HS poll", &phaseStart);
+
     for (i = 0; i < connCount; i++)
     {
         if (conns[i] == NULL)
             continue;
 
-        pollStatus = nvlink_core_poll_link_state(conns[i]->end1,
-                                                 NVLINK_LINKSTATE_HS,
-                                                 NVLINK_TRANSITION_HS_TIMEOUT);
-        if (pollStatus == NVL_SUCCESS)
+        if (nvlink_core_check_link_state(conns[i]->end1, NVLINK_LINKSTATE_HS))
         {
             NVLINK_PRINT((DBG_MODULE_NVLINK_CORE, NVLINK_DBG_LEVEL_INFO,
                 "%s: Successfully able to train an intranode connection to Active",
@@ -1343,6 +1486,8 @@ nvlink_core_train_intranode_conns_from_swcfg_to_active_legacy
                                                         flags);
     }
 
+    _nvlink_core_end_training_phase(__FUNCTION__, "post HS", &phaseStart);
+
     return status;
 }
 
@@ -393,6 +393,16 @@ NvBool nvlink_core_check_rx_sublink_state(nvlink_link *link, NvU64 rxSublinkStat
 NvlStatus nvlink_core_poll_link_state(nvlink_link *link,
                                       NvU64        linkState,
                                       NvU32        timeout);
+/**
+ * Poll for a group of links to reach the particular state within a single timeout
+ * shared by all the links. The state transition of the links still pending when
+ * the timeout occurs is considered failed
+ */
+NvlStatus nvlink_core_poll_links_state(nvlink_link **links,
+                                       NvU32         linkCount,
+                                       NvU64         linkState,
+                                       NvU32         timeout,
+                                       NvlStatus    *linkStatus);
 /**
  * Poll for a given timeout period for a sublink to reach the particular state. The
  * sublink state transition is considered failed once timeout occurs
@@ -1396,6 +1396,32 @@ typedef struct nvswitch_get_port_events
     NVSWITCH_PORT_EVENT portEvent[NVSWITCH_PORT_EVENT_COUNT_SIZE];
 } NVSWITCH_GET_PORT_EVENTS_PARAMS;
 
+/*
+ * CTRL_NVSWITCH_GET_LOG_DROPPED_COUNTS
+ *
+ * Control for querying how many entries the driver's error and port event logs
+ * have lost. An entry is lost when it is overwritten in, or never added to, a
+ * log that is full. Clients of CTRL_NVSWITCH_GET_ERRORS and
+ * CTRL_NVSWITCH_GET_PORT_EVENTS can compare these counts between calls to tell
+ * whether they missed entries.
+ *
+ * Parameters:
+ *   fatalErrorDropped [OUT]
+ *      Number of entries lost from the NVSWITCH_ERROR_SEVERITY_FATAL error log.
+ *
+ *   nonfatalErrorDropped [OUT]
+ *      Number of entries lost from the NVSWITCH_ERROR_SEVERITY_NONFATAL error log.
+ *
+ *   portEventDropped [OUT]
+ *      Number of entries lost from the port event log.
+ */
+typedef struct nvswitch_get_log_dropped_counts
+{
+    NV_DECLARE_ALIGNED(NvU64 fatalErrorDropped, 8);
+    NV_DECLARE_ALIGNED(NvU64 nonfatalErrorDropped, 8);
+    NV_DECLARE_ALIGNED(NvU64 portEventDropped, 8);
+} NVSWITCH_GET_LOG_DROPPED_COUNTS_PARAMS;
+
 /*
  * CTRL_NVSWITCH_GET_INTERNAL_LATENCY
  *
@@ -4693,6 +4719,7 @@ typedef struct nvswitch_get_tnvl_status_params
 #define CTRL_NVSWITCH_GET_ATTESTATION_CERTIFICATE_CHAIN     0x6A
 #define CTRL_NVSWITCH_GET_ATTESTATION_REPORT                0x6B
 #define CTRL_NVSWITCH_GET_TNVL_STATUS                       0x6C
+#define CTRL_NVSWITCH_GET_LOG_DROPPED_COUNTS                0x6D
 
 #ifdef __cplusplus
 }
@@ -95,6 +95,7 @@ nvswitch_construct_error_log
     errors->error_log_size = 0;
     errors->error_log = NULL;
     errors->overwritable = overwritable;
+    errors->error_dropped = 0;
 
     if (error_log_size > 0)
     {
@@ -175,6 +176,16 @@ nvswitch_record_error
 
         if (errors->error_count == errors->error_log_size)
         {
+            if (errors->error_dropped == 0)
+            {
+                NVSWITCH_PRINT(device, WARN,
+                    "%s: Error log full, %s\n", __FUNCTION__,
+                    errors->overwritable ? "overwriting oldest errors" :
+                                           "dropping new errors");
+            }
+
+            errors->error_dropped++;
+
             // Error ring buffer already full.
             if (errors->overwritable)
             {
@@ -314,6 +325,32 @@ nvswitch_get_next_error
     }
 }
 
+//
+// Retrieve an error entry by its local error number.
+// The entries in the log are numbered consecutively, the newest one being
+// error_total - 1, so the entry is found without walking the log.
+// Returns NULL if the error is not, or no longer, in the error log.
+//
+
+static NVSWITCH_ERROR_TYPE *
+_nvswitch_get_error_by_num
+(
+    NVSWITCH_ERROR_LOG_TYPE *errors,
+    NvU64   error_num
+)
+{
+    NvU64 oldest_error_num = errors->error_total - errors->error_count;
+
+    if ((error_num < oldest_error_num) || (error_num >= errors->error_total))
+    {
+        return NULL;
+    }
+
+    return &errors->error_log[(errors->error_start +
+                               (NvU32)(error_num - oldest_error_num)) %
+                              errors->error_log_size];
+}
+
 NVSWITCH_NVLINK_HW_ERROR
 nvswitch_translate_hw_error
 (
@@ -509,10 +546,9 @@ nvswitch_ctrl_get_errors
     NVSWITCH_GET_ERRORS_PARAMS *p
 )
 {
-    NvU32 index = 0;
-    NvU32 count = 0;
     NVSWITCH_ERROR_LOG_TYPE *error_log;
-    NVSWITCH_ERROR_TYPE error;
+    NVSWITCH_ERROR_TYPE *error;
+    NvU64 error_num;
 
     switch (p->errorType)
     {
@@ -531,52 +567,38 @@ nvswitch_ctrl_get_errors
     p->nextErrorIndex = NVSWITCH_ERROR_NEXT_LOCAL_NUMBER(error_log);
     p->errorCount = 0;
 
-    // If there is nothing to do, return.
-    nvswitch_get_error(device, error_log, &error, index, &count);
-    if (count == 0)
-    {
-        return NVL_SUCCESS;
-    }
-
     //
-    // If the error's local_error_num is smaller than the errorIndex
-    // passed in by the client, fast-forward index by the difference.
-    // This will skip over errors that were previously read by the client.
+    // Start from the errorIndex passed in by the client, skipping over errors
+    // that were previously read by the client, or from the oldest error still
+    // in the log if the client fell behind.
     //
-    if (error.local_error_num < p->errorIndex)
-    {
-        index = (NvU32) (p->errorIndex - error.local_error_num);
-    }
-
-   // If there is nothing to do after fast-forwarding, return.
-   if (index >= count)
-   {
-      return NVL_SUCCESS;
-   }
-
-    while ((p->errorCount < NVSWITCH_ERROR_COUNT_SIZE) && (index < count))
-    {
-        // Get the next error to consider from the log
-        nvswitch_get_error(device, error_log, &error, index, NULL);
-
-        p->error[p->errorCount].error_value = error.error_type;
-        p->error[p->errorCount].error_src = error.error_src;
-        p->error[p->errorCount].instance = error.instance;
-        p->error[p->errorCount].subinstance = error.subinstance;
-        p->error[p->errorCount].time = error.time;
-        p->error[p->errorCount].error_resolved = error.error_resolved;
-        p->error[p->errorCount].error_data_size = error.data_size;
-        if (error.data_size > 0)
+    error_num = NV_MAX(p->errorIndex,
+                       error_log->error_total - error_log->error_count);
+
+    while ((p->errorCount < NVSWITCH_ERROR_COUNT_SIZE) &&
+           ((error = _nvswitch_get_error_by_num(error_log, error_num)) != NULL))
+    {
+        p->error[p->errorCount].error_value = error->error_type;
+        p->error[p->errorCount].error_src = error->error_src;
+        p->error[p->errorCount].instance = error->instance;
+        p->error[p->errorCount].subinstance = error->subinstance;
+        p->error[p->errorCount].time = error->time;
+        p->error[p->errorCount].error_resolved = error->error_resolved;
+        p->error[p->errorCount].error_data_size = error->data_size;
+        if (error->data_size > 0)
         {
-            nvswitch_os_memcpy(p->error[p->errorCount].error_data, error.data.raw.data, error.data_size);
+            nvswitch_os_memcpy(p->error[p->errorCount].error_data, error->data.raw.data, error->data_size);
         }
-        nvswitch_os_memcpy(p->error[p->errorCount].error_description, error.description, sizeof(error.description));
-        
+        nvswitch_os_memcpy(p->error[p->errorCount].error_description, error->description, sizeof(error->description));
+
         p->errorCount++;
-        index++;
+        error_num++;
     }
 
-    p->errorIndex = error.local_error_num + 1;
+    if (p->errorCount > 0)
+    {
+        p->errorIndex = error_num;
+    }
 
     return NVL_SUCCESS;
 }
@@ -376,8 +376,40 @@ typedef struct
     NvBool overwritable;        // Old entries can be overwritten
     NvBool bOverflow;           // True when log has been overflowed and no
                                 //  longer contains all port events that occurred
+    NvU64 port_event_dropped;   // Count of port events overwritten or not logged
+                                //  because the CB was full
 } NVSWITCH_PORT_EVENT_LOG_TYPE;
 
+//
+// Ingress routing tables shadowed by the driver
+//
+typedef enum
+{
+    NVSWITCH_ROUTING_TABLE_RID = 0,
+    NVSWITCH_ROUTING_TABLE_RLAN,
+    NVSWITCH_ROUTING_TABLE_COUNT
+} NVSWITCH_ROUTING_TABLE;
+
+// Maximum number of data registers of a routing table entry
+#define NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX 6
+
+typedef struct
+{
+    NvU32  data[NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX]; // Register values last written
+    NvBool valid;       // NV_FALSE if the contents of the entry are unknown
+} NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY;
+
+//
+// Shadow of the routing table entries last programmed through the ctrl calls.
+// Each entry holds the exact register values written for it. The shadow of a
+// port is allocated the first time one of its tables is programmed.
+//
+typedef struct
+{
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *entries[NVSWITCH_ROUTING_TABLE_COUNT][NVSWITCH_MAX_LINK_COUNT];
+    NvU32  table_size[NVSWITCH_ROUTING_TABLE_COUNT];
+} NVSWITCH_ROUTING_TABLE_SHADOW;
+
 
 //
 // common device information
@@ -410,6 +442,9 @@ struct nvswitch_device
     // Port Events
     NVSWITCH_PORT_EVENT_LOG_TYPE        log_PORT_EVENTS;
 
+    // Routing tables
+    NVSWITCH_ROUTING_TABLE_SHADOW       routing_table_shadow;
+
     NVSWITCH_FIRMWARE                   firmware;
 
     // HAL connectivity
@@ -643,5 +678,10 @@ NvBool    nvswitch_does_link_need_termination_enabled(nvswitch_device *device, n
 NvlStatus nvswitch_link_termination_setup(nvswitch_device *device, nvlink_link* link);
 void      nvswitch_record_port_event(nvswitch_device *device, NVSWITCH_PORT_EVENT_LOG_TYPE *port_events, NvU32 link_id, NvU8 port_event_type);
 NvlStatus nvswitch_ctrl_get_port_events(nvswitch_device *device, NVSWITCH_GET_PORT_EVENTS_PARAMS *p);
+NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *nvswitch_get_routing_table_shadow(nvswitch_device *device, NVSWITCH_ROUTING_TABLE table, NvU32 portNum, NvU32 tableSize);
+NvBool    nvswitch_routing_table_shadow_entry_matches(const NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *entry, const NvU32 *data, NvU32 dataCount);
+void      nvswitch_set_routing_table_shadow_entry(NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *entry, const NvU32 *data, NvU32 dataCount);
+void      nvswitch_invalidate_routing_table_shadow(nvswitch_device *device, NVSWITCH_ROUTING_TABLE table, NvU32 portNum, NvU32 firstIndex, NvU32 numEntries);
+void      nvswitch_invalidate_port_routing_table_shadow(nvswitch_device *device, NvU32 portNum);
 
 #endif //_COMMON_NVSWITCH_H_
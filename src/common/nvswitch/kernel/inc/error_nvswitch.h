@@ -120,6 +120,7 @@ typedef struct
     NvU32               error_log_size; // CB size
     NVSWITCH_ERROR_TYPE *error_log;
     NvBool              overwritable;   // Old CB entries can be overwritten
+    NvU64               error_dropped;  // Count of errors overwritten or not logged because the CB was full
 
 } NVSWITCH_ERROR_LOG_TYPE;
 
@@ -2195,6 +2195,114 @@ nvswitch_ctrl_set_remap_policy_valid_lr10
  * CTRL_NVSWITCH_SET_ROUTING_ID
  */
 
+#define NVSWITCH_NUM_RIDTABDATA_REGS_LR10 6
+
+//
+// Compute the _RIDTABDATA0.._RIDTABDATA5 register values of a RID entry
+//
+static void
+_nvswitch_encode_routing_id_lr10
+(
+    NVSWITCH_ROUTING_ID_ENTRY *routing_id,
+    NvU32 *rid_tab_data
+)
+{
+    NvU32 rmod;
+
+    rid_tab_data[1] =
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT3,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 3)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE3, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 3))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT4,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 4)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE4, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 4))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT5,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 5)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE5, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 5));
+
+    rid_tab_data[2] =
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT6,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 6)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE6, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 6))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT7,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 7)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE7, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 7))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT8,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 8)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE8, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 8));
+
+    rid_tab_data[3] =
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT9,     NVSWITCH_PORTLIST_PORT_LR10((*routing_id),  9)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE9,  NVSWITCH_PORTLIST_VC_LR10((*routing_id),  9))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT10,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 10)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE10, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 10))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT11,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 11)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE11, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 11));
+
+    rid_tab_data[4] =
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT12,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 12)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE12, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 12))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT13,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 13)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE13, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 13))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT14,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 14)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE14, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 14));
+
+    rmod =
+        ((*routing_id).useRoutingLan ? NVBIT(6) : 0) |
+        ((*routing_id).enableIrlErrResponse ? NVBIT(9) : 0);
+
+    rid_tab_data[5] =
+        DRF_NUM(_INGRESS, _RIDTABDATA5, _PORT15,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 15)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA5, _VC_MODE15, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 15))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA5, _RMOD,      rmod)                                           |
+        DRF_NUM(_INGRESS, _RIDTABDATA5, _ACLVALID,  (*routing_id).entryValid);
+
+    NVSWITCH_ASSERT((*routing_id).numEntries <= 16);
+    rid_tab_data[0] =
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _GSIZE,
+                ((*routing_id).numEntries == 16) ? 0x0 : (*routing_id).numEntries) |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT0,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 0)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE0, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 0))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT1,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 1)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE1, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 1))   |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT2,    NVSWITCH_PORTLIST_PORT_LR10((*routing_id), 2)) |
+        DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE2, NVSWITCH_PORTLIST_VC_LR10((*routing_id), 2));
+}
+
+//
+// Return the mask of the RID entries that differ from what was last
+// programmed, per the routing table shadow. All the entries are selected if
+// there is no shadow.
+//
+static NvU64
+_nvswitch_get_routing_id_write_mask_lr10
+(
+    NvU32 firstIndex,
+    NvU32 numEntries,
+    NVSWITCH_ROUTING_ID_ENTRY *routing_id,
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow
+)
+{
+    NvU32 rid_tab_data[NVSWITCH_NUM_RIDTABDATA_REGS_LR10];
+    NvU64 write_mask = 0;
+    NvU32 i;
+
+    ct_assert(NVSWITCH_ROUTING_ID_ENTRIES_MAX <= 64);
+    ct_assert(NVSWITCH_NUM_RIDTABDATA_REGS_LR10 <= NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX);
+
+    for (i = 0; i < numEntries; i++)
+    {
+        if (shadow != NULL)
+        {
+            _nvswitch_encode_routing_id_lr10(&routing_id[i], rid_tab_data);
+
+            if (nvswitch_routing_table_shadow_entry_matches(&shadow[firstIndex + i],
+                    rid_tab_data, NVSWITCH_NUM_RIDTABDATA_REGS_LR10))
+            {
+                continue;
+            }
+        }
+
+        write_mask |= NVBIT64(i);
+    }
+
+    return write_mask;
+}
+
 static void
 _nvswitch_set_routing_id_lr10
 (
@@ -2202,77 +2310,53 @@ _nvswitch_set_routing_id_lr10
     NvU32 portNum,
     NvU32 firstIndex,
     NvU32 numEntries,
-    NVSWITCH_ROUTING_ID_ENTRY *routing_id
+    NVSWITCH_ROUTING_ID_ENTRY *routing_id,
+    NvU64 write_mask,
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow
 )
 {
+    NvU32 rid_tab_data[NVSWITCH_NUM_RIDTABDATA_REGS_LR10];
+    NvBool bAddressValid = NV_FALSE;
     NvU32 i;
-    NvU32 rmod;
-
-    NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _REQRSPMAPADDR,
-        DRF_NUM(_INGRESS, _REQRSPMAPADDR, _RAM_ADDRESS, firstIndex) |
-        DRF_DEF(_INGRESS, _REQRSPMAPADDR, _RAM_SEL, _SELECTSRIDROUTERAM) |
-        DRF_NUM(_INGRESS, _REQRSPMAPADDR, _AUTO_INCR, 1));
 
     for (i = 0; i < numEntries; i++)
     {
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA1,
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT3,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 3)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE3, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 3))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT4,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 4)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE4, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 4))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _PORT5,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 5)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA1, _VC_MODE5, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 5)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA2,
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT6,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 6)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE6, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 6))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT7,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 7)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE7, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 7))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _PORT8,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 8)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA2, _VC_MODE8, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 8)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA3,
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT9,     NVSWITCH_PORTLIST_PORT_LR10(routing_id[i],  9)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE9,  NVSWITCH_PORTLIST_VC_LR10(routing_id[i],  9))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT10,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 10)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE10, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 10))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _PORT11,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 11)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA3, _VC_MODE11, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 11)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA4,
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT12,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 12)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE12, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 12))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT13,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 13)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE13, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 13))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _PORT14,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 14)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA4, _VC_MODE14, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 14)));
-
-        rmod =
-            (routing_id[i].useRoutingLan ? NVBIT(6) : 0) |
-            (routing_id[i].enableIrlErrResponse ? NVBIT(9) : 0);
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA5,
-            DRF_NUM(_INGRESS, _RIDTABDATA5, _PORT15,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 15)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA5, _VC_MODE15, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 15))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA5, _RMOD,      rmod)                                           |
-            DRF_NUM(_INGRESS, _RIDTABDATA5, _ACLVALID,  routing_id[i].entryValid));
-
-        NVSWITCH_ASSERT(routing_id[i].numEntries <= 16);
+        // Skip the entries already programmed
+        if ((write_mask & NVBIT64(i)) == 0)
+        {
+            bAddressValid = NV_FALSE;
+            continue;
+        }
+
+        // Point the auto-incrementing RAM address at the first entry of each run
+        if (!bAddressValid)
+        {
+            NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _REQRSPMAPADDR,
+                DRF_NUM(_INGRESS, _REQRSPMAPADDR, _RAM_ADDRESS, firstIndex + i) |
+                DRF_DEF(_INGRESS, _REQRSPMAPADDR, _RAM_SEL, _SELECTSRIDROUTERAM) |
+                DRF_NUM(_INGRESS, _REQRSPMAPADDR, _AUTO_INCR, 1));
+            bAddressValid = NV_TRUE;
+        }
+
+        _nvswitch_encode_routing_id_lr10(&routing_id[i], rid_tab_data);
+
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA1, rid_tab_data[1]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA2, rid_tab_data[2]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA3, rid_tab_data[3]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA4, rid_tab_data[4]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA5, rid_tab_data[5]);
+
         // Write last and auto-increment
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA0,
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _GSIZE,
-                (routing_id[i].numEntries == 16) ? 0x0 : routing_id[i].numEntries) |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT0,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 0)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE0, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 0))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT1,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 1)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE1, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 1))   |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _PORT2,    NVSWITCH_PORTLIST_PORT_LR10(routing_id[i], 2)) |
-            DRF_NUM(_INGRESS, _RIDTABDATA0, _VC_MODE2, NVSWITCH_PORTLIST_VC_LR10(routing_id[i], 2)));
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RIDTABDATA0, rid_tab_data[0]);
+
+        if (shadow != NULL)
+        {
+            nvswitch_set_routing_table_shadow_entry(&shadow[firstIndex + i],
+                rid_tab_data, NVSWITCH_NUM_RIDTABDATA_REGS_LR10);
+        }
     }
 }
 
-#define NVSWITCH_NUM_RIDTABDATA_REGS_LR10 6
-
 NvlStatus
 nvswitch_ctrl_get_routing_id_lr10
 (
@@ -2456,6 +2540,10 @@ nvswitch_ctrl_set_routing_id_valid_lr10
         return -NVL_BAD_ARGS;
     }
 
+    // The entries are modified in place, so forget what was last programmed
+    nvswitch_invalidate_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RID,
+                                             p->portNum, p->firstIndex, p->numEntries);
+
     // Stop traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_TRUE);
     if (retval != NVL_SUCCESS)
@@ -2517,6 +2605,8 @@ nvswitch_ctrl_set_routing_id_lr10
     NvU32 i, j;
     NvlStatus retval = NVL_SUCCESS;
     NvU32 ram_size;
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow;
+    NvU64 write_mask;
 
     if (nvswitch_is_tnvl_mode_locked(device))
     {
@@ -2582,6 +2672,21 @@ nvswitch_ctrl_set_routing_id_lr10
         }
     }
 
+    //
+    // Only write the entries that differ from what was last programmed. If
+    // there is none, the table is already up to date and traffic does not
+    // need to be stopped.
+    //
+    shadow = nvswitch_get_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RID,
+                                               p->portNum, ram_size);
+    write_mask = _nvswitch_get_routing_id_write_mask_lr10(p->firstIndex, p->numEntries,
+                                                         p->routingId, shadow);
+
+    if (write_mask == 0)
+    {
+        return NVL_SUCCESS;
+    }
+
     // Stop traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_TRUE);
     if (retval != NVL_SUCCESS)
@@ -2591,7 +2696,8 @@ nvswitch_ctrl_set_routing_id_lr10
         return retval;
     }
 
-    _nvswitch_set_routing_id_lr10(device, p->portNum, p->firstIndex, p->numEntries, p->routingId);
+    _nvswitch_set_routing_id_lr10(device, p->portNum, p->firstIndex, p->numEntries, p->routingId,
+                                 write_mask, shadow);
 
     // Allow traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_FALSE);
@@ -2616,6 +2722,112 @@ nvswitch_ctrl_set_routing_id_lr10
 #define NVSWITCH_PORTLIST_VALID_LR10(_entry, _idx, _field, _default) \
     ((_idx < _entry.numEntries) ? _entry.portList[_idx]._field  : _default)
 
+#define NVSWITCH_NUM_RLANTABDATA_REGS_LR10 6
+
+//
+// Compute the _RLANTABDATA0.._RLANTABDATA5 register values of a RLAN entry
+//
+static void
+_nvswitch_encode_routing_lan_lr10
+(
+    NVSWITCH_ROUTING_LAN_ENTRY *routing_lan,
+    NvU32 *rlan_tab_data
+)
+{
+    //
+    // NOTE: The GRP_SIZE field is 4-bits.  A subgroup is size 1 through 16
+    // with encoding 0x0=16 and 0x1=1, ..., 0xF=15.
+    // Programming of GRP_SIZE takes advantage of the inherent masking of
+    // DRF_NUM to truncate 16 to 0.
+    // See bug #3300673
+    //
+
+    rlan_tab_data[1] =
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_3, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 3, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_3, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 3, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_4, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 4, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_4, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 4, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_5, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 5, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_5, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 5, groupSize, 1));
+
+    rlan_tab_data[2] =
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_6, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 6, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_6, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 6, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_7, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 7, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_7, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 7, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_8, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 8, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_8, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 8, groupSize, 1));
+
+    rlan_tab_data[3] =
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_9, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 9, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_9, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 9, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_10, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 10, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_10, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 10, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_11, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 11, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_11, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 11, groupSize, 1));
+
+    rlan_tab_data[4] =
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_12, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 12, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_12, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 12, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_13, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 13, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_13, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 13, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_14, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 14, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_14, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 14, groupSize, 1));
+
+    rlan_tab_data[5] =
+        DRF_NUM(_INGRESS, _RLANTABDATA5, _GRP_SEL_15, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 15, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA5, _GRP_SIZE_15, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 15, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA5, _ACLVALID,  (*routing_lan).entryValid);
+
+    rlan_tab_data[0] =
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_0, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 0, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_0, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 0, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_1, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 1, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_1, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 1, groupSize, 1)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_2, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 2, groupSelect, 0)) |
+        DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_2, NVSWITCH_PORTLIST_VALID_LR10((*routing_lan), 2, groupSize, 1));
+}
+
+//
+// Return the mask of the RLAN entries that differ from what was last
+// programmed, per the routing table shadow. All the entries are selected if
+// there is no shadow.
+//
+static NvU64
+_nvswitch_get_routing_lan_write_mask_lr10
+(
+    NvU32 firstIndex,
+    NvU32 numEntries,
+    NVSWITCH_ROUTING_LAN_ENTRY *routing_lan,
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow
+)
+{
+    NvU32 rlan_tab_data[NVSWITCH_NUM_RLANTABDATA_REGS_LR10];
+    NvU64 write_mask = 0;
+    NvU32 i;
+
+    ct_assert(NVSWITCH_ROUTING_LAN_ENTRIES_MAX <= 64);
+    ct_assert(NVSWITCH_NUM_RLANTABDATA_REGS_LR10 <= NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX);
+
+    for (i = 0; i < numEntries; i++)
+    {
+        if (shadow != NULL)
+        {
+            _nvswitch_encode_routing_lan_lr10(&routing_lan[i], rlan_tab_data);
+
+            if (nvswitch_routing_table_shadow_entry_matches(&shadow[firstIndex + i],
+                    rlan_tab_data, NVSWITCH_NUM_RLANTABDATA_REGS_LR10))
+            {
+                continue;
+            }
+        }
+
+        write_mask |= NVBIT64(i);
+    }
+
+    return write_mask;
+}
+
 static void
 _nvswitch_set_routing_lan_lr10
 (
@@ -2623,71 +2835,50 @@ _nvswitch_set_routing_lan_lr10
     NvU32 portNum,
     NvU32 firstIndex,
     NvU32 numEntries,
-    NVSWITCH_ROUTING_LAN_ENTRY *routing_lan
+    NVSWITCH_ROUTING_LAN_ENTRY *routing_lan,
+    NvU64 write_mask,
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow
 )
 {
+    NvU32 rlan_tab_data[NVSWITCH_NUM_RLANTABDATA_REGS_LR10];
+    NvBool bAddressValid = NV_FALSE;
     NvU32 i;
 
-    NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _REQRSPMAPADDR,
-        DRF_NUM(_INGRESS, _REQRSPMAPADDR, _RAM_ADDRESS, firstIndex) |
-        DRF_DEF(_INGRESS, _REQRSPMAPADDR, _RAM_SEL, _SELECTSRLANROUTERAM) |
-        DRF_NUM(_INGRESS, _REQRSPMAPADDR, _AUTO_INCR, 1));
-
     for (i = 0; i < numEntries; i++)
     {
-        //
-        // NOTE: The GRP_SIZE field is 4-bits.  A subgroup is size 1 through 16
-        // with encoding 0x0=16 and 0x1=1, ..., 0xF=15.
-        // Programming of GRP_SIZE takes advantage of the inherent masking of
-        // DRF_NUM to truncate 16 to 0.
-        // See bug #3300673
-        //
+        // Skip the entries already programmed
+        if ((write_mask & NVBIT64(i)) == 0)
+        {
+            bAddressValid = NV_FALSE;
+            continue;
+        }
+
+        // Point the auto-incrementing RAM address at the first entry of each run
+        if (!bAddressValid)
+        {
+            NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _REQRSPMAPADDR,
+                DRF_NUM(_INGRESS, _REQRSPMAPADDR, _RAM_ADDRESS, firstIndex + i) |
+                DRF_DEF(_INGRESS, _REQRSPMAPADDR, _RAM_SEL, _SELECTSRLANROUTERAM) |
+                DRF_NUM(_INGRESS, _REQRSPMAPADDR, _AUTO_INCR, 1));
+            bAddressValid = NV_TRUE;
+        }
 
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA1,
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_3, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 3, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_3, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 3, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_4, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 4, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_4, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 4, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SEL_5, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 5, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA1, _GRP_SIZE_5, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 5, groupSize, 1)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA2,
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_6, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 6, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_6, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 6, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_7, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 7, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_7, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 7, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SEL_8, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 8, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA2, _GRP_SIZE_8, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 8, groupSize, 1)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA3,
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_9, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 9, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_9, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 9, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_10, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 10, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_10, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 10, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SEL_11, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 11, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA3, _GRP_SIZE_11, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 11, groupSize, 1)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA4,
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_12, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 12, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_12, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 12, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_13, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 13, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_13, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 13, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SEL_14, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 14, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA4, _GRP_SIZE_14, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 14, groupSize, 1)));
-
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA5,
-            DRF_NUM(_INGRESS, _RLANTABDATA5, _GRP_SEL_15, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 15, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA5, _GRP_SIZE_15, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 15, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA5, _ACLVALID,  routing_lan[i].entryValid));
+        _nvswitch_encode_routing_lan_lr10(&routing_lan[i], rlan_tab_data);
+
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA1, rlan_tab_data[1]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA2, rlan_tab_data[2]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA3, rlan_tab_data[3]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA4, rlan_tab_data[4]);
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA5, rlan_tab_data[5]);
 
         // Write last and auto-increment
-        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA0,
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_0, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 0, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_0, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 0, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_1, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 1, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_1, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 1, groupSize, 1)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SEL_2, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 2, groupSelect, 0)) |
-            DRF_NUM(_INGRESS, _RLANTABDATA0, _GRP_SIZE_2, NVSWITCH_PORTLIST_VALID_LR10(routing_lan[i], 2, groupSize, 1)));
+        NVSWITCH_LINK_WR32_LR10(device, portNum, NPORT, _INGRESS, _RLANTABDATA0, rlan_tab_data[0]);
+
+        if (shadow != NULL)
+        {
+            nvswitch_set_routing_table_shadow_entry(&shadow[firstIndex + i],
+                rlan_tab_data, NVSWITCH_NUM_RLANTABDATA_REGS_LR10);
+        }
     }
 }
 
@@ -2701,6 +2892,8 @@ nvswitch_ctrl_set_routing_lan_lr10
     NvU32 i, j;
     NvlStatus retval = NVL_SUCCESS;
     NvU32 ram_size;
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *shadow;
+    NvU64 write_mask;
 
     if (nvswitch_is_tnvl_mode_locked(device))
     {
@@ -2766,6 +2959,21 @@ nvswitch_ctrl_set_routing_lan_lr10
         }
     }
 
+    //
+    // Only write the entries that differ from what was last programmed. If
+    // there is none, the table is already up to date and traffic does not
+    // need to be stopped.
+    //
+    shadow = nvswitch_get_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RLAN,
+                                               p->portNum, ram_size);
+    write_mask = _nvswitch_get_routing_lan_write_mask_lr10(p->firstIndex, p->numEntries,
+                                                         p->routingLan, shadow);
+
+    if (write_mask == 0)
+    {
+        return NVL_SUCCESS;
+    }
+
     // Stop traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_TRUE);
     if (retval != NVL_SUCCESS)
@@ -2775,7 +2983,8 @@ nvswitch_ctrl_set_routing_lan_lr10
         return retval;
     }
 
-    _nvswitch_set_routing_lan_lr10(device, p->portNum, p->firstIndex, p->numEntries, p->routingLan);
+    _nvswitch_set_routing_lan_lr10(device, p->portNum, p->firstIndex, p->numEntries, p->routingLan,
+                                 write_mask, shadow);
 
     // Allow traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_FALSE);
@@ -2789,8 +2998,6 @@ nvswitch_ctrl_set_routing_lan_lr10
     return retval;
 }
 
-#define NVSWITCH_NUM_RLANTABDATA_REGS_LR10 6
-
 NvlStatus
 nvswitch_ctrl_get_routing_lan_lr10
 (
@@ -3026,6 +3233,10 @@ nvswitch_ctrl_set_routing_lan_valid_lr10
         return -NVL_BAD_ARGS;
     }
 
+    // The entries are modified in place, so forget what was last programmed
+    nvswitch_invalidate_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RLAN,
+                                             p->portNum, p->firstIndex, p->numEntries);
+
     // Stop traffic on the port
     retval = nvswitch_soe_issue_ingress_stop(device, p->portNum, NV_TRUE);
     if (retval != NVL_SUCCESS)
@@ -6273,6 +6484,9 @@ nvswitch_reset_and_drain_links_lr10
         NVSWITCH_NPG_WR32_LR10(device, npg, _NPG, _WARMRESET,
             DRF_NUM(_NPG, _WARMRESET, _NPORTWARMRESET, ~NVBIT(idx_nport)));
 
+        // The NPORT routing tables are not known to hold their contents across reset
+        nvswitch_invalidate_port_routing_table_shadow(device, link);
+
         // Step 1.e : Initiate Minion reset sequence.
         status = nvswitch_request_tl_link_state_lr10(link_info,
             NV_NVLIPT_LNK_CTRL_LINK_STATE_REQUEST_REQUEST_RESET, NV_TRUE);
@@ -1785,6 +1785,10 @@ _nvswitch_service_ingress_fatal_ls10
         NVSWITCH_REPORT_CONTAIN_DATA(_HW_NPORT_INGRESS_RIDTAB_ECC_DBE_ERR, data);
         nvswitch_clear_flags(&unhandled, bit);
 
+        // The table contents can no longer be trusted
+        nvswitch_invalidate_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RID,
+                                                 link, 0, NV_U32_MAX);
+
         _nvswitch_construct_ecc_error_event_ls10(&err_event,
             NVSWITCH_ERR_HW_NPORT_INGRESS_RIDTAB_ECC_DBE_ERR, link, bAddressValid,
             address, NV_TRUE, 1);
@@ -1815,6 +1819,10 @@ _nvswitch_service_ingress_fatal_ls10
         NVSWITCH_REPORT_CONTAIN_DATA(_HW_NPORT_INGRESS_RLANTAB_ECC_DBE_ERR, data);
         nvswitch_clear_flags(&unhandled, bit);
 
+        // The table contents can no longer be trusted
+        nvswitch_invalidate_routing_table_shadow(device, NVSWITCH_ROUTING_TABLE_RLAN,
+                                                 link, 0, NV_U32_MAX);
+
         _nvswitch_construct_ecc_error_event_ls10(&err_event,
             NVSWITCH_ERR_HW_NPORT_INGRESS_RLANTAB_ECC_DBE_ERR, link, bAddressValid,
             address, NV_TRUE, 1);
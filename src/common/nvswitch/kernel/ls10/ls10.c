@@ -1646,6 +1646,9 @@ _nvswitch_reset_and_drain_links_ls10
         //
         nvswitch_soe_issue_nport_reset_ls10(device, link);
 
+        // The NPORT routing tables are not known to hold their contents across reset
+        nvswitch_invalidate_port_routing_table_shadow(device, link);
+
         //
         // Step 5.0 : Issue Minion request to perform the link reset sequence
         // We retry the Minion reset sequence 3 times, if we there is an error
@@ -1717,6 +1717,7 @@ _nvswitch_construct_port_event_log
     port_events->port_event_log = NULL;
     port_events->overwritable = overwritable;
     port_events->bOverflow = NV_FALSE;
+    port_events->port_event_dropped = 0;
 
     if (port_event_log_size > 0)
     {
@@ -2470,6 +2471,8 @@ nvswitch_record_port_event
 
         if (port_events->port_event_count == port_events->port_event_log_size)
         {
+            port_events->port_event_dropped++;
+
             // Error: ring buffer is already full/
             if (port_events->overwritable)
             {
@@ -2544,6 +2547,40 @@ nvswitch_get_port_event
     }
 }
 
+/*
+ * @Brief : Retrieves a port event entry by its local port event number.
+ *
+ * @Description : The entries in the log are numbered consecutively, the newest
+ *                one being port_event_total - 1, so the entry is found without
+ *                walking the log.
+ *
+ * @param[in] port_events         Log of all port events with metadata
+ * @param[in] port_event_num      Local port event number of the entry
+ *
+ * @returns                       The entry, or NULL if the port event is not,
+ *                                or no longer, in the log
+ */
+static NVSWITCH_PORT_EVENT_TYPE *
+_nvswitch_get_port_event_by_num
+(
+    NVSWITCH_PORT_EVENT_LOG_TYPE *port_events,
+    NvU64 port_event_num
+)
+{
+    NvU64 oldest_port_event_num = port_events->port_event_total -
+                                  port_events->port_event_count;
+
+    if ((port_event_num < oldest_port_event_num) ||
+        (port_event_num >= port_events->port_event_total))
+    {
+        return NULL;
+    }
+
+    return &port_events->port_event_log[(port_events->port_event_start +
+                                         (NvU32)(port_event_num - oldest_port_event_num)) %
+                                        port_events->port_event_log_size];
+}
+
 NvlStatus
 nvswitch_ctrl_get_port_events
 (
@@ -2551,10 +2588,9 @@ nvswitch_ctrl_get_port_events
     NVSWITCH_GET_PORT_EVENTS_PARAMS *p
 )
 {
-    NvU32 index = 0;
-    NvU32 count = 0;
     NVSWITCH_PORT_EVENT_LOG_TYPE *port_events = &device->log_PORT_EVENTS;
-    NVSWITCH_PORT_EVENT_TYPE port_event;
+    NVSWITCH_PORT_EVENT_TYPE *port_event;
+    NvU64 port_event_num;
 
     nvswitch_os_memset(p->portEvent, 0, sizeof(NVSWITCH_PORT_EVENT)
                                     *NVSWITCH_PORT_EVENT_COUNT_SIZE);
@@ -2562,42 +2598,224 @@ nvswitch_ctrl_get_port_events
     p->portEventCount = 0;
     p->bOverflow = port_events->bOverflow;
 
-    // Return if there are no more port events to get
-    nvswitch_get_port_event(device, port_events, &port_event, index, &count);
-    if (count == 0)
+    // Start from the portEventIndex passed in by the client, skipping over
+    // port events that were previously read by the client, or from the oldest
+    // port event still in the log if the client fell behind.
+    port_event_num = NV_MAX(p->portEventIndex,
+                            port_events->port_event_total -
+                            port_events->port_event_count);
+
+    while ((p->portEventCount < NVSWITCH_PORT_EVENT_COUNT_SIZE) &&
+           ((port_event = _nvswitch_get_port_event_by_num(port_events,
+                                                          port_event_num)) != NULL))
     {
-        return NVL_SUCCESS;
+        p->portEvent[p->portEventCount].port_event_type = port_event->port_event_type;
+        p->portEvent[p->portEventCount].link_id = port_event->link_id;
+        p->portEvent[p->portEventCount].time = port_event->time;
+
+        p->portEventCount++;
+        port_event_num++;
     }
 
-    // If port event's local_port_Event_num is smaller than the portEventIndex
-    // passed in by the client, fast-forward index by the difference.
-    // This will skip over port events that were previously read by the client.
-    if (port_event.local_port_event_num < p->portEventIndex)
+    if (p->portEventCount > 0)
     {
-        index = (NvU32) (p->portEventIndex - port_event.local_port_event_num);
+        p->portEventIndex = port_event_num;
     }
 
-    // Return if there are no more events after fast-forwarding.
-    if (index >= count)
+    return NVL_SUCCESS;
+}
+
+static NvlStatus
+_nvswitch_ctrl_get_log_dropped_counts
+(
+    nvswitch_device *device,
+    NVSWITCH_GET_LOG_DROPPED_COUNTS_PARAMS *p
+)
+{
+    p->fatalErrorDropped = device->log_FATAL_ERRORS.error_dropped;
+    p->nonfatalErrorDropped = device->log_NONFATAL_ERRORS.error_dropped;
+    p->portEventDropped = device->log_PORT_EVENTS.port_event_dropped;
+
+    return NVL_SUCCESS;
+}
+
+/*
+ * @Brief : Returns the routing table shadow of a port, allocating it if needed.
+ *
+ * @param[in] device              NVSwitch device
+ * @param[in] table               Routing table
+ * @param[in] portNum             Port of the routing table
+ * @param[in] tableSize           Number of entries in the routing table
+ *
+ * @returns                       The shadow entries of the table, or NULL if
+ *                                the shadow could not be allocated, in which
+ *                                case all the entries have to be written
+ */
+NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *
+nvswitch_get_routing_table_shadow
+(
+    nvswitch_device *device,
+    NVSWITCH_ROUTING_TABLE table,
+    NvU32 portNum,
+    NvU32 tableSize
+)
+{
+    NVSWITCH_ROUTING_TABLE_SHADOW *shadow = &device->routing_table_shadow;
+
+    if ((table >= NVSWITCH_ROUTING_TABLE_COUNT) ||
+        (portNum >= NVSWITCH_MAX_LINK_COUNT) ||
+        (tableSize == 0))
     {
-        return NVL_SUCCESS;
+        return NULL;
     }
 
-    while ((p->portEventCount < NVSWITCH_PORT_EVENT_COUNT_SIZE) && (index < count))
+    if (shadow->entries[table][portNum] == NULL)
     {
-        nvswitch_get_port_event(device, port_events, &port_event, index, NULL);
+        shadow->entries[table][portNum] =
+            nvswitch_os_malloc(tableSize * sizeof(NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY));
+        if (shadow->entries[table][portNum] == NULL)
+        {
+            return NULL;
+        }
 
-        p->portEvent[p->portEventCount].port_event_type = port_event.port_event_type;
-        p->portEvent[p->portEventCount].link_id = port_event.link_id;
-        p->portEvent[p->portEventCount].time = port_event.time;
+        nvswitch_os_memset(shadow->entries[table][portNum], 0,
+                           tableSize * sizeof(NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY));
+        shadow->table_size[table] = tableSize;
+    }
 
-        p->portEventCount++;
-        index++;
+    NVSWITCH_ASSERT(shadow->table_size[table] == tableSize);
+
+    return shadow->entries[table][portNum];
+}
+
+/*
+ * @Brief : Checks whether a routing table entry was last programmed with the
+ *          given register values.
+ *
+ * @param[in] entry               Shadow of the entry
+ * @param[in] data                Register values of the entry
+ * @param[in] dataCount           Number of register values
+ *
+ * @returns                       NV_TRUE if the entry holds exactly these
+ *                                values
+ */
+NvBool
+nvswitch_routing_table_shadow_entry_matches
+(
+    const NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *entry,
+    const NvU32 *data,
+    NvU32 dataCount
+)
+{
+    NVSWITCH_ASSERT(dataCount <= NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX);
+
+    return entry->valid &&
+           (nvswitch_os_memcmp(entry->data, data, dataCount * sizeof(NvU32)) == 0);
+}
+
+/*
+ * @Brief : Records the register values a routing table entry was programmed
+ *          with.
+ *
+ * @param[out] entry              Shadow of the entry
+ * @param[in]  data               Register values of the entry
+ * @param[in]  dataCount          Number of register values
+ */
+void
+nvswitch_set_routing_table_shadow_entry
+(
+    NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY *entry,
+    const NvU32 *data,
+    NvU32 dataCount
+)
+{
+    NVSWITCH_ASSERT(dataCount <= NVSWITCH_ROUTING_TABLE_ENTRY_DATA_MAX);
+
+    nvswitch_os_memset(entry->data, 0, sizeof(entry->data));
+    nvswitch_os_memcpy(entry->data, data, dataCount * sizeof(NvU32));
+    entry->valid = NV_TRUE;
+}
+
+/*
+ * @Brief : Forgets the contents of a range of routing table entries, so that
+ *          they are written the next time they are programmed.
+ *
+ * @param[in] device              NVSwitch device
+ * @param[in] table               Routing table
+ * @param[in] portNum             Port of the routing table
+ * @param[in] firstIndex          First entry of the range
+ * @param[in] numEntries          Number of entries in the range
+ */
+void
+nvswitch_invalidate_routing_table_shadow
+(
+    nvswitch_device *device,
+    NVSWITCH_ROUTING_TABLE table,
+    NvU32 portNum,
+    NvU32 firstIndex,
+    NvU32 numEntries
+)
+{
+    NVSWITCH_ROUTING_TABLE_SHADOW *shadow = &device->routing_table_shadow;
+
+    if ((table >= NVSWITCH_ROUTING_TABLE_COUNT) ||
+        (portNum >= NVSWITCH_MAX_LINK_COUNT) ||
+        (shadow->entries[table][portNum] == NULL) ||
+        (firstIndex >= shadow->table_size[table]))
+    {
+        return;
     }
 
-    p->portEventIndex = port_event.local_port_event_num + 1;
+    numEntries = NV_MIN(numEntries, shadow->table_size[table] - firstIndex);
 
-    return NVL_SUCCESS;
+    nvswitch_os_memset(&shadow->entries[table][portNum][firstIndex], 0,
+                       numEntries * sizeof(NVSWITCH_ROUTING_TABLE_SHADOW_ENTRY));
+}
+
+/*
+ * @Brief : Forgets the contents of all the routing tables of a port, e.g.
+ *          after the port was reset.
+ *
+ * @param[in] device              NVSwitch device
+ * @param[in] portNum             Port of the routing tables
+ */
+void
+nvswitch_invalidate_port_routing_table_shadow
+(
+    nvswitch_device *device,
+    NvU32 portNum
+)
+{
+    NvU32 table;
+
+    for (table = 0; table < NVSWITCH_ROUTING_TABLE_COUNT; table++)
+    {
+        nvswitch_invalidate_routing_table_shadow(device, table, portNum, 0,
+            device->routing_table_shadow.table_size[table]);
+    }
+}
+
+static void
+_nvswitch_destroy_routing_table_shadow
+(
+    nvswitch_device *device
+)
+{
+    NVSWITCH_ROUTING_TABLE_SHADOW *shadow = &device->routing_table_shadow;
+    NvU32 table;
+    NvU32 portNum;
+
+    for (table = 0; table < NVSWITCH_ROUTING_TABLE_COUNT; table++)
+    {
+        for (portNum = 0; portNum < NVSWITCH_MAX_LINK_COUNT; portNum++)
+        {
+            if (shadow->entries[table][portNum] != NULL)
+            {
+                nvswitch_os_free(shadow->entries[table][portNum]);
+                shadow->entries[table][portNum] = NULL;
+            }
+        }
+    }
 }
 
 /*!
@@ -2666,6 +2884,8 @@ nvswitch_lib_shutdown_device
 
     _nvswitch_destroy_port_event_log(device, &device->log_PORT_EVENTS);
 
+    _nvswitch_destroy_routing_table_shadow(device);
+
     nvswitch_smbpbi_unload(device);
     _nvswitch_destroy_event_list(device);
 
@@ -6267,6 +6487,9 @@ nvswitch_lib_ctrl
         NVSWITCH_DEV_CMD_DISPATCH(CTRL_NVSWITCH_GET_PORT_EVENTS,
                 nvswitch_ctrl_get_port_events,
                 NVSWITCH_GET_PORT_EVENTS_PARAMS);        
+        NVSWITCH_DEV_CMD_DISPATCH(CTRL_NVSWITCH_GET_LOG_DROPPED_COUNTS,
+                _nvswitch_ctrl_get_log_dropped_counts,
+                NVSWITCH_GET_LOG_DROPPED_COUNTS_PARAMS);
         NVSWITCH_DEV_CMD_DISPATCH(CTRL_NVSWITCH_GET_NVLINK_STATUS,
                 _nvswitch_ctrl_get_nvlink_status,
                 NVSWITCH_GET_NVLINK_STATUS_PARAMS);
@@ -2396,6 +2396,153 @@ typedef struct NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_PARAMS {
 #define NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_ENABLE      (0x00000001U)
 #define NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_VERIFY_ONLY (0x00000002U)
 
+/*
+ * NV0000_CTRL_CMD_SYSTEM_GET_RMCTRL_CACHE_STATS
+ *
+ * This API returns per-command RMCTRL cache counters. They are accumulated
+ * across all GPUs since driver load, or since the last reset.
+ *
+ * bReset [IN]
+ *   If NV_TRUE, the counters are cleared after being returned.
+ *
+ * numEntries [OUT]
+ *   Number of valid entries in the entries array.
+ *
+ * entries [OUT]
+ *   cmd
+ *     RMCTRL command the counters apply to.
+ *   hits
+ *     Cache lookups served from the cache.
+ *   misses
+ *     Cache lookups that fell through to the control implementation.
+ *   fills
+ *     Control results stored into the cache.
+ *
+ * Possible status values returned are:
+ *   NV_OK
+ */
+#define NV0000_CTRL_CMD_SYSTEM_GET_RMCTRL_CACHE_STATS (0x149U) /* finn: Evaluated from "(FINN_NV01_ROOT_SYSTEM_INTERFACE_ID << 8) | NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS_MESSAGE_ID" */
+
+#define NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_MAX_ENTRIES 64U
+
+typedef struct NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_ENTRY {
+    NvU32 cmd;
+    NV_DECLARE_ALIGNED(NvU64 hits, 8);
+    NV_DECLARE_ALIGNED(NvU64 misses, 8);
+    NV_DECLARE_ALIGNED(NvU64 fills, 8);
+} NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_ENTRY;
+
+#define NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS_MESSAGE_ID (0x49U)
+
+typedef struct NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS {
+    NvBool bReset;
+    NvU32  numEntries;
+    NV_DECLARE_ALIGNED(NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_ENTRY entries[NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_MAX_ENTRIES], 8);
+} NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS;
+
+/*
+ * NV0000_CTRL_CMD_SYSTEM_GET_GPU_LOCK_PROFILE
+ *
+ * This command returns contention profiling data for the RM GPU locks. Data
+ * is only collected while lock time collection is enabled (see
+ * NV0000_CTRL_CMD_SYSTEM_GET_LOCK_TIMES).
+ *
+ * Wait and hold times are reported as log2 histograms in microseconds.
+ * Bucket 0 counts times below 1us, bucket i counts times in
+ * [2^(i-1), 2^i) us, and the last bucket also counts everything longer.
+ *
+ * gpuInstance [IN]
+ *   GPU instance of the per-GPU lock to report, or
+ *   NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_ALLOC_LOCK for the GPU alloc lock.
+ *
+ * flags [IN]
+ *   NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_FLAGS_RESET
+ *     Clear the data for all locks after it is returned.
+ *
+ * acquireCount [OUT]
+ *   Number of times the lock was acquired.
+ *
+ * contendedCount [OUT]
+ *   Number of acquires that found the lock already held.
+ *
+ * maxWaitNs, maxHoldNs [OUT]
+ *   Longest single wait and hold of the lock, in nanoseconds.
+ *
+ * waitHist, holdHist [OUT]
+ *   Wait and hold time histograms of the lock.
+ *
+ * numModules [OUT]
+ *   Number of valid entries in the modules array.
+ *
+ * modules [OUT]
+ *   Totals and wait and hold time histograms across all GPU locks for each
+ *   RM_LOCK_MODULES_* value passed to the acquire.
+ *
+ * numHolders [OUT]
+ *   Number of valid entries in the holders array.
+ *
+ * holders [OUT]
+ *   Acquire call sites across all GPU locks, sorted by total hold time with
+ *   the largest first. Kernel addresses are not reported: callerOffset is
+ *   the call site's offset from rmGpuLockGetProfile() within the RM text,
+ *   which can be resolved against the symbols of nv-kernel.o.
+ *
+ * droppedSamples [OUT]
+ *   Number of acquires or releases whose module or call site did not fit in
+ *   the tables.
+ *
+ * Possible status values returned are:
+ *   NV_OK
+ *   NV_ERR_INVALID_ARGUMENT
+ *   NV_ERR_NOT_SUPPORTED
+ */
+#define NV0000_CTRL_CMD_SYSTEM_GET_GPU_LOCK_PROFILE (0x14aU) /* finn: Evaluated from "(FINN_NV01_ROOT_SYSTEM_INTERFACE_ID << 8) | NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS_MESSAGE_ID" */
+
+#define NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_ALLOC_LOCK   (0x000000ffU)
+
+#define NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_FLAGS_RESET  (0x00000001U)
+
+#define NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS 24U
+#define NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_MODULES  32U
+#define NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_HOLDERS  16U
+
+typedef struct NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE {
+    NvU32 module;
+    NV_DECLARE_ALIGNED(NvU64 acquireCount, 8);
+    NV_DECLARE_ALIGNED(NvU64 contendedCount, 8);
+    NV_DECLARE_ALIGNED(NvU64 totalWaitNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 totalHoldNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 maxHoldNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 waitHist[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS], 8);
+    NV_DECLARE_ALIGNED(NvU64 holdHist[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS], 8);
+} NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE;
+
+typedef struct NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HOLDER {
+    NV_DECLARE_ALIGNED(NvS64 callerOffset, 8);
+    NvU32 module;
+    NV_DECLARE_ALIGNED(NvU64 holdCount, 8);
+    NV_DECLARE_ALIGNED(NvU64 totalHoldNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 maxHoldNs, 8);
+} NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HOLDER;
+
+#define NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS_MESSAGE_ID (0x4AU)
+
+typedef struct NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS {
+    NvU32 gpuInstance;
+    NvU32 flags;
+    NV_DECLARE_ALIGNED(NvU64 acquireCount, 8);
+    NV_DECLARE_ALIGNED(NvU64 contendedCount, 8);
+    NV_DECLARE_ALIGNED(NvU64 maxWaitNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 maxHoldNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 waitHist[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS], 8);
+    NV_DECLARE_ALIGNED(NvU64 holdHist[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS], 8);
+    NvU32 numModules;
+    NV_DECLARE_ALIGNED(NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE modules[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_MODULES], 8);
+    NvU32 numHolders;
+    NV_DECLARE_ALIGNED(NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HOLDER holders[NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_HOLDERS], 8);
+    NV_DECLARE_ALIGNED(NvU64 droppedSamples, 8);
+} NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS;
+
 /*
  * NV0000_CTRL_CMD_SYSTEM_PFM_REQ_HNDLR_CONTROL
  *
@@ -0,0 +1 @@
+#define NVIDIA_VERSION "590.48.01"
@@ -234,6 +234,18 @@ NvBool nvValidateImpOneDisp(
     NvU32                                   *pMinDramFloorKBPS,
     const NvU32                              modesetRequestedHeadsMask);
 
+void nvPrecomputeImpOneDisp(
+    NVDispEvoPtr                            pDispEvo,
+    NVValidateImpOneDispHeadParamsRec       timingsParams[NVKMS_MAX_HEADS_PER_DISP],
+    NvBool                                  requireBootClocks,
+    NVEvoReallocateBandwidthMode            reallocBandwidth);
+
+void nvInvalidateImpCache(NVDispEvoPtr pDispEvo);
+
+NvBool nvIsImpPrecomputeValid(const NVDispEvoRec *pDispEvo);
+
+void nvInvalidateImpPrecompute(NVDispEvoPtr pDispEvo);
+
 NvBool nvAllocateDisplayBandwidth(
     NVDispEvoPtr pDispEvo,
     NvU32 newIsoBandwidthKBPS,
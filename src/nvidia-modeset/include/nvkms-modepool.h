@@ -35,6 +35,9 @@ void
 nvValidateModeIndex(NVDpyEvoPtr pDpyEvo,
                     const struct NvKmsValidateModeIndexRequest *pRequest,
                     struct NvKmsValidateModeIndexReply *pReply);
+void nvInvalidateModeIndexCache(NVDispEvoPtr pDispEvo);
+void nvFreeModeIndexCache(NVDpyEvoPtr pDpyEvo);
+
 void
 nvValidateModeEvo(NVDpyEvoPtr pDpyEvo,
                   const struct NvKmsValidateModeRequest *pRequest,
@@ -160,6 +160,18 @@ typedef struct _NVEvoModesetUpdateState NVEvoModesetUpdateState;
 typedef struct _NVLockGroup NVLockGroup;
 typedef struct _NVVblankSemControl *NVVblankSemControlPtr;
 
+/*
+ * _NVImpCacheRec is defined in nvkms-evo.c; it is intentionally opaque
+ * outside of the IMP validation code.
+ */
+typedef struct _NVImpCacheRec *NVImpCachePtr;
+
+/*
+ * _NVModeIndexCacheEntryRec is defined in nvkms-modepool.c; it is
+ * intentionally opaque outside of the mode validation code.
+ */
+typedef struct _NVModeIndexCacheEntryRec *NVModeIndexCacheEntryPtr;
+
 /*
  * _NVHs*EvoRec are defined in nvkms-headsurface-priv.h; they are intentionally
  * opaque outside of the nvkms-headsurface code.
@@ -180,6 +192,15 @@ typedef struct _NVEvoApiHandlesRec {
     void **pointers; /* Dynamically allocated array of pointers. */
     NvU32 numPointers; /* Number of elements in pointers array. */
     NvU32 defaultSize;
+    NvU32 numUsed; /* Number of non-NULL elements in pointers array. */
+
+    /*
+     * Free list of unused elements in the pointers array: firstFree is the
+     * handle of the first free element, and nextFree[handle - 1] the handle
+     * of the free element following it.  0 terminates the list.
+     */
+    NvU32 *nextFree;
+    NvU32 firstFree;
 } NVEvoApiHandlesRec;
 
 typedef struct _NVSurfaceDescriptor
@@ -726,6 +747,12 @@ typedef struct {
         NvBool layerPosition[NVKMS_MAX_LAYERS_PER_HEAD];
         NvBool layerSyncObjects[NVKMS_MAX_LAYERS_PER_HEAD];
         NvBool layer[NVKMS_MAX_LAYERS_PER_HEAD];
+
+        /*
+         * The layer changed in a way that may affect the outcome of its
+         * per-layer validation, i.e. more than its surface address.
+         */
+        NvBool layerValidation[NVKMS_MAX_LAYERS_PER_HEAD];
     } dirty;
 } NVFlipEvoHwState;
 
@@ -1160,6 +1187,7 @@ typedef struct _NVEvoDevRec {
     nvkms_timer_handle_t *consoleRestoreTimer;
 
     nvkms_timer_handle_t *lowerDispBandwidthTimer;
+    nvkms_timer_handle_t *precomputeDispBandwidthTimer;
 
     NvU32               simulationType;
 
@@ -1288,6 +1316,15 @@ typedef struct _NVEvoDevRec {
     struct {
         NvU32 numLayers;
     } apiHead[NVKMS_MAX_HEADS_PER_DISP];
+
+    /*
+     * Number of flip requests whose NVFlipEvoHwState was validated in full,
+     * or only for the layers whose validated state changed.
+     */
+    struct {
+        NvU64 full;
+        NvU64 fast;
+    } flipValidation;
 } NVDevEvoRec;
 
 /*
@@ -1977,6 +2014,25 @@ typedef struct _NVDispEvoRec {
     NvU32             isoBandwidthKBPS;
     NvU32             dramFloorKBPS;
 
+    /*
+     * Recent IMP results for configurations validated outside of a modeset,
+     * see nvValidateImpOneDisp().  The cache is allocated on first use and
+     * dropped whenever a modeset changes the configuration of this disp.
+     */
+    struct {
+        NVImpCachePtr pCache;
+        NvU64 hits;
+        NvU64 misses;
+        NvU64 precomputed;
+    } imp;
+
+    /*
+     * Incremented whenever something that mode validation depends on may
+     * have changed for the dpys of this disp; see
+     * nvInvalidateModeIndexCache().
+     */
+    NvU32             modeIndexCacheGeneration;
+
     /*
      * The list of physical connector display IDs.  This is the union
      * of pConnectorEvo->displayId values, which is also the union of
@@ -2247,6 +2303,25 @@ typedef struct _NVDpyEvoRec {
     struct {
         enum NvKmsDpyVRRType type;
     } vrr;
+
+    /*
+     * Replies of nvValidateModeIndex(), indexed by mode index.  They are
+     * only valid for the validation params and the hash of the dpy's EDID
+     * and capabilities recorded here, and while generation matches
+     * pDispEvo->modeIndexCacheGeneration.
+     */
+    struct {
+        NVModeIndexCacheEntryPtr pEntries;
+        NvU32 numEntries;
+
+        struct NvKmsModeValidationParams params;
+        NvU64 dpyHash;
+        NvU32 generation;
+
+        NvU64 hits;
+        NvU64 misses;
+        NvU64 missUsec;
+    } modeIndexCache;
 } NVDpyEvoRec;
 
 static inline NvBool nvDpyEvoIsDPMST(const NVDpyEvoRec *pDpyEvo)
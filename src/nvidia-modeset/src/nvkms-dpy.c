@@ -35,6 +35,7 @@
 #include "nvkms-attributes.h"
 #include "nvkms-utils.h"
 #include "nvkms-3dvision.h"
+#include "nvkms-modepool.h"
 
 #include "nv_mode_timings_utils.h"
 
@@ -2451,6 +2452,7 @@ void nvFreeDpyEvo(NVDispEvoPtr pDispEvo, NVDpyEvoPtr pDpyEvo)
 
     nvListDel(&pDpyEvo->dpyListEntry);
 
+    nvFreeModeIndexCache(pDpyEvo);
     nvFree(pDpyEvo->dp.addressString);
     nvFree(pDpyEvo);
 }
@@ -7828,6 +7828,204 @@ static void AssignNVEvoIsModePossibleDispInput(
     }
 }
 
+#define NV_IMP_CACHE_ENTRIES 8
+
+/*
+ * The IsModePossible() input of a cached IMP query.  The pTimings and pUsage
+ * pointers of the input are cleared and the data they point to is copied
+ * into timings[] and usage[], so that keys can be compared with memcmp.
+ */
+typedef struct {
+    NVEvoIsModePossibleDispInput input;
+    NVHwModeTimingsEvo timings[NVKMS_MAX_HEADS_PER_DISP];
+    struct NvKmsUsageBounds usage[NVKMS_MAX_HEADS_PER_DISP];
+} NVImpCacheKey;
+
+typedef struct _NVImpCacheRec {
+    /* Scratch space for the key being looked up. */
+    NVImpCacheKey key;
+
+    struct {
+        NvBool valid;
+        NVImpCacheKey key;
+        NVEvoIsModePossibleDispOutput output;
+    } entry[NV_IMP_CACHE_ENTRIES];
+
+    /* The entry to replace next; entries are evicted round-robin. */
+    NvU32 nextEntry;
+
+    /*
+     * Whether entry[precomputedEntry] holds the configuration last passed to
+     * nvPrecomputeImpOneDisp(), and its inputs haven't changed since.
+     */
+    NvBool precomputedValid;
+    NvU32 precomputedEntry;
+} NVImpCacheRec;
+
+void nvInvalidateImpCache(NVDispEvoPtr pDispEvo)
+{
+    nvFree(pDispEvo->imp.pCache);
+    pDispEvo->imp.pCache = NULL;
+}
+
+/*!
+ * Build the cache key for pInput and look it up.
+ *
+ * \return  The index of the matching entry, or -1 if there is none.  The key
+ *          is left in pCache->key for ImpCacheInsert().
+ */
+static int ImpCacheLookup(NVImpCacheRec *pCache,
+                          const NVEvoIsModePossibleDispInput *pInput)
+{
+    NVImpCacheKey *pKey = &pCache->key;
+    NvU32 head;
+    int i;
+
+    nvkms_memset(pKey, 0, sizeof(*pKey));
+    nvkms_memcpy(&pKey->input, pInput, sizeof(pKey->input));
+
+    for (head = 0; head < NVKMS_MAX_HEADS_PER_DISP; head++) {
+        if (pInput->head[head].pTimings != NULL) {
+            nvkms_memcpy(&pKey->timings[head], pInput->head[head].pTimings,
+                         sizeof(pKey->timings[head]));
+            pKey->input.head[head].pTimings = NULL;
+        }
+        if (pInput->head[head].pUsage != NULL) {
+            nvkms_memcpy(&pKey->usage[head], pInput->head[head].pUsage,
+                         sizeof(pKey->usage[head]));
+            pKey->input.head[head].pUsage = NULL;
+        }
+    }
+
+    for (i = 0; i < NV_IMP_CACHE_ENTRIES; i++) {
+        if (pCache->entry[i].valid &&
+            (nvkms_memcmp(&pCache->entry[i].key, pKey, sizeof(*pKey)) == 0)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static NvU32 ImpCacheInsert(NVImpCacheRec *pCache,
+                            const NVEvoIsModePossibleDispOutput *pOutput)
+{
+    const NvU32 i = pCache->nextEntry;
+
+    if (pCache->precomputedEntry == i) {
+        pCache->precomputedValid = FALSE;
+    }
+
+    pCache->entry[i].valid = TRUE;
+    nvkms_memcpy(&pCache->entry[i].key, &pCache->key, sizeof(pCache->key));
+    pCache->entry[i].output = *pOutput;
+
+    pCache->nextEntry = (i + 1) % NV_IMP_CACHE_ENTRIES;
+
+    return i;
+}
+
+static NVImpCacheRec *GetImpCache(NVDispEvoPtr pDispEvo)
+{
+    if (pDispEvo->imp.pCache == NULL) {
+        pDispEvo->imp.pCache = nvCalloc(1, sizeof(NVImpCacheRec));
+    }
+
+    return pDispEvo->imp.pCache;
+}
+
+/*!
+ * Call the IsModePossible() HAL, or answer from the IMP cache if the same
+ * query was made since the last modeset on this disp.
+ */
+static void IsModePossibleCached(NVDispEvoPtr pDispEvo,
+                                 const NVEvoIsModePossibleDispInput *pInput,
+                                 NVEvoIsModePossibleDispOutput *pOutput)
+{
+    NVDevEvoPtr pDevEvo = pDispEvo->pDevEvo;
+    NVImpCacheRec *pCache = GetImpCache(pDispEvo);
+    int i;
+
+    if (pCache == NULL) {
+        pDevEvo->hal->IsModePossible(pDispEvo, pInput, pOutput);
+        return;
+    }
+
+    i = ImpCacheLookup(pCache, pInput);
+    if (i >= 0) {
+        *pOutput = pCache->entry[i].output;
+        pDispEvo->imp.hits++;
+        return;
+    }
+
+    pDispEvo->imp.misses++;
+
+    pDevEvo->hal->IsModePossible(pDispEvo, pInput, pOutput);
+
+    ImpCacheInsert(pCache, pOutput);
+}
+
+/*!
+ * Report whether the configuration last passed to nvPrecomputeImpOneDisp() is
+ * still in the IMP cache, and nvInvalidateImpPrecompute() hasn't been called
+ * since.
+ */
+NvBool nvIsImpPrecomputeValid(const NVDispEvoRec *pDispEvo)
+{
+    return (pDispEvo->imp.pCache != NULL) &&
+           pDispEvo->imp.pCache->precomputedValid;
+}
+
+/*!
+ * Note that an input of the precomputed configuration has changed, so that
+ * the next nvScheduleLowerDispBandwidthTimer() precomputes it again.
+ */
+void nvInvalidateImpPrecompute(NVDispEvoPtr pDispEvo)
+{
+    if (pDispEvo->imp.pCache != NULL) {
+        pDispEvo->imp.pCache->precomputedValid = FALSE;
+    }
+}
+
+/*!
+ * Run IMP for the described disp configuration ahead of time, so that a
+ * later nvValidateImpOneDisp() call with the same arguments is answered
+ * from the IMP cache.  No display bandwidth is allocated.
+ */
+void nvPrecomputeImpOneDisp(
+    NVDispEvoPtr                            pDispEvo,
+    NVValidateImpOneDispHeadParamsRec       timingsParams[NVKMS_MAX_HEADS_PER_DISP],
+    NvBool                                  requireBootClocks,
+    NVEvoReallocateBandwidthMode            reallocBandwidth)
+{
+    NVDevEvoPtr pDevEvo = pDispEvo->pDevEvo;
+    NVEvoIsModePossibleDispInput impInput = { };
+    NVEvoIsModePossibleDispOutput impOutput = { };
+    NVImpCacheRec *pCache = GetImpCache(pDispEvo);
+    int i;
+
+    if (pCache == NULL) {
+        return;
+    }
+
+    AssignNVEvoIsModePossibleDispInput(pDispEvo,
+                                       timingsParams, requireBootClocks,
+                                       reallocBandwidth,
+                                       &impInput,
+                                       0x0 /* modesetRequestedHeadsMask */);
+
+    i = ImpCacheLookup(pCache, &impInput);
+    if (i < 0) {
+        pDevEvo->hal->IsModePossible(pDispEvo, &impInput, &impOutput);
+
+        i = ImpCacheInsert(pCache, &impOutput);
+        pDispEvo->imp.precomputed++;
+    }
+
+    pCache->precomputedEntry = i;
+    pCache->precomputedValid = TRUE;
+}
+
 /*!
  * Validate the described disp configuration through IMP.
 
@@ -7895,7 +8093,15 @@ NvBool nvValidateImpOneDisp(
                                        &impInput,
                                        modesetRequestedHeadsMask);
 
-    pDevEvo->hal->IsModePossible(pDispEvo, &impInput, &impOutput);
+    /*
+     * Queries for a modeset pick DSC slice counts and tile configurations for
+     * the heads being modeset; only cache the ones that don't.
+     */
+    if (modesetRequestedHeadsMask == 0x0) {
+        IsModePossibleCached(pDispEvo, &impInput, &impOutput);
+    } else {
+        pDevEvo->hal->IsModePossible(pDispEvo, &impInput, &impOutput);
+    }
     if (!impOutput.possible) {
         return FALSE;
     }
@@ -667,6 +667,111 @@ static NvBool UpdateFlipLutHwState(
         } \
      }
 
+/*
+ * The subset of NVFlipChannelEvoHwState that the per-layer checks in
+ * nvValidateFlipEvoHwState() depend on.
+ */
+typedef struct {
+    NVSurfaceEvoPtr pSurfaceEvo[NVKMS_MAX_EYES];
+    struct NvKmsSize sizeIn;
+    struct NvKmsSize sizeOut;
+    NvBool inputLutEnabled;
+    NvBool tmoLutEnabled;
+    enum NvKmsInputColorSpace colorSpace;
+    enum NvKmsInputTf tf;
+} NVFlipLayerValidationInputs;
+
+static void GetLayerValidationInputs(
+    const NVFlipChannelEvoHwState *pHwState,
+    NVFlipLayerValidationInputs *pInputs)
+{
+    NvU32 eye;
+
+    for (eye = 0; eye < NVKMS_MAX_EYES; eye++) {
+        pInputs->pSurfaceEvo[eye] = pHwState->pSurfaceEvo[eye];
+    }
+
+    pInputs->sizeIn = pHwState->sizeIn;
+    pInputs->sizeOut = pHwState->sizeOut;
+    pInputs->inputLutEnabled = (pHwState->inputLut.pLutSurfaceEvo != NULL);
+    pInputs->tmoLutEnabled = (pHwState->tmoLut.pLutSurfaceEvo != NULL);
+    pInputs->colorSpace = pHwState->colorSpace;
+    pInputs->tf = pHwState->tf;
+}
+
+/*
+ * Return TRUE if the two surfaces are interchangeable as far as flip
+ * validation is concerned: same dimensions, format, layout and pitches.
+ */
+static NvBool SurfacesValidateAlike(const NVSurfaceEvoRec *pSurfaceEvoA,
+                                    const NVSurfaceEvoRec *pSurfaceEvoB)
+{
+    NvU8 planeIndex;
+
+    if (pSurfaceEvoA == pSurfaceEvoB) {
+        return TRUE;
+    }
+
+    if ((pSurfaceEvoA == NULL) || (pSurfaceEvoB == NULL)) {
+        return FALSE;
+    }
+
+    if ((pSurfaceEvoA->widthInPixels != pSurfaceEvoB->widthInPixels) ||
+        (pSurfaceEvoA->heightInPixels != pSurfaceEvoB->heightInPixels) ||
+        (pSurfaceEvoA->format != pSurfaceEvoB->format) ||
+        (pSurfaceEvoA->layout != pSurfaceEvoB->layout)) {
+        return FALSE;
+    }
+
+    FOR_ALL_VALID_PLANES(planeIndex, pSurfaceEvoA) {
+        if (pSurfaceEvoA->planes[planeIndex].pitch !=
+            pSurfaceEvoB->planes[planeIndex].pitch) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Return TRUE if a layer whose validated state was pOld needs to be
+ * validated again with the state pHwState.
+ *
+ * A layer that only flips to a different, but alike, surface does not:
+ * every per-layer check depends on the surface only through the
+ * properties compared by SurfacesValidateAlike().  A disabled layer always
+ * does, since its notifier and semaphore surfaces are validated too.
+ */
+static NvBool LayerNeedsValidation(
+    const NVFlipLayerValidationInputs *pOld,
+    const NVFlipChannelEvoHwState *pHwState)
+{
+    NVFlipLayerValidationInputs new;
+    NvU32 eye;
+
+    GetLayerValidationInputs(pHwState, &new);
+
+    if (new.pSurfaceEvo[NVKMS_LEFT] == NULL) {
+        return TRUE;
+    }
+
+    for (eye = 0; eye < NVKMS_MAX_EYES; eye++) {
+        if (!SurfacesValidateAlike(pOld->pSurfaceEvo[eye],
+                                   new.pSurfaceEvo[eye])) {
+            return TRUE;
+        }
+    }
+
+    return (pOld->sizeIn.width != new.sizeIn.width) ||
+           (pOld->sizeIn.height != new.sizeIn.height) ||
+           (pOld->sizeOut.width != new.sizeOut.width) ||
+           (pOld->sizeOut.height != new.sizeOut.height) ||
+           (pOld->inputLutEnabled != new.inputLutEnabled) ||
+           (pOld->tmoLutEnabled != new.tmoLutEnabled) ||
+           (pOld->colorSpace != new.colorSpace) ||
+           (pOld->tf != new.tf);
+}
+
 static NvBool UpdateLayerFlipEvoHwStateCommon(
     const struct NvKmsPerOpenDev *pOpenDev,
     NVDevEvoRec *pDevEvo,
@@ -680,8 +785,11 @@ static NvBool UpdateLayerFlipEvoHwStateCommon(
     NVFlipChannelEvoHwState *pHwState = &pFlipState->layer[layer];
     const NVEvoApiHandlesRec *pOpenDevSurfaceHandles =
         nvGetSurfaceHandlesFromOpenDevConst(pOpenDev);
+    NVFlipLayerValidationInputs oldValidationInputs;
     NvBool ret;
 
+    GetLayerValidationInputs(pHwState, &oldValidationInputs);
+
     if (pParams->layer[layer].surface.specified) {
         ret = nvAssignSurfaceArray(pDevEvo,
                                    pOpenDevSurfaceHandles,
@@ -1025,6 +1133,10 @@ static NvBool UpdateLayerFlipEvoHwStateCommon(
 
     pFlipState->dirty.layer[layer] = TRUE;
 
+    if (LayerNeedsValidation(&oldValidationInputs, pHwState)) {
+        pFlipState->dirty.layerValidation[layer] = TRUE;
+    }
+
     return TRUE;
 }
 
@@ -1064,6 +1176,8 @@ static NvBool UpdateMainLayerFlipEvoHwState(
         pHwState->inputLut.offset = offsetof(NVEvoLutDataRec, base);
         pHwState->inputLut.lutEntries = NV_NUM_EVO_LUT_ENTRIES;
         pHwState->inputLut.vssSegments = 0;
+
+        pFlipState->dirty.layerValidation[NVKMS_MAIN_LAYER] = TRUE;
     }
 
     if (pParams->layer[NVKMS_MAIN_LAYER].csc.specified) {
@@ -1785,20 +1899,49 @@ static NvU32 ValidateCompositionDepth(const NVFlipEvoHwState *pFlipState,
 
 /*!
  * Perform validation of the the given NVFlipEvoHwState.
+ *
+ * If 'changedLayersOnly' is TRUE, pFlipState must have been derived, through
+ * nvUpdateFlipEvoHwState() and with the same pTimings, from an
+ * NVFlipEvoHwState that already passed validation.  The per-layer checks are
+ * then skipped for layers whose state did not change in a way that could
+ * affect them (see LayerNeedsValidation()); the cross-layer and head checks
+ * are always performed.  *pSkippedLayers reports whether any layer was
+ * skipped.
  */
-NvBool nvValidateFlipEvoHwState(
+static NvBool ValidateFlipEvoHwState(
     const NVDevEvoRec *pDevEvo,
     const NvU32 head,
     const NVHwModeTimingsEvo *pTimings,
-    const NVFlipEvoHwState *pFlipState)
+    const NVFlipEvoHwState *pFlipState,
+    const NvBool changedLayersOnly,
+    NvBool *pSkippedLayers)
 {
     NvU32 layer;
 
+    *pSkippedLayers = FALSE;
+
     for (layer = 0; layer < pDevEvo->head[head].numLayers; layer++) {
+        const NvBool validateLayer =
+            !changedLayersOnly ||
+            pFlipState->dirty.layerValidation[layer] ||
+            ((layer == NVKMS_MAIN_LAYER) && pFlipState->dirty.viewPortPointIn);
+
         if (!ValidateCompositionDepth(pFlipState, layer)) {
             return FALSE;
         }
 
+        if (!validateLayer) {
+            /* Still check that overlays are not enabled without main. */
+            if ((layer != NVKMS_MAIN_LAYER) &&
+                (pFlipState->layer[NVKMS_MAIN_LAYER].pSurfaceEvo[NVKMS_LEFT] == NULL) &&
+                (pFlipState->layer[layer].pSurfaceEvo[NVKMS_LEFT] != NULL)) {
+                return FALSE;
+            }
+
+            *pSkippedLayers = TRUE;
+            continue;
+        }
+
         if (layer == NVKMS_MAIN_LAYER) {
             if (!ValidateMainFlipChannelEvoHwState(pDevEvo,
                                                    &pFlipState->layer[layer],
@@ -1854,6 +1997,19 @@ NvBool nvValidateFlipEvoHwState(
                                &pTimings->viewPort.possibleUsage);
 }
 
+NvBool nvValidateFlipEvoHwState(
+    const NVDevEvoRec *pDevEvo,
+    const NvU32 head,
+    const NVHwModeTimingsEvo *pTimings,
+    const NVFlipEvoHwState *pFlipState)
+{
+    NvBool skippedLayers;
+
+    return ValidateFlipEvoHwState(pDevEvo, head, pTimings, pFlipState,
+                                  FALSE /* changedLayersOnly */,
+                                  &skippedLayers);
+}
+
 /*
  * Record in the updateState that the given channel needs interlocked
  * window immediate updates.
@@ -2194,6 +2350,15 @@ void nvFlipEvoOneHead(
         nvPopEvoSubDevMask(pDevEvo);
     }
 
+    /*
+     * The target usage bounds are an input of the configuration precomputed
+     * for LowerDispBandwidth().
+     */
+    if (nvkms_memcmp(&pSdHeadState->targetUsage, &pFlipState->usage,
+                     sizeof(pSdHeadState->targetUsage)) != 0) {
+        nvInvalidateImpPrecompute(pDevEvo->gpus[sd].pDispEvo);
+    }
+
     pSdHeadState->targetUsage = pFlipState->usage;
 
     pSdHeadState->targetDisableMidFrameAndDWCFWatermark =
@@ -2552,35 +2717,30 @@ static void PreFlipIMP(NVDevEvoPtr pDevEvo,
     }
 }
 
-static void LowerDispBandwidth(void *dataPtr, NvU32 dataU32)
+/*!
+ * Describe the current configuration of the SOC display for IMP, with the
+ * usage bounds of each head being the union of its guaranteed usage bounds
+ * and its current (or, if useTargetUsage, target) usage bounds.
+ */
+static void AssignDispBandwidthParams(
+    NVDispEvoPtr pDispEvo,
+    const NvBool useTargetUsage,
+    NVValidateImpOneDispHeadParamsRec timingsParams[NVKMS_MAX_HEADS_PER_DISP],
+    struct NvKmsUsageBounds guaranteedAndCurrent[NVKMS_MAX_HEADS_PER_DISP])
 {
-    NVValidateImpOneDispHeadParamsRec timingsParams[NVKMS_MAX_HEADS_PER_DISP];
-    struct NvKmsUsageBounds *guaranteedAndCurrent;
-    NVDevEvoPtr pDevEvo = dataPtr;
-    NVDispEvoPtr pDispEvo;
+    NVDevEvoPtr pDevEvo = pDispEvo->pDevEvo;
     NvU32 head;
-    NvBool ret;
-
-    guaranteedAndCurrent =
-        nvCalloc(1, sizeof(*guaranteedAndCurrent) * NVKMS_MAX_HEADS_PER_DISP);
-    if (guaranteedAndCurrent == NULL) {
-        nvAssert(guaranteedAndCurrent != NULL);
-        return;
-    }
 
-    nvkms_memset(&timingsParams, 0, sizeof(timingsParams));
-
-    pDispEvo = pDevEvo->pDispEvo[0];
-
-    // SOC Display never has more than one disp
-    nvAssert(pDevEvo->nDispEvo == 1);
+    nvkms_memset(timingsParams, 0,
+                 sizeof(*timingsParams) * NVKMS_MAX_HEADS_PER_DISP);
 
     for (head = 0; head < pDevEvo->numHeads; head++) {
         NVDispHeadStateEvoRec *pHeadState =
             &pDispEvo->headState[head];
         const struct NvKmsUsageBounds *pGuaranteed =
             &pHeadState->timings.viewPort.guaranteedUsage;
-        const struct NvKmsUsageBounds *pCurrent =
+        const struct NvKmsUsageBounds *pCurrent = useTargetUsage ?
+            &pDevEvo->gpus[0].headState[head].targetUsage :
             &pDevEvo->gpus[0].headState[head].usage;
 
         if (pHeadState->activeRmId == 0) {
@@ -2603,6 +2763,31 @@ static void LowerDispBandwidth(void *dataPtr, NvU32 dataU32)
         nvUnionUsageBounds(pGuaranteed, pCurrent, &guaranteedAndCurrent[head]);
         timingsParams[head].pUsage = &guaranteedAndCurrent[head];
     }
+}
+
+static void LowerDispBandwidth(void *dataPtr, NvU32 dataU32)
+{
+    NVValidateImpOneDispHeadParamsRec timingsParams[NVKMS_MAX_HEADS_PER_DISP];
+    struct NvKmsUsageBounds *guaranteedAndCurrent;
+    NVDevEvoPtr pDevEvo = dataPtr;
+    NVDispEvoPtr pDispEvo;
+    NvU32 head;
+    NvBool ret;
+
+    guaranteedAndCurrent =
+        nvCalloc(1, sizeof(*guaranteedAndCurrent) * NVKMS_MAX_HEADS_PER_DISP);
+    if (guaranteedAndCurrent == NULL) {
+        nvAssert(guaranteedAndCurrent != NULL);
+        return;
+    }
+
+    pDispEvo = pDevEvo->pDispEvo[0];
+
+    // SOC Display never has more than one disp
+    nvAssert(pDevEvo->nDispEvo == 1);
+
+    AssignDispBandwidthParams(pDispEvo, FALSE /* useTargetUsage */,
+                              timingsParams, guaranteedAndCurrent);
 
     ret = nvValidateImpOneDisp(pDispEvo, timingsParams,
                                FALSE /* requireBootClocks */,
@@ -2622,10 +2807,45 @@ static void LowerDispBandwidth(void *dataPtr, NvU32 dataU32)
     nvFree(guaranteedAndCurrent);
 }
 
+/*!
+ * Run IMP for the configuration LowerDispBandwidth() will most likely see:
+ * by the time it fires, the post-flip IMP timer will normally have lowered
+ * the usage bounds of each head to its target usage bounds.  This runs from
+ * its own timer so that it stays off the flip path.
+ *
+ * The configuration only changes with the target usage bounds of a head or
+ * with a modeset, which invalidate the precomputed result.
+ */
+static void PrecomputeDispBandwidth(void *dataPtr, NvU32 dataU32)
+{
+    NVValidateImpOneDispHeadParamsRec timingsParams[NVKMS_MAX_HEADS_PER_DISP];
+    struct NvKmsUsageBounds *guaranteedAndTarget;
+    NVDevEvoPtr pDevEvo = dataPtr;
+    NVDispEvoPtr pDispEvo = pDevEvo->pDispEvo[0];
+
+    guaranteedAndTarget =
+        nvCalloc(1, sizeof(*guaranteedAndTarget) * NVKMS_MAX_HEADS_PER_DISP);
+    if (guaranteedAndTarget == NULL) {
+        return;
+    }
+
+    AssignDispBandwidthParams(pDispEvo, TRUE /* useTargetUsage */,
+                              timingsParams, guaranteedAndTarget);
+
+    nvPrecomputeImpOneDisp(pDispEvo, timingsParams,
+                           FALSE /* requireBootClocks */,
+                           NV_EVO_REALLOCATE_BANDWIDTH_MODE_POST);
+
+    nvFree(guaranteedAndTarget);
+}
+
 void nvCancelLowerDispBandwidthTimer(NVDevEvoPtr pDevEvo)
 {
     nvkms_free_timer(pDevEvo->lowerDispBandwidthTimer);
     pDevEvo->lowerDispBandwidthTimer = NULL;
+
+    nvkms_free_timer(pDevEvo->precomputeDispBandwidthTimer);
+    pDevEvo->precomputeDispBandwidthTimer = NULL;
 }
 
 void nvScheduleLowerDispBandwidthTimer(NVDevEvoPtr pDevEvo)
@@ -2639,6 +2859,14 @@ void nvScheduleLowerDispBandwidthTimer(NVDevEvoPtr pDevEvo)
                           pDevEvo,
                           0, /* dataU32 */
                           30000000 /* 30 seconds */);
+
+    if (!nvIsImpPrecomputeValid(pDevEvo->pDispEvo[0])) {
+        pDevEvo->precomputeDispBandwidthTimer =
+            nvkms_alloc_timer(PrecomputeDispBandwidth,
+                              pDevEvo,
+                              0, /* dataU32 */
+                              0 /* usec */);
+    }
 }
 
 /*!
@@ -3107,6 +3335,7 @@ NvBool nvAssignNVFlipEvoHwState(NVDevEvoRec *pDevEvo,
     const NVDispHeadStateEvoRec *pHeadState = &pDispEvo->headState[head];
     const struct NvKmsUsageBounds *pPossibleUsage =
         &pHeadState->timings.viewPort.possibleUsage;
+    NvBool skippedLayers;
 
     if (!nvUpdateFlipEvoHwState(pOpenDev, pDevEvo, sd, head, pParams,
                                 &pHeadState->timings,
@@ -3117,11 +3346,24 @@ NvBool nvAssignNVFlipEvoHwState(NVDevEvoRec *pDevEvo,
 
     nvOverrideScalingUsageBounds(pDevEvo, head, pFlipHwState, pPossibleUsage);
 
-    if (!nvValidateFlipEvoHwState(pDevEvo, head, &pHeadState->timings,
-                                  pFlipHwState)) {
+    /*
+     * pFlipHwState was initialized from the current, validated, hardware
+     * state of the head, so only the layers changed by this flip need to be
+     * validated again.
+     */
+    if (!ValidateFlipEvoHwState(pDevEvo, head, &pHeadState->timings,
+                                pFlipHwState,
+                                TRUE /* changedLayersOnly */,
+                                &skippedLayers)) {
         return FALSE;
     }
 
+    if (skippedLayers) {
+        pDevEvo->flipValidation.fast++;
+    } else {
+        pDevEvo->flipValidation.full++;
+    }
+
     return TRUE;
 }
 
@@ -94,6 +94,183 @@ static NvBool ValidateMode(NVDpyEvoPtr pDpyEvo,
     (NV_MAX_RANGE_ELEMENT_STRING_LEN * NVKMS_MAX_VALID_SYNC_RANGES)
 
 
+/*
+ * Mode indices past this are validated every time rather than cached; no
+ * dpy has anywhere near this many EDID and VESA modes.
+ */
+#define NV_MODE_INDEX_CACHE_MAX_ENTRIES 1024
+
+typedef struct _NVModeIndexCacheEntryRec {
+    NvBool valid;
+    struct NvKmsValidateModeIndexReply reply;
+} NVModeIndexCacheEntryRec;
+
+/*!
+ * Invalidate the cached nvValidateModeIndex() replies of all dpys on the
+ * disp.  This must be called whenever state that mode validation depends
+ * on, and that HashDpyState() does not cover, may change: DisplayPort
+ * topology and bandwidth, and the heads in use.
+ */
+void nvInvalidateModeIndexCache(NVDispEvoPtr pDispEvo)
+{
+    pDispEvo->modeIndexCacheGeneration++;
+}
+
+void nvFreeModeIndexCache(NVDpyEvoPtr pDpyEvo)
+{
+    nvFree(pDpyEvo->modeIndexCache.pEntries);
+    pDpyEvo->modeIndexCache.pEntries = NULL;
+    pDpyEvo->modeIndexCache.numEntries = 0;
+}
+
+/* 64-bit FNV-1a */
+#define NV_MODE_INDEX_CACHE_HASH_INIT 14695981039346656037ULL
+
+static NvU64 HashBytes(NvU64 hash, const void *pData, size_t size)
+{
+    const NvU8 *pBytes = pData;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= pBytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/*!
+ * Hash the dpy state that mode validation depends on and that
+ * nvDpyGetDynamicData() may update: the EDID, connection state, pixel clock
+ * limits and sink capabilities.
+ */
+static NvU64 HashDpyState(const NVDpyEvoRec *pDpyEvo)
+{
+    const NvBool connected =
+        nvDpyIdIsInDpyIdList(pDpyEvo->id, pDpyEvo->pDispEvo->connectedDisplays);
+    const NvBool allowDVISpecPClkOverride = pDpyEvo->allowDVISpecPClkOverride;
+    const NvBool hdmiCapable = pDpyEvo->hdmiCapable;
+    const NvBool stereo3DVisionSupported = pDpyEvo->stereo3DVision.supported;
+    const NvBool stereo3DVisionPatching =
+        pDpyEvo->stereo3DVision.requiresModetimingPatching;
+    NvU64 hash = NV_MODE_INDEX_CACHE_HASH_INIT;
+
+    hash = HashBytes(hash, pDpyEvo->edid.buffer, pDpyEvo->edid.length);
+    hash = HashBytes(hash, &connected, sizeof(connected));
+    hash = HashBytes(hash, &allowDVISpecPClkOverride,
+                     sizeof(allowDVISpecPClkOverride));
+    hash = HashBytes(hash, &hdmiCapable, sizeof(hdmiCapable));
+    hash = HashBytes(hash, &stereo3DVisionSupported,
+                     sizeof(stereo3DVisionSupported));
+    hash = HashBytes(hash, &stereo3DVisionPatching,
+                     sizeof(stereo3DVisionPatching));
+    hash = HashBytes(hash, &pDpyEvo->maxPixelClockKHz,
+                     sizeof(pDpyEvo->maxPixelClockKHz));
+    hash = HashBytes(hash, &pDpyEvo->maxSingleLinkPixelClockKHz,
+                     sizeof(pDpyEvo->maxSingleLinkPixelClockKHz));
+    hash = HashBytes(hash, &pDpyEvo->dp.inbandStereoSignaling,
+                     sizeof(pDpyEvo->dp.inbandStereoSignaling));
+    hash = HashBytes(hash, &pDpyEvo->dp.laneCount,
+                     sizeof(pDpyEvo->dp.laneCount));
+    hash = HashBytes(hash, &pDpyEvo->dp.linkRate10MHz,
+                     sizeof(pDpyEvo->dp.linkRate10MHz));
+    hash = HashBytes(hash, &pDpyEvo->hdmi.srcCaps,
+                     sizeof(pDpyEvo->hdmi.srcCaps));
+    hash = HashBytes(hash, &pDpyEvo->hdmi.sinkCaps,
+                     sizeof(pDpyEvo->hdmi.sinkCaps));
+    hash = HashBytes(hash, &pDpyEvo->colorSpaceCaps,
+                     sizeof(pDpyEvo->colorSpaceCaps));
+    hash = HashBytes(hash, &pDpyEvo->vrr.type, sizeof(pDpyEvo->vrr.type));
+
+    return hash;
+}
+
+/*!
+ * Return whether the cached replies of pDpyEvo were computed with pParams,
+ * the dpy state with hash dpyHash, and the current state of the disp.
+ */
+static NvBool ModeIndexCacheIsCurrent(const NVDpyEvoRec *pDpyEvo,
+                                      const struct NvKmsModeValidationParams *pParams,
+                                      const NvU64 dpyHash)
+{
+    return (pDpyEvo->modeIndexCache.pEntries != NULL) &&
+           (pDpyEvo->modeIndexCache.generation ==
+            pDpyEvo->pDispEvo->modeIndexCacheGeneration) &&
+           (pDpyEvo->modeIndexCache.dpyHash == dpyHash) &&
+           (nvkms_memcmp(&pDpyEvo->modeIndexCache.params, pParams,
+                         sizeof(*pParams)) == 0);
+}
+
+static const struct NvKmsValidateModeIndexReply *LookupModeIndexCache(
+    const NVDpyEvoRec *pDpyEvo,
+    const struct NvKmsModeValidationParams *pParams,
+    const NvU64 dpyHash,
+    const NvU32 modeIndex)
+{
+    const NVModeIndexCacheEntryRec *pEntry;
+
+    if (!ModeIndexCacheIsCurrent(pDpyEvo, pParams, dpyHash) ||
+        (modeIndex >= pDpyEvo->modeIndexCache.numEntries)) {
+        return NULL;
+    }
+
+    pEntry = &pDpyEvo->modeIndexCache.pEntries[modeIndex];
+
+    return pEntry->valid ? &pEntry->reply : NULL;
+}
+
+static void InsertModeIndexCache(
+    NVDpyEvoPtr pDpyEvo,
+    const struct NvKmsModeValidationParams *pParams,
+    const NvU64 dpyHash,
+    const NvU32 modeIndex,
+    const struct NvKmsValidateModeIndexReply *pReply)
+{
+    NVModeIndexCacheEntryRec *pEntries = pDpyEvo->modeIndexCache.pEntries;
+    NvU32 numEntries = pDpyEvo->modeIndexCache.numEntries;
+
+    if (modeIndex >= NV_MODE_INDEX_CACHE_MAX_ENTRIES) {
+        return;
+    }
+
+    if (!ModeIndexCacheIsCurrent(pDpyEvo, pParams, dpyHash)) {
+        if (pEntries != NULL) {
+            nvkms_memset(pEntries, 0, sizeof(*pEntries) * numEntries);
+        }
+        pDpyEvo->modeIndexCache.params = *pParams;
+        pDpyEvo->modeIndexCache.dpyHash = dpyHash;
+        pDpyEvo->modeIndexCache.generation =
+            pDpyEvo->pDispEvo->modeIndexCacheGeneration;
+    }
+
+    if (modeIndex >= numEntries) {
+        NvU32 newNumEntries = NV_MAX(NV_MAX(numEntries * 2, 32), modeIndex + 1);
+
+        newNumEntries = NV_MIN(newNumEntries, NV_MODE_INDEX_CACHE_MAX_ENTRIES);
+
+        pEntries = nvRealloc(pEntries, sizeof(*pEntries) * newNumEntries);
+        if (pEntries == NULL) {
+            return;
+        }
+
+        nvkms_memset(&pEntries[numEntries], 0,
+                     sizeof(*pEntries) * (newNumEntries - numEntries));
+
+        pDpyEvo->modeIndexCache.pEntries = pEntries;
+        pDpyEvo->modeIndexCache.numEntries = newNumEntries;
+    }
+
+    pEntries[modeIndex].valid = TRUE;
+    pEntries[modeIndex].reply = *pReply;
+}
+
+/*!
+ * Validate the mode with the given index in the dpy's mode pool.
+ *
+ * Clients enumerate the mode pool one index at a time, and do so again on
+ * every hotplug and from every client, so replies are cached per dpy.
+ * Requests that ask for the mode validation log bypass the cache.
+ */
 void
 nvValidateModeIndex(NVDpyEvoPtr pDpyEvo,
                     const struct NvKmsValidateModeIndexRequest *pRequest,
@@ -101,10 +278,28 @@ nvValidateModeIndex(NVDpyEvoPtr pDpyEvo,
 {
     const struct NvKmsModeValidationParams *pParams = &pRequest->modeValidation;
     const NvU32 requestedModeIndex = pRequest->modeIndex;
+    const NvBool useCache = (pRequest->infoStringSize == 0);
     NVEvoInfoStringRec infoString;
     NvU32 currentModeIndex = 0;
+    NvU64 dpyHash = 0;
+    NvU64 startUsec = 0;
     NvBool done;
 
+    if (useCache) {
+        const struct NvKmsValidateModeIndexReply *pCachedReply;
+
+        dpyHash = HashDpyState(pDpyEvo);
+        pCachedReply = LookupModeIndexCache(pDpyEvo, pParams, dpyHash,
+                                            requestedModeIndex);
+        if (pCachedReply != NULL) {
+            *pReply = *pCachedReply;
+            pDpyEvo->modeIndexCache.hits++;
+            return;
+        }
+
+        startUsec = nvkms_get_usec();
+    }
+
     nvkms_memset(pReply, 0, sizeof(*pReply));
 
     nvInitInfoString(&infoString, nvKmsNvU64ToPointer(pRequest->pInfoString),
@@ -112,25 +307,26 @@ nvValidateModeIndex(NVDpyEvoPtr pDpyEvo,
 
     done = ValidateModeIndexEdid(pDpyEvo, pParams, pReply, &infoString,
                                  requestedModeIndex, &currentModeIndex);
-    if (done) {
-        goto out;
-    }
-
-    done = ValidateModeIndexVesa(pDpyEvo, pParams, pReply, &infoString,
-                                 requestedModeIndex, &currentModeIndex);
-    if (done) {
-        goto out;
+    if (!done) {
+        done = ValidateModeIndexVesa(pDpyEvo, pParams, pReply, &infoString,
+                                     requestedModeIndex, &currentModeIndex);
     }
 
-    pReply->end = 1;
-    return;
-
-out:
-    if (pRequest->infoStringSize > 0) {
+    if (!done) {
+        pReply->end = 1;
+    } else if (pRequest->infoStringSize > 0) {
         /* Add 1 for the final '\0' */
         nvAssert((infoString.length + 1) <= pRequest->infoStringSize);
         pReply->infoStringLenWritten = infoString.length + 1;
     }
+
+    if (useCache) {
+        pDpyEvo->modeIndexCache.misses++;
+        pDpyEvo->modeIndexCache.missUsec += nvkms_get_usec() - startUsec;
+
+        InsertModeIndexCache(pDpyEvo, pParams, dpyHash, requestedModeIndex,
+                             pReply);
+    }
 }
 
 
@@ -3378,6 +3378,13 @@ ApplyProposedModeSetHwStateOneDisp(
     nvkms_memset(&pWorkArea->modesetUpdateState, 0,
                  sizeof(pWorkArea->modesetUpdateState));
 
+    /*
+     * IMP and mode validation results cached for the old configuration no
+     * longer apply.
+     */
+    nvInvalidateImpCache(pDispEvo);
+    nvInvalidateModeIndexCache(pDispEvo);
+
     /* Record the current flip state. */
     for (head = 0; head < NVKMS_MAX_HEADS_PER_DISP; head++) {
         nvInitFlipEvoHwState(pDevEvo, sd, head,
@@ -301,6 +301,8 @@ static void FreeDisplay(NVDispEvoPtr pDispEvo)
 
     nvkms_free_ref_ptr(pDispEvo->ref_ptr);
 
+    nvInvalidateImpCache(pDispEvo);
+
     nvInvalidateRasterLockGroupsEvo();
     nvFree(pDispEvo);
 }
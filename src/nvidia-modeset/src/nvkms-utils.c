@@ -203,7 +203,9 @@ void nvEvoLogInfoString(NVEvoInfoStringPtr pInfoString,
  * object by handle, and NVKMS will look up the corresponding object.
  *
  * We store a pointer to the object in a dynamically allocated array,
- * and use the handle to look up the pointer in the array.
+ * and use the handle to look up the pointer in the array.  Unused
+ * elements of the array are kept on a free list, so that creating and
+ * destroying handles does not need to scan the array.
  *
  * Note that handles are 1-based (valid handles are in the range
  * [1,numPointers], and 0 is an invalid handle), while indices to the
@@ -212,11 +214,32 @@ void nvEvoLogInfoString(NVEvoInfoStringPtr pInfoString,
  * for the pointer.
  */
 
+/*!
+ * Rebuild the free list from scratch, in increasing handle order, so that
+ * the lowest free handles are handed out first.
+ */
+static void ResetApiHandlesFreeList(NVEvoApiHandlesPtr pEvoApiHandles)
+{
+    NvU32 index = pEvoApiHandles->numPointers;
+
+    pEvoApiHandles->firstFree = 0;
+
+    while (index > 0) {
+        index--;
+
+        if (pEvoApiHandles->pointers[index] == NULL) {
+            pEvoApiHandles->nextFree[index] = pEvoApiHandles->firstFree;
+            pEvoApiHandles->firstFree = index + 1;
+        }
+    }
+}
+
+
 /*!
  * Increase the size of the NVEvoApiHandles::pointers array.
  *
  * Reallocate the pointers array, increasing by defaultSize.
- * Initialize the new region of memory.
+ * Initialize the new region of memory, and add it to the free list.
  */
 static NvBool GrowApiHandlesPointersArray(NVEvoApiHandlesPtr pEvoApiHandles)
 {
@@ -225,12 +248,23 @@ static NvBool GrowApiHandlesPointersArray(NVEvoApiHandlesPtr pEvoApiHandles)
     size_t oldSize = pEvoApiHandles->numPointers * sizeof(void *);
     size_t newSize = newNumPointers * sizeof(void *);
     void **newPointers;
+    NvU32 *newNextFree;
+    NvU32 index;
 
     /* Check for wrap in the newNumPointers computation. */
     if (newSize <= oldSize) {
         return FALSE;
     }
 
+    newNextFree = nvRealloc(pEvoApiHandles->nextFree,
+                            newNumPointers * sizeof(NvU32));
+
+    if (newNextFree == NULL) {
+        return FALSE;
+    }
+
+    pEvoApiHandles->nextFree = newNextFree;
+
     newPointers = nvRealloc(pEvoApiHandles->pointers, newSize);
 
     if (newPointers == NULL) {
@@ -239,6 +273,17 @@ static NvBool GrowApiHandlesPointersArray(NVEvoApiHandlesPtr pEvoApiHandles)
 
     nvkms_memset(&newPointers[pEvoApiHandles->numPointers], 0, newSize - oldSize);
 
+    /*
+     * The array only grows when the free list is empty; link the new
+     * elements in increasing handle order.
+     */
+    nvAssert(pEvoApiHandles->firstFree == 0);
+
+    for (index = newNumPointers; index > pEvoApiHandles->numPointers; index--) {
+        newNextFree[index - 1] = pEvoApiHandles->firstFree;
+        pEvoApiHandles->firstFree = index;
+    }
+
     pEvoApiHandles->pointers = newPointers;
     pEvoApiHandles->numPointers = newNumPointers;
 
@@ -249,49 +294,42 @@ static NvBool GrowApiHandlesPointersArray(NVEvoApiHandlesPtr pEvoApiHandles)
 /*!
  * Attempt to shrink the NVEvoApiHandles::pointers array.
  *
- * If high elements in the array are unused, reduce the array size in
- * multiples of defaultSize.
+ * This is only done once all handles have been destroyed, so that
+ * clients that churn through many handles do not pay for repeated
+ * reallocation: the array is reduced back to defaultSize.
  */
 static void ShrinkApiHandlesPointersArray(NVEvoApiHandlesPtr pEvoApiHandles)
 {
-    NvU32 index;
-    NvU32 newNumPointers;
+    const NvU32 newNumPointers = pEvoApiHandles->defaultSize;
     void **newPointers;
+    NvU32 *newNextFree;
 
-    /* If the array is already as small as it can be, we are done. */
-
-    if (pEvoApiHandles->numPointers == pEvoApiHandles->defaultSize) {
+    if ((pEvoApiHandles->numUsed != 0) ||
+        (pEvoApiHandles->numPointers == newNumPointers)) {
         return;
     }
 
-    /* Find the highest non-empty element. */
-
-    for (index = pEvoApiHandles->numPointers - 1; index > 0; index--) {
-        if (pEvoApiHandles->pointers[index] != NULL) {
-            break;
-        }
-    }
-
     /*
-     * Compute the new array size by rounding index up to the next
-     * multiple of defaultSize.
+     * Allocate both smaller arrays before releasing the old ones, so that
+     * an allocation failure leaves pEvoApiHandles intact.
      */
-    newNumPointers = ((index / pEvoApiHandles->defaultSize) + 1) *
-        pEvoApiHandles->defaultSize;
-
-    /* If the array is already that size, we are done. */
+    newPointers = nvCalloc(newNumPointers, sizeof(void *));
+    newNextFree = nvAlloc(newNumPointers * sizeof(NvU32));
 
-    if (pEvoApiHandles->numPointers == newNumPointers) {
+    if ((newPointers == NULL) || (newNextFree == NULL)) {
+        nvFree(newPointers);
+        nvFree(newNextFree);
         return;
     }
 
-    newPointers =
-        nvRealloc(pEvoApiHandles->pointers, newNumPointers * sizeof(void *));
+    nvFree(pEvoApiHandles->pointers);
+    nvFree(pEvoApiHandles->nextFree);
 
-    if (newPointers != NULL) {
-        pEvoApiHandles->pointers = newPointers;
-        pEvoApiHandles->numPointers = newNumPointers;
-    }
+    pEvoApiHandles->pointers = newPointers;
+    pEvoApiHandles->nextFree = newNextFree;
+    pEvoApiHandles->numPointers = newNumPointers;
+
+    ResetApiHandlesFreeList(pEvoApiHandles);
 }
 
 
@@ -322,36 +360,33 @@ NvBool nvEvoApiHandlePointerIsPresent(NVEvoApiHandlesPtr pEvoApiHandles,
 NvKmsGenericHandle
 nvEvoCreateApiHandle(NVEvoApiHandlesPtr pEvoApiHandles, void *pointer)
 {
+    NvKmsGenericHandle handle;
     NvU32 index;
 
     if (pointer == NULL) {
         return 0;
     }
 
-    for (index = 0; index < pEvoApiHandles->numPointers; index++) {
-        if (pEvoApiHandles->pointers[index] == NULL) {
-            goto availableIndex;
-        }
-    }
-
     /*
-     * Otherwise, there are no free elements in the pointers array:
-     * grow the array and try again.
+     * If there are no free elements in the pointers array, grow the
+     * array.
      */
-    if (!GrowApiHandlesPointersArray(pEvoApiHandles)) {
+    if ((pEvoApiHandles->firstFree == 0) &&
+        !GrowApiHandlesPointersArray(pEvoApiHandles)) {
         return 0;
     }
 
-    /* fall through */
-
-availableIndex:
+    handle = pEvoApiHandles->firstFree;
+    index = handle - 1;
 
     nvAssert(index < pEvoApiHandles->numPointers);
     nvAssert(pEvoApiHandles->pointers[index] == NULL);
 
+    pEvoApiHandles->firstFree = pEvoApiHandles->nextFree[index];
     pEvoApiHandles->pointers[index] = pointer;
+    pEvoApiHandles->numUsed++;
 
-    return index + 1;
+    return handle;
 }
 
 
@@ -396,6 +431,10 @@ void *nvEvoGetPointerFromApiHandleNext(const NVEvoApiHandlesRec *pEvoApiHandles,
 {
     NvU32 index = *pHandle;
 
+    if (pEvoApiHandles->numUsed == 0) {
+        return NULL;
+    }
+
     for (; index < pEvoApiHandles->numPointers; index++) {
         if (pEvoApiHandles->pointers[index] != NULL) {
             *pHandle = index + 1;
@@ -427,7 +466,16 @@ void nvEvoDestroyApiHandle(NVEvoApiHandlesPtr pEvoApiHandles,
         return;
     }
 
+    if (pEvoApiHandles->pointers[index] == NULL) {
+        return;
+    }
+
     pEvoApiHandles->pointers[index] = NULL;
+    pEvoApiHandles->nextFree[index] = pEvoApiHandles->firstFree;
+    pEvoApiHandles->firstFree = handle;
+
+    nvAssert(pEvoApiHandles->numUsed > 0);
+    pEvoApiHandles->numUsed--;
 
     ShrinkApiHandlesPointersArray(pEvoApiHandles);
 }
@@ -481,8 +529,10 @@ NvBool nvEvoInitApiHandles(NVEvoApiHandlesPtr pEvoApiHandles, NvU32 defaultSize)
 void nvEvoDestroyApiHandles(NVEvoApiHandlesPtr pEvoApiHandles)
 {
     nvAssert(CountApiHandles(pEvoApiHandles) == 0);
+    nvAssert(pEvoApiHandles->numUsed == 0);
 
     nvFree(pEvoApiHandles->pointers);
+    nvFree(pEvoApiHandles->nextFree);
 
     nvkms_memset(pEvoApiHandles, 0, sizeof(*pEvoApiHandles));
 }
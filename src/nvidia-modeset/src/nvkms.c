@@ -6045,11 +6045,24 @@ ProcFsPrintHeads(
         nvEvoLogInfoString(&infoString,
                 "deviceId                     : %02d",
                 pDevEvo->deviceId.rmDeviceId);
+        nvEvoLogInfoString(&infoString,
+                " flip validations (full/fast): %" NvU64_fmtu "/%" NvU64_fmtu,
+                pDevEvo->flipValidation.full,
+                pDevEvo->flipValidation.fast);
         outString(data, buffer);
 
         FOR_ALL_EVO_DISPLAYS(pDispEvo, dispIndex, pDevEvo) {
             const NVLockGroup *pLockGroup = pDispEvo->pLockGroup;
 
+            nvInitInfoString(&infoString, buffer, size);
+            nvEvoLogInfoString(&infoString,
+                    " IMP cache (hit/miss/precomp): %" NvU64_fmtu "/%"
+                    NvU64_fmtu "/%" NvU64_fmtu,
+                    pDispEvo->imp.hits,
+                    pDispEvo->imp.misses,
+                    pDispEvo->imp.precomputed);
+            outString(data, buffer);
+
             if (pLockGroup != NULL) {
                 const NvBool flipLocked = nvIsLockGroupFlipLocked(pLockGroup);
                 nvInitInfoString(&infoString, buffer, size);
@@ -6184,6 +6197,12 @@ ProcFsPrintDpys(
 
                     nvEvoLogInfoString(&infoString,
                             "  dpy                        : %s", name);
+                    nvEvoLogInfoString(&infoString,
+                            "   mode index cache (hit/miss): %" NvU64_fmtu
+                            "/%" NvU64_fmtu ", %" NvU64_fmtu " usec in misses",
+                            pDpyEvo->modeIndexCache.hits,
+                            pDpyEvo->modeIndexCache.misses,
+                            pDpyEvo->modeIndexCache.missUsec);
 
                     if (pDpyEvo->edid.length) {
                         NvU32 i;
@@ -6434,6 +6453,13 @@ static void SendDpyEventEvo(const NVDpyEvoRec *pDpyEvo,
 void nvSendDpyEventEvo(const NVDpyEvoRec *pDpyEvo, const NvU32 eventType)
 {
     nvAssert(eventType != NVKMS_EVENT_TYPE_DPY_ATTRIBUTE_CHANGED);
+
+    /*
+     * Clients re-enumerate the dpy's modes in response to these events, so
+     * make sure they don't get stale results.
+     */
+    nvInvalidateModeIndexCache(pDpyEvo->pDispEvo);
+
     SendDpyEventEvo(pDpyEvo, eventType,
                     0 /* attribute (unused) */,
                     0 /* value (unused) */ );
@@ -4495,6 +4495,37 @@ NV_STATUS NV_API_CALL rm_p2p_get_gpu_info(
     return rmStatus;
 }
 
+NV_STATUS NV_API_CALL rm_p2p_get_vidmem_id(
+    nvidia_stack_t *sp,
+    NvU64           gpuVirtualAddress,
+    NvU64           length,
+    void           *pGpuInfo,
+    NvU64          *pVidmemId
+)
+{
+    THREAD_STATE_NODE threadState;
+    NV_STATUS rmStatus;
+    void *fp;
+
+    NV_ENTER_RM_RUNTIME(sp,fp);
+    threadStateInit(&threadState, THREAD_STATE_FLAGS_NONE);
+
+    // LOCK: acquire API lock
+    if ((rmStatus = rmapiLockAcquire(API_LOCK_FLAGS_NONE, RM_LOCK_MODULES_P2P)) == NV_OK)
+    {
+        rmStatus = RmP2PGetVidmemId(gpuVirtualAddress, length,
+                                    pGpuInfo, pVidmemId);
+
+        // UNLOCK: release API lock
+        rmapiLockRelease();
+    }
+
+    threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
+    NV_EXIT_RM_RUNTIME(sp,fp);
+
+    return rmStatus;
+}
+
 NV_STATUS NV_API_CALL rm_p2p_get_pages_persistent(
     nvidia_stack_t *sp,
     NvU64           gpuVirtualAddress,
@@ -462,6 +462,26 @@ static inline NV_STATUS cliresCtrlCmdSystemRmctrlCacheModeCtrl(struct RmClientRe
 #define cliresCtrlCmdSystemRmctrlCacheModeCtrl(pRmCliRes, pParams) cliresCtrlCmdSystemRmctrlCacheModeCtrl_IMPL(pRmCliRes, pParams)
 #endif // __nvoc_client_resource_h_disabled
 
+NV_STATUS cliresCtrlCmdSystemGetRmctrlCacheStats_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams);
+#ifdef __nvoc_client_resource_h_disabled
+static inline NV_STATUS cliresCtrlCmdSystemGetRmctrlCacheStats(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams) {
+    NV_ASSERT_FAILED_PRECOMP("RmClientResource was disabled!");
+    return NV_ERR_NOT_SUPPORTED;
+}
+#else // __nvoc_client_resource_h_disabled
+#define cliresCtrlCmdSystemGetRmctrlCacheStats(pRmCliRes, pParams) cliresCtrlCmdSystemGetRmctrlCacheStats_IMPL(pRmCliRes, pParams)
+#endif // __nvoc_client_resource_h_disabled
+
+NV_STATUS cliresCtrlCmdSystemGetGpuLockProfile_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *pParams);
+#ifdef __nvoc_client_resource_h_disabled
+static inline NV_STATUS cliresCtrlCmdSystemGetGpuLockProfile(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *pParams) {
+    NV_ASSERT_FAILED_PRECOMP("RmClientResource was disabled!");
+    return NV_ERR_NOT_SUPPORTED;
+}
+#else // __nvoc_client_resource_h_disabled
+#define cliresCtrlCmdSystemGetGpuLockProfile(pRmCliRes, pParams) cliresCtrlCmdSystemGetGpuLockProfile_IMPL(pRmCliRes, pParams)
+#endif // __nvoc_client_resource_h_disabled
+
 NV_STATUS cliresCtrlCmdNvdGetDumpSize_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_NVD_GET_DUMP_SIZE_PARAMS *pDumpSizeParams);
 #ifdef __nvoc_client_resource_h_disabled
 static inline NV_STATUS cliresCtrlCmdNvdGetDumpSize(struct RmClientResource *pRmCliRes, NV0000_CTRL_NVD_GET_DUMP_SIZE_PARAMS *pDumpSizeParams) {
@@ -1438,6 +1458,10 @@ NV_STATUS cliresCtrlCmdSystemGetClientDatabaseInfo_IMPL(struct RmClientResource
 
 NV_STATUS cliresCtrlCmdSystemRmctrlCacheModeCtrl_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_PARAMS *pParams);
 
+NV_STATUS cliresCtrlCmdSystemGetRmctrlCacheStats_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams);
+
+NV_STATUS cliresCtrlCmdSystemGetGpuLockProfile_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *pParams);
+
 NV_STATUS cliresCtrlCmdNvdGetDumpSize_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_NVD_GET_DUMP_SIZE_PARAMS *pDumpSizeParams);
 
 NV_STATUS cliresCtrlCmdNvdGetDump_IMPL(struct RmClientResource *pRmCliRes, NV0000_CTRL_NVD_GET_DUMP_PARAMS *pDumpParams);
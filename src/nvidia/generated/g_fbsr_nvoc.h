@@ -147,6 +147,11 @@ struct OBJFBSR {
     NvBool bInitialized;
     NvBool bRawModeWasEnabled;
     MEMORY_DESCRIPTOR *pSysReservedMemDesc;
+    NvU64 lastSubmittedCopyId;
+    NvU64 pendingCopySize;
+    NvU64 opStartTimeNs;
+    NvU64 copyWaitTimeNs;
+    NvU32 numCopiedRegions;
 };
 
 
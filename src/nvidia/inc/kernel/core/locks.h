@@ -29,6 +29,7 @@
 // Forward declarations
 typedef struct OBJSYS OBJSYS;
 typedef struct NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS;
+typedef struct NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS;
 
 typedef enum
 {
@@ -164,6 +165,7 @@ NvU32      rmGpuLocksGetOwnedMask(void);
 NvBool     rmGpuLockIsHidden(OBJGPU *);
 NV_STATUS  rmGpuLockSetOwner(OS_THREAD_HANDLE);
 void       rmGpuLockGetTimes(NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS *);
+NV_STATUS  rmGpuLockGetProfile(NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *);
 NV_STATUS  rmGpuGroupLockAcquire(NvU32, GPU_LOCK_GRP_ID, NvU32, NvU32, GPU_MASK *);
 void       rmGpuGroupLockRelease(GPU_MASK, NvU32);
 NvBool     rmGpuGroupLockIsOwner(NvU32, GPU_LOCK_GRP_ID, GPU_MASK*);
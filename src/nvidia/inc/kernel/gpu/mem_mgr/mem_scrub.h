@@ -57,6 +57,8 @@ struct OBJCHANNEL;
 
 #define SCRUBBER_SUBMIT_FLAGS_LOCALIZED_SCRUB NVBIT(0)
 
+#define SCRUB_INTERVAL_NODE_INVALID               0xFFFFFFFF
+
 // structure to store the details of a scrubbing work
 typedef struct SCRUB_NODE {
     // The 64 bit ID assigned to each work
@@ -67,6 +69,51 @@ typedef struct SCRUB_NODE {
     NvU64      size;
 } SCRUB_NODE, *PSCRUB_NODE;
 
+//
+// Node of the interval index over the pending scrub work. The nodes live in
+// an array parallel to pScrubList, so a work item and its node share the same
+// slot. The nodes form a treap ordered by (base, id), and every node caches
+// the largest end address in its subtree so that overlap queries can skip
+// whole subtrees.
+//
+typedef struct SCRUB_INTERVAL_NODE {
+    // Inclusive address range of the scrub work
+    NvU64      base;
+    NvU64      end;
+    // Largest end address of this node and its descendants
+    NvU64      maxEnd;
+    // The 64 bit ID of the scrub work
+    NvU64      id;
+    // Time at which the work was submitted
+    NvU64      submitTimeNs;
+    // Heap priority derived from the ID
+    NvU32      priority;
+    // Slots of the children, SCRUB_INTERVAL_NODE_INVALID if none
+    NvU32      left;
+    NvU32      right;
+} SCRUB_INTERVAL_NODE;
+
+// Scrubber queue depth and latency statistics
+typedef struct SCRUB_STATS {
+    // Number of scrub works submitted
+    NvU64      workSubmitted;
+    // Number of completed scrub works handed back to the client
+    NvU64      workCompleted;
+    // Number of pages merged into a neighbouring scrub work
+    NvU64      pagesCoalesced;
+    // Largest number of scrub works outstanding at once
+    NvU64      queueDepthMax;
+    // Time from submission to hand back to the client of the completed scrub
+    // works. This includes the time the work sat completed until the client
+    // checked for it.
+    NvU64      handbackTimeTotalNs;
+    NvU64      handbackTimeMaxNs;
+    // Waits on overlapping scrub work that had to block, and their duration
+    NvU64      overlapWaitCount;
+    NvU64      overlapWaitTimeTotalNs;
+    NvU64      overlapWaitTimeMaxNs;
+} SCRUB_STATS;
+
 //
 // OBJMEMSCRUB OBJECT
 // Memory scrubber struct encapsulates the CE Channel object,
@@ -88,6 +135,12 @@ typedef struct OBJMEMSCRUB {
     NvLength                           scrubListSize;
     // Pre-allocated Free Scrub List
     PSCRUB_NODE                        pScrubList;
+    // Interval index over the pending entries of pScrubList
+    SCRUB_INTERVAL_NODE               *pIntervalNodes;
+    // Slot of the root of the interval index
+    NvU32                              intervalRoot;
+    // Queue depth and latency statistics
+    SCRUB_STATS                        stats;
 #if !defined(SRT_BUILD)
     // Scrubber uses ceUtils to manage CE channel
     CeUtils                           *pCeUtils;
@@ -45,4 +45,7 @@ NV_STATUS memUtilsAllocMemDesc(OBJGPU *pGpu, MEMORY_ALLOCATION_REQUEST *pAllocRe
 
 NV_STATUS  memUtilsMemSetNoBAR2(OBJGPU *pGpu, PMEMORY_DESCRIPTOR pMemDesc, NvU8 value);
 
+TRANSFER_TYPE memmgrGetMemTransferType(MemoryManager *pMemoryManager, TRANSFER_SURFACE *pDst,
+                                       TRANSFER_SURFACE *pSrc, NvU32 flags);
+
 #endif //_MEM_UTILS_H_
@@ -32,6 +32,7 @@ NV_STATUS  RmP2PGetPagesPersistent  (NvU64, NvU64, void **, NvU64 *, NvU32 *, Nv
 NV_STATUS  RmP2PRegisterCallback    (NvU64, NvU64, NvU64, void *, void (*)(void *), void *);
 NV_STATUS  RmP2PPutPages            (NvU64, NvU32, NvU64, void *);
 NV_STATUS  RmP2PGetGpuByAddress     (NvU64, NvU64, OBJGPU **);
+NV_STATUS  RmP2PGetVidmemId         (NvU64, NvU64, void *, NvU64 *);
 NV_STATUS  RmP2PPutPagesPersistent  (void *, void *, void *);
 
 #endif
@@ -39,6 +39,7 @@ typedef struct CALL_CONTEXT CALL_CONTEXT;
 typedef struct MEMORY_DESCRIPTOR MEMORY_DESCRIPTOR;
 typedef struct RS_RES_FREE_PARAMS_INTERNAL RS_RES_FREE_PARAMS_INTERNAL;
 typedef struct RS_LOCK_INFO RS_LOCK_INFO;
+typedef struct NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS;
 typedef struct NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS;
 typedef NvU32 NV_ADDRESS_SPACE;
 
@@ -324,6 +325,7 @@ void rmapiControlCacheFreeAllCacheForGpu(NvU32 gpuInst);
 void rmapiControlCacheFreeNonPersistentCacheForGpu(NvU32 gpuInst);
 void rmapiControlCacheSetMode(NvU32 mode);
 NvU32 rmapiControlCacheGetMode(void);
+void rmapiControlCacheGetStats(NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams);
 void rmapiControlCacheFree(void);
 NV_STATUS rmapiControlCacheFreeForControl(NvU32 gpuInstance, NvU32 cmd);
 void rmapiControlCacheFreeClientEntry(NvHandle hClient);
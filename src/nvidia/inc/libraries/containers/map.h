@@ -60,6 +60,14 @@ extern "C" {
  *  * \b None. The container is not thread-safe.
  *  * Locking must be handled by the user if required.
  *
+ * - Backends:
+ *  * Maps default to a red-black tree of the embedded nodes.
+ *  * @ref mapUseBtree switches an empty map to a B+-tree that packs
+ *    MAP_BTREE_ORDER keys per node, trading an extra allocation per
+ *    MAP_BTREE_ORDER/2 values for fewer cache misses on lookup and
+ *    sequential iteration over large maps.
+ *  * The choice is per map instance; the API is identical for both.
+ *
  */
 
 #define MAKE_MAP(mapTypeName, dataType)                                      \
@@ -123,6 +131,11 @@ typedef struct IntrusiveMap IntrusiveMap;
  */
 typedef struct MapIterBase MapIterBase;
 
+/**
+ * @brief Interior/leaf node of the optional B+-tree backend.
+ */
+typedef struct MapBtreeNode MapBtreeNode;
+
 struct MapNode
 {
     /// @privatesection
@@ -160,6 +173,9 @@ struct MapBase
 #if PORT_IS_CHECKED_BUILD
     NvU32       versionNumber;
 #endif
+    // B+-tree backend, used instead of pRoot when pBtreeAllocator is set
+    MapBtreeNode       *pBtreeRoot;
+    PORT_MEM_ALLOCATOR *pBtreeAllocator;
 };
 
 struct NonIntrusiveMap
@@ -186,6 +202,19 @@ struct IntrusiveMap
         mapDestroyIntrusive_IMPL(&((pMap)->real.base)),                      \
         contDispatchVoid_STUB())
 
+/**
+ * @brief Switch an empty map to the B+-tree backend.
+ *
+ * Tree nodes are allocated from pAllocator, which must outlive the map.
+ * The backend is kept across @ref mapDestroy / @ref mapClear and reset by
+ * mapInit. Values keep their addresses, so iterators and intrusive nodes
+ * behave as with the default backend.
+ *
+ * @return NV_FALSE if the map is not empty.
+ */
+#define mapUseBtree(pMap, pAllocator)                                        \
+    mapUseBtree_IMPL(&((pMap)->real).base, pAllocator)
+
 #define mapCount(pMap)                                                       \
     mapCount_IMPL(&((pMap)->real).base)
 
@@ -257,6 +286,7 @@ void mapInit_IMPL(NonIntrusiveMap *pMap,
 void mapInitIntrusive_IMPL(IntrusiveMap *pMap, NvS32 nodeOffset);
 void mapDestroy_IMPL(NonIntrusiveMap *pMap);
 void mapDestroyIntrusive_IMPL(MapBase *pMap);
+NvBool mapUseBtree_IMPL(MapBase *pMap, PORT_MEM_ALLOCATOR *pAllocator);
 
 NvU32 mapCount_IMPL(MapBase *pMap);
 NvU64 mapKey_IMPL(MapBase *pMap, void *pValue);
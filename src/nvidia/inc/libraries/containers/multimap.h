@@ -146,6 +146,13 @@ struct MultimapBase
 #define multimapDestroy(pMultimap)                                            \
     multimapDestroy_IMPL(&(pMultimap)->real.base)
 
+/**
+ * @brief Switch an empty multimap, and every submap it creates, to the
+ * B+-tree map backend. See @ref mapUseBtree.
+ */
+#define multimapUseBtree(pMultimap)                                           \
+    multimapUseBtree_IMPL(&(pMultimap)->real.base)
+
 #define multimapClear(pMultimap)                                              \
     multimapClear_IMPL(&(pMultimap)->real.base)
 
@@ -244,6 +251,7 @@ void multimapInit_IMPL(MultimapBase *pBase, PORT_MEM_ALLOCATOR *pAllocator,
 		       NvU32 valueSize, NvS32 nodeOffset, NvU32 submapSize);
 void multimapRemoveSubmap_IMPL(MultimapBase *pMultimap, MapBase *submap);
 void multimapDestroy_IMPL(MultimapBase *pBase);
+NvBool multimapUseBtree_IMPL(MultimapBase *pBase);
 void multimapClear_IMPL(MultimapBase *pBase);
 
 void *multimapInsertSubmap_IMPL(MultimapBase *pBase, NvU64 submapKey);
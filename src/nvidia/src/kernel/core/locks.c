@@ -81,8 +81,56 @@ typedef struct
     NvU16               priority;
     NvU16               priorityPrev;
     NvU64               timestamp;
+    NvU32               module;     // RM_LOCK_MODULES_* of the current holder
+    NvU64               acquireRa;  // Acquire call site of the current holder
 } GPULOCK;
 
+//
+// GPU lock contention profile
+//
+// Collected while PDB_PROP_SYS_RM_LOCK_TIME_COLLECT is set and reported by
+// NV0000_CTRL_CMD_SYSTEM_GET_GPU_LOCK_PROFILE. Every field is updated with
+// the GPULOCKINFO spinlock held, which the acquire and release paths hold
+// anyway, so no atomics are needed.
+//
+// Per-lock data is indexed by gpuInstance, with the GPU alloc lock last.
+// Modules are kept in a short list, and holders in a small open-addressed
+// table keyed by the acquire return address. The return addresses never
+// leave RM; the control reports them as offsets into the RM text.
+//
+#define GPU_LOCK_PROFILE_NUM_LOCKS      (NV_MAX_DEVICES + 1)
+#define GPU_LOCK_PROFILE_HIST_BUCKETS   NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_HIST_BUCKETS
+#define GPU_LOCK_PROFILE_MAX_MODULES    NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_MODULES
+#define GPU_LOCK_PROFILE_HOLDER_SLOTS   64
+
+typedef struct
+{
+    NvU64               acquireCount;
+    NvU64               contendedCount;
+    NvU64               maxWaitNs;
+    NvU64               maxHoldNs;
+    NvU64               waitHist[GPU_LOCK_PROFILE_HIST_BUCKETS];
+    NvU64               holdHist[GPU_LOCK_PROFILE_HIST_BUCKETS];
+} GPULOCK_PROFILE_LOCK;
+
+typedef struct
+{
+    NvU64               callerRA;
+    NvU32               module;
+    NvU64               holdCount;
+    NvU64               totalHoldNs;
+    NvU64               maxHoldNs;
+} GPULOCK_PROFILE_HOLDER;
+
+typedef struct
+{
+    GPULOCK_PROFILE_LOCK                        locks[GPU_LOCK_PROFILE_NUM_LOCKS];
+    NvU32                                       numModules;
+    NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE  modules[GPU_LOCK_PROFILE_MAX_MODULES];
+    GPULOCK_PROFILE_HOLDER                      holders[GPU_LOCK_PROFILE_HOLDER_SLOTS];
+    NvU64                                       droppedSamples;
+} GPULOCK_PROFILE;
+
 //
 // GPU lock info
 //
@@ -168,6 +216,11 @@ typedef struct
     // Total time spent holding GPU locks.
     //
     volatile NvU64               totalHoldTime;
+
+    //
+    // Per-lock contention profile.
+    //
+    GPULOCK_PROFILE     profile;
 } GPULOCKINFO;
 
 static GPULOCKINFO rmGpuLockInfo;
@@ -179,6 +232,9 @@ static NV_STATUS _rmGpuLocksAcquire(NvU32, NvU32, NvU32, void *, NvU32 *);
 static void      _rmGpuLocksHandleDeferredWork(NvU32);
 static NvU32     _rmGpuLocksRelease(NvU32, NvU32, OBJGPU *, void *);
 
+static void      _rmGpuLockProfileRecordWait(NvU32, NvU32, NvU64, NvBool);
+static void      _rmGpuLockProfileRecordHold(NvU32, GPULOCK *, NvU64);
+
 static NvBool    _rmGpuAllocLockIsOwner(void);
 static NvBool    _rmGpuLockIsOwner(NvU32);
 
@@ -736,6 +792,9 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
     NvU64     priorityPrev = 0;
     NvU64     timestamp;
     NvU64     startWaitTime = 0;
+    NvU64     lockWaitStart = 0;
+    NvBool    bProfile = NV_FALSE;
+    NvBool    bContended;
     NvBool    bLockAll = NV_FALSE;
     NvBool    bAcquireAllocLock = NV_FALSE;
     NvU32     loopCount;
@@ -905,7 +964,10 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
 
     // Get start wait time if measuring lock times
     if (pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+    {
         startWaitTime = osGetMonotonicTimeNs();
+        bProfile = NV_TRUE;
+    }
 
     //
     // Now (attempt) to acquire the locks...
@@ -944,12 +1006,18 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
             pGpuLock = &rmGpuLockInfo.gpuLocks[gpuInst];
         }
 
+        bContended = NV_FALSE;
+        if (bProfile)
+            lockWaitStart = osGetMonotonicTimeNs();
+
         //
         // Check to see if the lock is not free...we should only fall into this
         // case if we can actually tolerate waiting for it.
         //
         if (!bCondAcquireCheck && (pGpuLock->count <= 0))
         {
+            bContended = NV_TRUE;
+
             //
             // Assert that this is not already the owner of the GpusLock
             // (the lock will cause a hang if acquired recursively)
@@ -1098,6 +1166,11 @@ per_gpu_lock_acquired:
         pGpuLock->priority = priority;
         pGpuLock->priorityPrev = priorityPrev;
         pGpuLock->timestamp = timestamp;
+        pGpuLock->module = module;
+        pGpuLock->acquireRa = (NvUPtr)ra;
+
+        if (bProfile)
+            _rmGpuLockProfileRecordWait(gpuInst, module, timestamp - lockWaitStart, bContended);
 
 next_gpu_instance:
         ;
@@ -1648,6 +1721,7 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
     NvU64   priorityPrev = 0;
     NvU64   timestamp;
     NvU64   startHoldTime = 0;
+    NvBool  bProfile = pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT);
     NvBool  bReleaseAllocLock = NV_FALSE;
     NvBool  bAllocLockWakeup = NV_FALSE;
     NV_STATUS status;
@@ -1844,6 +1918,9 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
                               bHighIrql,
                               (NvU8)priority,
                               timestamp);
+
+            if (bProfile)
+                _rmGpuLockProfileRecordHold(gpuInst, pGpuLock, timestamp - pGpuLock->timestamp);
         }
     }
 
@@ -2388,6 +2465,225 @@ rmGpuLockGetTimes(NV0000_CTRL_SYSTEM_GET_LOCK_TIMES_PARAMS *pParams)
     pParams->waitGpuLock = rmGpuLockInfo.totalWaitTime;
 }
 
+//
+// _rmGpuLockProfileBucket
+//
+// Map a time in nanoseconds to a log2 microsecond histogram bucket.
+//
+static NvU32
+_rmGpuLockProfileBucket(NvU64 timeNs)
+{
+    NvU32 bucket = 64 - portUtilCountLeadingZeros64(timeNs / 1000);
+
+    return NV_MIN(bucket, GPU_LOCK_PROFILE_HIST_BUCKETS - 1);
+}
+
+static GPULOCK_PROFILE_LOCK *
+_rmGpuLockProfileGetLock(NvU32 gpuInst)
+{
+    if (gpuInst == GPU_INST_ALLOC_LOCK)
+        return &rmGpuLockInfo.profile.locks[NV_MAX_DEVICES];
+
+    return &rmGpuLockInfo.profile.locks[gpuInst];
+}
+
+//
+// _rmGpuLockProfileGetModule
+//
+// Find or claim the profile entry for a lock module. Returns NULL when the
+// module list is full.
+//
+static NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE *
+_rmGpuLockProfileGetModule(NvU32 module)
+{
+    GPULOCK_PROFILE *pProfile = &rmGpuLockInfo.profile;
+    NvU32 i;
+
+    for (i = 0; i < pProfile->numModules; i++)
+    {
+        if (pProfile->modules[i].module == module)
+            return &pProfile->modules[i];
+    }
+
+    if (pProfile->numModules == GPU_LOCK_PROFILE_MAX_MODULES)
+        return NULL;
+
+    pProfile->modules[pProfile->numModules].module = module;
+    return &pProfile->modules[pProfile->numModules++];
+}
+
+//
+// _rmGpuLockProfileGetHolder
+//
+// Find or claim the profile entry for an acquire call site. Slots with a
+// zero holdCount are free. Returns NULL when the table is full.
+//
+static GPULOCK_PROFILE_HOLDER *
+_rmGpuLockProfileGetHolder(NvU64 callerRA)
+{
+    GPULOCK_PROFILE *pProfile = &rmGpuLockInfo.profile;
+    GPULOCK_PROFILE_HOLDER *pHolder;
+    NvU32 slot = (NvU32)((callerRA >> 2) ^ (callerRA >> 12)) % GPU_LOCK_PROFILE_HOLDER_SLOTS;
+    NvU32 i;
+
+    for (i = 0; i < GPU_LOCK_PROFILE_HOLDER_SLOTS; i++)
+    {
+        pHolder = &pProfile->holders[(slot + i) % GPU_LOCK_PROFILE_HOLDER_SLOTS];
+
+        if (pHolder->holdCount == 0)
+        {
+            pHolder->callerRA = callerRA;
+            return pHolder;
+        }
+
+        if (pHolder->callerRA == callerRA)
+            return pHolder;
+    }
+
+    return NULL;
+}
+
+//
+// _rmGpuLockProfileRecordWait
+//
+// Account one acquire of a GPU lock. Caller holds rmGpuLockInfo.pLock.
+//
+static void
+_rmGpuLockProfileRecordWait(NvU32 gpuInst, NvU32 module, NvU64 waitNs, NvBool bContended)
+{
+    GPULOCK_PROFILE_LOCK *pLockProfile = _rmGpuLockProfileGetLock(gpuInst);
+    NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE *pModule = _rmGpuLockProfileGetModule(module);
+
+    pLockProfile->acquireCount++;
+    pLockProfile->waitHist[_rmGpuLockProfileBucket(waitNs)]++;
+    pLockProfile->maxWaitNs = NV_MAX(pLockProfile->maxWaitNs, waitNs);
+    if (bContended)
+        pLockProfile->contendedCount++;
+
+    if (pModule == NULL)
+    {
+        rmGpuLockInfo.profile.droppedSamples++;
+        return;
+    }
+
+    pModule->acquireCount++;
+    pModule->totalWaitNs += waitNs;
+    pModule->waitHist[_rmGpuLockProfileBucket(waitNs)]++;
+    if (bContended)
+        pModule->contendedCount++;
+}
+
+//
+// _rmGpuLockProfileRecordHold
+//
+// Account one release of a GPU lock against the module and call site that
+// acquired it. Caller holds rmGpuLockInfo.pLock.
+//
+static void
+_rmGpuLockProfileRecordHold(NvU32 gpuInst, GPULOCK *pGpuLock, NvU64 holdNs)
+{
+    GPULOCK_PROFILE_LOCK *pLockProfile = _rmGpuLockProfileGetLock(gpuInst);
+    NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MODULE *pModule = _rmGpuLockProfileGetModule(pGpuLock->module);
+    GPULOCK_PROFILE_HOLDER *pHolder = _rmGpuLockProfileGetHolder(pGpuLock->acquireRa);
+
+    pLockProfile->holdHist[_rmGpuLockProfileBucket(holdNs)]++;
+    pLockProfile->maxHoldNs = NV_MAX(pLockProfile->maxHoldNs, holdNs);
+
+    if (pModule != NULL)
+    {
+        pModule->totalHoldNs += holdNs;
+        pModule->maxHoldNs = NV_MAX(pModule->maxHoldNs, holdNs);
+        pModule->holdHist[_rmGpuLockProfileBucket(holdNs)]++;
+    }
+
+    if (pHolder != NULL)
+    {
+        pHolder->module = pGpuLock->module;
+        pHolder->holdCount++;
+        pHolder->totalHoldNs += holdNs;
+        pHolder->maxHoldNs = NV_MAX(pHolder->maxHoldNs, holdNs);
+    }
+
+    if ((pModule == NULL) || (pHolder == NULL))
+        rmGpuLockInfo.profile.droppedSamples++;
+}
+
+//
+// rmGpuLockGetProfile
+//
+// Retrieve the contention profile of one GPU lock along with the module and
+// top call site totals across all GPU locks, and optionally reset it.
+//
+NV_STATUS
+rmGpuLockGetProfile(NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *pParams)
+{
+    GPULOCK_PROFILE *pProfile = &rmGpuLockInfo.profile;
+    GPULOCK_PROFILE_LOCK *pLockProfile;
+    GPULOCK_PROFILE_HOLDER *pHolder;
+    NvU64 textAnchor = (NvU64)(NvUPtr)&rmGpuLockGetProfile;
+    NvU32 gpuInst = pParams->gpuInstance;
+    NvU32 i, j;
+
+    if (gpuInst == NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_ALLOC_LOCK)
+        gpuInst = GPU_INST_ALLOC_LOCK;
+    else if (gpuInst >= NV_MAX_DEVICES)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    portSyncSpinlockAcquire(rmGpuLockInfo.pLock);
+
+    pLockProfile = _rmGpuLockProfileGetLock(gpuInst);
+    pParams->acquireCount   = pLockProfile->acquireCount;
+    pParams->contendedCount = pLockProfile->contendedCount;
+    pParams->maxWaitNs      = pLockProfile->maxWaitNs;
+    pParams->maxHoldNs      = pLockProfile->maxHoldNs;
+    portMemCopy(pParams->waitHist, sizeof(pParams->waitHist),
+                pLockProfile->waitHist, sizeof(pLockProfile->waitHist));
+    portMemCopy(pParams->holdHist, sizeof(pParams->holdHist),
+                pLockProfile->holdHist, sizeof(pLockProfile->holdHist));
+
+    pParams->numModules = pProfile->numModules;
+    portMemCopy(pParams->modules, sizeof(pParams->modules),
+                pProfile->modules, sizeof(pProfile->modules));
+
+    // Insertion sort the used holder slots, keeping the largest total holds
+    pParams->numHolders = 0;
+    for (i = 0; i < GPU_LOCK_PROFILE_HOLDER_SLOTS; i++)
+    {
+        pHolder = &pProfile->holders[i];
+        if (pHolder->holdCount == 0)
+            continue;
+
+        for (j = pParams->numHolders; j > 0; j--)
+        {
+            if (pParams->holders[j - 1].totalHoldNs >= pHolder->totalHoldNs)
+                break;
+            if (j < NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_HOLDERS)
+                pParams->holders[j] = pParams->holders[j - 1];
+        }
+
+        if (j < NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_HOLDERS)
+        {
+            // Report the call site relative to RM's own text, not as a kernel address
+            pParams->holders[j].callerOffset = (NvS64)(pHolder->callerRA - textAnchor);
+            pParams->holders[j].module       = pHolder->module;
+            pParams->holders[j].holdCount    = pHolder->holdCount;
+            pParams->holders[j].totalHoldNs  = pHolder->totalHoldNs;
+            pParams->holders[j].maxHoldNs    = pHolder->maxHoldNs;
+            if (pParams->numHolders < NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_MAX_HOLDERS)
+                pParams->numHolders++;
+        }
+    }
+
+    pParams->droppedSamples = pProfile->droppedSamples;
+
+    if (pParams->flags & NV0000_CTRL_SYSTEM_GPU_LOCK_PROFILE_FLAGS_RESET)
+        portMemSet(pProfile, 0, sizeof(*pProfile));
+
+    portSyncSpinlockRelease(rmGpuLockInfo.pLock);
+
+    return NV_OK;
+}
+
 //
 // rmDeviceGpuLockSetOwner
 //
@@ -1582,6 +1582,45 @@ NV_STATUS RmP2PGetGpuByAddress(
     return status;
 }
 
+//
+// Returns the ID of the vidmem registration backing the address range.
+// IDs are never reused, so a range that was freed and registered again
+// resolves to a different ID even at the same address.
+//
+NV_STATUS RmP2PGetVidmemId(
+    NvU64      address,
+    NvU64      length,
+    void      *pGpuInfo,
+    NvU64     *pVidmemId
+)
+{
+    ThirdPartyP2P *pThirdPartyP2P = NULL;
+    CLI_THIRD_PARTY_P2P_VASPACE_INFO *pVASpaceInfo = NULL;
+    CLI_THIRD_PARTY_P2P_VIDMEM_INFO *pVidmemInfo = NULL;
+    NvU64 offset;
+    NV_STATUS status;
+
+    status = RmP2PGetInfoWithoutToken(address, length, NULL,
+                                      &pThirdPartyP2P, &pVASpaceInfo,
+                                      (OBJGPU *) pGpuInfo);
+    if (status != NV_OK)
+    {
+        return status;
+    }
+
+    status = CliGetThirdPartyP2PVidmemInfoFromAddress(pThirdPartyP2P, address,
+                                                      length, &offset,
+                                                      &pVidmemInfo);
+    if (status != NV_OK)
+    {
+        return status;
+    }
+
+    *pVidmemId = pVidmemInfo->id;
+
+    return NV_OK;
+}
+
 NV_STATUS RmP2PRegisterCallback(
     NvU64       p2pToken,
     NvU64       address,
@@ -28,6 +28,9 @@
 #include "gpu/mem_mgr/fbsr.h"
 #include "gpu/bus/kern_bus.h"
 #include "gpu/mem_mgr/mem_desc.h"
+#include "gpu/mem_mgr/mem_utils.h"
+#include "gpu/mem_mgr/ce_utils.h"
+#include "gpu/mem_mgr/channel_utils.h"
 #include "gpu/gsp/kernel_gsp.h"
 #include "published/maxwell/gm107/dev_ram.h"
 #include "core/thread_state.h"
@@ -69,6 +72,13 @@
 // buffer is allocated, we need to use memdescLock to lock the buffer in physical
 // memory so that CE can access it and then use memdescUnlock to unlock it.
 //
+// For mechanisms #1, #3, #4 and #5 the per-region copies are submitted to
+// CeUtils asynchronously whenever CeUtils can perform them, so consecutive
+// regions stream back to back on the copy engine instead of waiting for each
+// region to complete. The outstanding copies are waited for once
+// FBSR_MAX_PENDING_COPY_SIZE bytes are in flight and in End(), and the CE time
+// is reported per such wait rather than per region.
+//
 // Mechanisms #5 and #6 are targetted for WDDM, a large VA section (Paged region)
 // and  a small pinned region are committed on boot.
 //
@@ -101,6 +111,107 @@
 //
 #define MAX_FILE_COPY_SIZE_WITHIN_DEFAULT_THREAD_TIMEOUT    (64 * 1024 * 1024)
 
+//
+// Maximum size in bytes of asynchronous CE copies that may be outstanding
+// before waiting for them, which keeps each wait within the default timeout.
+//
+#define FBSR_MAX_PENDING_COPY_SIZE                          (256 * 1024 * 1024)
+
+/*!
+ * Wait for the outstanding asynchronous CE copies to complete.
+ *
+ * @param[in]     pGpu         OBJGPU pointer
+ * @param[in]     pFbsr        OBJFBSR pointer
+ *
+ * @returns NV_OK on success
+ */
+static NV_STATUS
+_fbsrWaitForCopies
+(
+    OBJGPU  *pGpu,
+    OBJFBSR *pFbsr
+)
+{
+    MemoryManager *pMemoryManager = GPU_GET_MEMORY_MANAGER(pGpu);
+    NV_STATUS      status;
+    NvU64          startTimeNs;
+    NvU64          waitTimeNs;
+
+    if (pFbsr->pendingCopySize == 0)
+        return NV_OK;
+
+    NV_ASSERT_OR_RETURN(pMemoryManager->pCeUtils != NULL, NV_ERR_INVALID_STATE);
+
+    startTimeNs = osGetMonotonicTimeNs();
+    status = channelWaitForFinishPayload(pMemoryManager->pCeUtils->pChannel,
+                                         pFbsr->lastSubmittedCopyId);
+    waitTimeNs = osGetMonotonicTimeNs() - startTimeNs;
+    pFbsr->copyWaitTimeNs += waitTimeNs;
+
+    NV_PRINTF(LEVEL_INFO, "waited %llu us for %llu bytes of CE copies\n",
+              waitTimeNs / 1000, pFbsr->pendingCopySize);
+
+    pFbsr->pendingCopySize = 0;
+
+    return status;
+}
+
+/*!
+ * Copy a region between vidmem and its sysmem backing store for the DMA
+ * based mechanisms. The copy is submitted to CeUtils without waiting for it
+ * when memmgrMemCopy would have used CeUtils for it as well, otherwise it
+ * falls back to memmgrMemCopy.
+ *
+ * @param[in]     pGpu         OBJGPU pointer
+ * @param[in]     pFbsr        OBJFBSR pointer
+ * @param[in]     pDst         Destination surface
+ * @param[in]     pSrc         Source surface
+ * @param[in]     size         Size of the copy in bytes
+ *
+ * @returns NV_OK on success
+ */
+static NV_STATUS
+_fbsrCopyRegionDma
+(
+    OBJGPU           *pGpu,
+    OBJFBSR          *pFbsr,
+    TRANSFER_SURFACE *pDst,
+    TRANSFER_SURFACE *pSrc,
+    NvU64             size
+)
+{
+    MemoryManager          *pMemoryManager = GPU_GET_MEMORY_MANAGER(pGpu);
+    CeUtils                *pCeUtils       = pMemoryManager->pCeUtils;
+    CEUTILS_MEMCOPY_PARAMS  params         = {0};
+    const NvU32             flags          = TRANSFER_FLAGS_PREFER_CE | TRANSFER_FLAGS_CE_PRI_DEFER_FLUSH;
+
+    if (memmgrGetMemTransferType(pMemoryManager, pDst, pSrc, flags) != TRANSFER_TYPE_CE)
+    {
+        return memmgrMemCopy(pMemoryManager, pDst, pSrc, size, flags);
+    }
+
+    params.pDstMemDesc = pDst->pMemDesc;
+    params.dstOffset   = pDst->offset;
+    params.pSrcMemDesc = pSrc->pMemDesc;
+    params.srcOffset   = pSrc->offset;
+    params.length      = size;
+
+    // Regions never overlap, so the copies need no WFI between them
+    params.flags       = NV0050_CTRL_MEMCOPY_FLAGS_ASYNC | NV0050_CTRL_MEMCOPY_FLAGS_PIPELINED;
+
+    NV_ASSERT_OK_OR_RETURN(ceutilsMemcopy(pCeUtils, &params));
+
+    pFbsr->lastSubmittedCopyId = params.submittedWorkId;
+    pFbsr->pendingCopySize    += size;
+
+    if (pFbsr->pendingCopySize >= FBSR_MAX_PENDING_COPY_SIZE)
+    {
+        return _fbsrWaitForCopies(pGpu, pFbsr);
+    }
+
+    return NV_OK;
+}
+
 static NV_STATUS _fbsrInitGsp
 (
     OBJGPU *pGpu,
@@ -293,6 +404,11 @@ fbsrBegin_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, FBSR_OP_TYPE op)
 
     pFbsr->op = op;
     pFbsr->bOperationFailed = NV_FALSE;
+    pFbsr->lastSubmittedCopyId = 0;
+    pFbsr->pendingCopySize = 0;
+    pFbsr->copyWaitTimeNs = 0;
+    pFbsr->numCopiedRegions = 0;
+    pFbsr->opStartTimeNs = osGetMonotonicTimeNs();
 
     if (op != FBSR_OP_SIZE_BUF && op != FBSR_OP_DESTROY)
     {
@@ -303,7 +419,7 @@ fbsrBegin_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, FBSR_OP_TYPE op)
             NV_ASSERT_OK_OR_RETURN(memmgrInitCeUtils(pMemoryManager, NV_FALSE, bVirtualMode));
         }
 
-        NV_PRINTF(LEVEL_INFO, "%s %lld bytes of data\n",
+        NV_PRINTF(LEVEL_INFO, "%s %llu bytes of data\n",
                   pFbsr->op == FBSR_OP_SAVE ? "saving" : "restoring",
                   pFbsr->length);
     }
@@ -615,6 +731,17 @@ fbsrEnd_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr)
 
     if (pFbsr->op != FBSR_OP_SIZE_BUF && pFbsr->op != FBSR_OP_DESTROY)
     {
+        if (_fbsrWaitForCopies(pGpu, pFbsr) != NV_OK)
+        {
+            NV_PRINTF(LEVEL_ERROR, "Timed out waiting for FBSR copies to finish\n");
+            pFbsr->bOperationFailed = NV_TRUE;
+        }
+
+        NV_PRINTF(LEVEL_INFO, "%s %u regions, %llu bytes in %llu us (%llu us waiting for CE)\n",
+                  pFbsr->op == FBSR_OP_SAVE ? "saved" : "restored",
+                  pFbsr->numCopiedRegions, pFbsr->length,
+                  (osGetMonotonicTimeNs() - pFbsr->opStartTimeNs) / 1000,
+                  pFbsr->copyWaitTimeNs / 1000);
 
         if ((IS_VIRTUAL(pGpu) || IS_GSP_CLIENT(pGpu)) && (pMemoryManager->pCeUtils != NULL))
         {
@@ -779,6 +906,12 @@ fbsrCopyMemoryMemDesc_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, MEMORY_DESCRIPTOR *pVi
         return;
     }
 
+    // Nothing to save or restore, and CE rejects zero length copies
+    if (pVidMemDesc->Size == 0)
+    {
+        return;
+    }
+
     if (pFbsr->op == FBSR_OP_SIZE_BUF)
     {
         switch (pFbsr->type)
@@ -849,6 +982,9 @@ fbsrCopyMemoryMemDesc_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, MEMORY_DESCRIPTOR *pVi
     }
     else
     {
+        // Asynchronous CE copies are timed when they are waited for
+        NvU64 regionSubmitTimeNs = osGetMonotonicTimeNs();
+
         NV_PRINTF(LEVEL_INFO, "%s allocation %llx-%llx [%s]\n",
                   pFbsr->op == FBSR_OP_SAVE ? "saving" : "restoring",
                   memdescGetPhysAddr(pVidMemDesc, AT_GPU, 0),
@@ -870,13 +1006,11 @@ fbsrCopyMemoryMemDesc_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, MEMORY_DESCRIPTOR *pVi
 
                     if (pFbsr->op == FBSR_OP_RESTORE)
                     {
-                        NV_ASSERT_OK(memmgrMemCopy(pMemoryManager, &vidSurface, &sysSurface, pVidMemDesc->Size,
-                                                   TRANSFER_FLAGS_PREFER_CE | TRANSFER_FLAGS_CE_PRI_DEFER_FLUSH));
+                        NV_ASSERT_OK(_fbsrCopyRegionDma(pGpu, pFbsr, &vidSurface, &sysSurface, pVidMemDesc->Size));
                     }
                     else
                     {
-                        NV_ASSERT_OK(memmgrMemCopy(pMemoryManager, &sysSurface, &vidSurface, pVidMemDesc->Size,
-                                                   TRANSFER_FLAGS_PREFER_CE | TRANSFER_FLAGS_CE_PRI_DEFER_FLUSH));
+                        NV_ASSERT_OK(_fbsrCopyRegionDma(pGpu, pFbsr, &sysSurface, &vidSurface, pVidMemDesc->Size));
                     }
                     break;
                 }
@@ -890,13 +1024,11 @@ fbsrCopyMemoryMemDesc_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, MEMORY_DESCRIPTOR *pVi
 
                     if (pFbsr->op == FBSR_OP_RESTORE)
                     {
-                        NV_ASSERT_OK(memmgrMemCopy(pMemoryManager, &vidSurface, &sysSurface, pVidMemDesc->Size,
-                                                   TRANSFER_FLAGS_PREFER_CE | TRANSFER_FLAGS_CE_PRI_DEFER_FLUSH));
+                        NV_ASSERT_OK(_fbsrCopyRegionDma(pGpu, pFbsr, &vidSurface, &sysSurface, pVidMemDesc->Size));
                     }
                     else
                     {
-                        NV_ASSERT_OK(memmgrMemCopy(pMemoryManager, &sysSurface, &vidSurface, pVidMemDesc->Size,
-                                                   TRANSFER_FLAGS_PREFER_CE | TRANSFER_FLAGS_CE_PRI_DEFER_FLUSH));
+                        NV_ASSERT_OK(_fbsrCopyRegionDma(pGpu, pFbsr, &sysSurface, &vidSurface, pVidMemDesc->Size));
                     }
                     break;
                 }
@@ -1151,6 +1283,13 @@ fbsrCopyMemoryMemDesc_GM107(OBJGPU *pGpu, OBJFBSR *pFbsr, MEMORY_DESCRIPTOR *pVi
         }
 
         pFbsr->sysOffset += pVidMemDesc->Size;
+        pFbsr->numCopiedRegions++;
+
+        NV_PRINTF(LEVEL_INFO, "%s allocation %llx-%llx submitted in %llu us\n",
+                  pFbsr->op == FBSR_OP_SAVE ? "saving" : "restoring",
+                  memdescGetPhysAddr(pVidMemDesc, AT_GPU, 0),
+                  memdescGetPhysAddr(pVidMemDesc, AT_GPU, 0) + pVidMemDesc->Size - 1,
+                  (osGetMonotonicTimeNs() - regionSubmitTimeNs) / 1000);
     }
 }
 
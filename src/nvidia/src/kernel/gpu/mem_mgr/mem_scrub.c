@@ -82,6 +82,11 @@ static NV_STATUS _scrubCheckLocked(OBJMEMSCRUB  *pScrubber, PSCRUB_NODE *ppList,
 static NV_STATUS _scrubCombinePages(NvU64 *pPages, NvU64 pageSize, NvU64 pageCount,
                                     PSCRUB_NODE *ppScrubList, NvU64 *pSize);
 
+static void      _scrubIntervalInsert(OBJMEMSCRUB *pScrubber, NvU32 idx);
+static void      _scrubIntervalRemove(OBJMEMSCRUB *pScrubber, NvU32 idx);
+static NvU64     _scrubIntervalFindMaxId(SCRUB_INTERVAL_NODE *pNodes, NvU32 root,
+                                         RmPhysAddr base, RmPhysAddr end);
+
 /**
  * Constructs the memory scrubber object and signals
  * RM to create CE channels for submitting scrubbing work
@@ -143,6 +148,16 @@ scrubberConstruct
     }
     portMemSet(pScrubber->pScrubList, 0, sizeof(SCRUB_NODE) * MAX_SCRUB_ITEMS);
 
+    pScrubber->pIntervalNodes = (SCRUB_INTERVAL_NODE *)
+                       portMemAllocNonPaged(sizeof(SCRUB_INTERVAL_NODE) * MAX_SCRUB_ITEMS);
+    if (pScrubber->pIntervalNodes == NULL)
+    {
+        status = NV_ERR_INSUFFICIENT_RESOURCES;
+        goto destroyscrublist;
+    }
+    portMemSet(pScrubber->pIntervalNodes, 0, sizeof(SCRUB_INTERVAL_NODE) * MAX_SCRUB_ITEMS);
+    pScrubber->intervalRoot = SCRUB_INTERVAL_NODE_INVALID;
+
     pScrubber->pGpu = pGpu;
 
     {
@@ -189,6 +204,7 @@ scrubberConstruct
     return status;
 
 destroyscrublist:
+    portMemFree(pScrubber->pIntervalNodes);
     portMemFree(pScrubber->pScrubList);
 
 deinitmutex:
@@ -301,6 +317,17 @@ scrubberDestruct
 
     portMemFree(pPmaScrubList);
 
+    NV_PRINTF(LEVEL_INFO,
+              "Scrubber stats: submitted %llu completed %llu coalesced pages %llu max queue depth %llu\n",
+              pScrubber->stats.workSubmitted, pScrubber->stats.workCompleted,
+              pScrubber->stats.pagesCoalesced, pScrubber->stats.queueDepthMax);
+    NV_PRINTF(LEVEL_INFO,
+              "Scrubber stats: hand back time total %llu ns max %llu ns, overlap waits %llu total %llu ns max %llu ns\n",
+              pScrubber->stats.handbackTimeTotalNs, pScrubber->stats.handbackTimeMaxNs,
+              pScrubber->stats.overlapWaitCount, pScrubber->stats.overlapWaitTimeTotalNs,
+              pScrubber->stats.overlapWaitTimeMaxNs);
+
+    portMemFree(pScrubber->pIntervalNodes);
     portMemFree(pScrubber->pScrubList);
     {
         if (pScrubber->bIsEngineTypeSec2)
@@ -443,6 +470,7 @@ scrubSubmitPages
                          cleanup);
 
     numPagesToScrub = scrubListSize;
+    pScrubber->stats.pagesCoalesced += pageCount - scrubListSize;
 
     if (freeEntriesInList < scrubListSize)
     {
@@ -669,10 +697,26 @@ _scrubCopyListItems
     NvLength startIdx             = pScrubber->lastSeenIdByClient%MAX_SCRUB_ITEMS;
     NvLength endIdx               = (pScrubber->lastSeenIdByClient + itemsToSave)%
                                     MAX_SCRUB_ITEMS;
+    NvU64    now                  = osGetMonotonicTimeNs();
+    NvLength i;
 
     NV_ASSERT(pList != NULL);
     NV_ASSERT(itemsToSave <= MAX_SCRUB_ITEMS);
 
+    // Retire the items from the interval index before their slots are cleared
+    for (i = 0; i < itemsToSave; i++)
+    {
+        NvU32 idx     = (NvU32)((startIdx + i) % MAX_SCRUB_ITEMS);
+        NvU64 elapsed = now - pScrubber->pIntervalNodes[idx].submitTimeNs;
+
+        _scrubIntervalRemove(pScrubber, idx);
+
+        pScrubber->stats.handbackTimeTotalNs += elapsed;
+        pScrubber->stats.handbackTimeMaxNs    = NV_MAX(pScrubber->stats.handbackTimeMaxNs,
+                                                       elapsed);
+    }
+    pScrubber->stats.workCompleted += itemsToSave;
+
     if (startIdx < endIdx)
     {
         portMemCopy(pList,
@@ -799,31 +843,229 @@ _searchScrubList
     RmPhysAddr    end
 )
 {
-    NvU64      tempLastSeenIdByClient    = pScrubber->lastSeenIdByClient;
-    NvU64      lastSubmittedWorkId       = pScrubber->lastSubmittedWorkId;
-    NvU64      id                        = 0;
-    NvU64      maxId                     = 0;
-    RmPhysAddr blockStart                = 0;
-    RmPhysAddr blockEnd                  = 0;
-
     //
-    // we need not check for lastSubmittedWorkId, since lastSubmittedWorkId is always one more than
-    // the lastSubmittedWorkIdx.
+    // Every entry in [lastSeenIdByClient, lastSubmittedWorkId] is in the
+    // interval index, so the lookup only visits the overlapping entries.
     //
-    while (tempLastSeenIdByClient != lastSubmittedWorkId)
+    return _scrubIntervalFindMaxId(pScrubber->pIntervalNodes, pScrubber->intervalRoot,
+                                   base, end);
+}
+
+/**
+ * helper function to recompute the cached subtree end of an index node
+ */
+static void
+_scrubIntervalUpdate
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                idx
+)
+{
+    SCRUB_INTERVAL_NODE *pNode  = &pNodes[idx];
+    NvU64                maxEnd = pNode->end;
+
+    if (pNode->left != SCRUB_INTERVAL_NODE_INVALID)
+        maxEnd = NV_MAX(maxEnd, pNodes[pNode->left].maxEnd);
+    if (pNode->right != SCRUB_INTERVAL_NODE_INVALID)
+        maxEnd = NV_MAX(maxEnd, pNodes[pNode->right].maxEnd);
+
+    pNode->maxEnd = maxEnd;
+}
+
+/**
+ * helper function to order index nodes by base, then by id
+ */
+static NvBool
+_scrubIntervalLess
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                idxA,
+    NvU32                idxB
+)
+{
+    if (pNodes[idxA].base != pNodes[idxB].base)
+        return pNodes[idxA].base < pNodes[idxB].base;
+
+    return pNodes[idxA].id < pNodes[idxB].id;
+}
+
+/**
+ * helper function to split the subtree at root into the nodes ordered before
+ * the key node and the remaining ones
+ */
+static void
+_scrubIntervalSplit
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                root,
+    NvU32                keyIdx,
+    NvU32               *pLeft,
+    NvU32               *pRight
+)
+{
+    if (root == SCRUB_INTERVAL_NODE_INVALID)
     {
-        blockStart = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].base;
-        blockEnd   = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].base +
-                   pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].size - 1;
+        *pLeft  = SCRUB_INTERVAL_NODE_INVALID;
+        *pRight = SCRUB_INTERVAL_NODE_INVALID;
+        return;
+    }
 
-        // Check whether the page ranges overlap
-        if ( !(blockStart > end || blockEnd < base) )
-        {
-           id    = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].id;
-           maxId = (id > maxId) ? id : maxId;
-        }
-        tempLastSeenIdByClient++;
+    if (_scrubIntervalLess(pNodes, root, keyIdx))
+    {
+        _scrubIntervalSplit(pNodes, pNodes[root].right, keyIdx, &pNodes[root].right, pRight);
+        *pLeft = root;
+    }
+    else
+    {
+        _scrubIntervalSplit(pNodes, pNodes[root].left, keyIdx, pLeft, &pNodes[root].left);
+        *pRight = root;
     }
+
+    _scrubIntervalUpdate(pNodes, root);
+}
+
+/**
+ * helper function to join two subtrees where every node of left is ordered
+ * before every node of right
+ *
+ * @returns the root of the joined subtree
+ */
+static NvU32
+_scrubIntervalMerge
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                left,
+    NvU32                right
+)
+{
+    if (left == SCRUB_INTERVAL_NODE_INVALID)
+        return right;
+    if (right == SCRUB_INTERVAL_NODE_INVALID)
+        return left;
+
+    if (pNodes[left].priority > pNodes[right].priority)
+    {
+        pNodes[left].right = _scrubIntervalMerge(pNodes, pNodes[left].right, right);
+        _scrubIntervalUpdate(pNodes, left);
+        return left;
+    }
+
+    pNodes[right].left = _scrubIntervalMerge(pNodes, left, pNodes[right].left);
+    _scrubIntervalUpdate(pNodes, right);
+    return right;
+}
+
+/**
+ * helper function to unlink a node from the subtree at root
+ *
+ * @returns the new root of the subtree
+ */
+static NvU32
+_scrubIntervalUnlink
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                root,
+    NvU32                idx
+)
+{
+    NV_ASSERT_OR_RETURN(root != SCRUB_INTERVAL_NODE_INVALID, root);
+
+    if (root == idx)
+        return _scrubIntervalMerge(pNodes, pNodes[root].left, pNodes[root].right);
+
+    if (_scrubIntervalLess(pNodes, idx, root))
+        pNodes[root].left = _scrubIntervalUnlink(pNodes, pNodes[root].left, idx);
+    else
+        pNodes[root].right = _scrubIntervalUnlink(pNodes, pNodes[root].right, idx);
+
+    _scrubIntervalUpdate(pNodes, root);
+    return root;
+}
+
+/**
+ * helper function to add the scrub work in slot idx of the scrub list to the
+ * interval index
+ */
+static void
+_scrubIntervalInsert
+(
+    OBJMEMSCRUB  *pScrubber,
+    NvU32         idx
+)
+{
+    SCRUB_INTERVAL_NODE *pNodes = pScrubber->pIntervalNodes;
+    SCRUB_INTERVAL_NODE *pNode  = &pNodes[idx];
+    NvU32                left;
+    NvU32                right;
+
+    pNode->base         = pScrubber->pScrubList[idx].base;
+    pNode->end          = pScrubber->pScrubList[idx].base + pScrubber->pScrubList[idx].size - 1;
+    pNode->maxEnd       = pNode->end;
+    pNode->id           = pScrubber->pScrubList[idx].id;
+    pNode->submitTimeNs = osGetMonotonicTimeNs();
+    pNode->left         = SCRUB_INTERVAL_NODE_INVALID;
+    pNode->right        = SCRUB_INTERVAL_NODE_INVALID;
+
+    // IDs are sequential, scatter them so the treap stays balanced
+    pNode->priority     = (NvU32)pNode->id * 0x9E3779B1U;
+
+    _scrubIntervalSplit(pNodes, pScrubber->intervalRoot, idx, &left, &right);
+    pScrubber->intervalRoot = _scrubIntervalMerge(pNodes,
+                                                  _scrubIntervalMerge(pNodes, left, idx),
+                                                  right);
+}
+
+/**
+ * helper function to remove the scrub work in slot idx of the scrub list from
+ * the interval index
+ */
+static void
+_scrubIntervalRemove
+(
+    OBJMEMSCRUB  *pScrubber,
+    NvU32         idx
+)
+{
+    pScrubber->intervalRoot = _scrubIntervalUnlink(pScrubber->pIntervalNodes,
+                                                   pScrubber->intervalRoot, idx);
+    portMemSet(&pScrubber->pIntervalNodes[idx], 0, sizeof(SCRUB_INTERVAL_NODE));
+}
+
+/**
+ * helper function to return the largest id of the indexed scrub works that
+ * overlap [base, end]
+ *
+ * @returns 0, if no indexed scrub work overlaps the range
+ */
+static NvU64
+_scrubIntervalFindMaxId
+(
+    SCRUB_INTERVAL_NODE *pNodes,
+    NvU32                root,
+    RmPhysAddr           base,
+    RmPhysAddr           end
+)
+{
+    NvU64 maxId = 0;
+
+    while (root != SCRUB_INTERVAL_NODE_INVALID)
+    {
+        // Nothing in this subtree reaches base
+        if (pNodes[root].maxEnd < base)
+            break;
+
+        maxId = NV_MAX(maxId, _scrubIntervalFindMaxId(pNodes, pNodes[root].left, base, end));
+
+        // This node and everything to its right starts after end
+        if (pNodes[root].base > end)
+            break;
+
+        if (pNodes[root].end >= base)
+            maxId = NV_MAX(maxId, pNodes[root].id);
+
+        root = pNodes[root].right;
+    }
+
     return maxId;
 }
 
@@ -913,6 +1155,8 @@ _waitForPayload
 )
 {
     NvU64      idToWait;
+    NvU64      waitStartNs;
+    NvU64      elapsed;
     RMTIMEOUT  timeout;
     NV_STATUS  status        = NV_OK;
     OBJGPU    *pGpu          = pScrubber->pGpu;
@@ -922,11 +1166,12 @@ _waitForPayload
     //We need to look up in the range between [lastSeenIdByClient, lastSubmittedWorkId]
     idToWait = _searchScrubList(pScrubber, base, end);
 
-    if (idToWait == 0)
+    if ((idToWait == 0) || (_scrubCheckProgress(pScrubber) >= idToWait))
     {
         return NV_OK;
     }
 
+    waitStartNs = osGetMonotonicTimeNs();
     gpuSetTimeout(pGpu, GPU_TIMEOUT_DEFAULT, &timeout, 0);
 
     // Loop will break out, when the semaphore is equal to payload, or times out
@@ -954,6 +1199,12 @@ _waitForPayload
             break;
         }
     }
+
+    elapsed = osGetMonotonicTimeNs() - waitStartNs;
+    pScrubber->stats.overlapWaitCount++;
+    pScrubber->stats.overlapWaitTimeTotalNs += elapsed;
+    pScrubber->stats.overlapWaitTimeMaxNs    = NV_MAX(pScrubber->stats.overlapWaitTimeMaxNs, elapsed);
+
     return status;
 }
 
@@ -984,6 +1235,12 @@ _scrubAddWorkToList
     pScrubber->lastSubmittedWorkId = newId;
     pScrubber->scrubListSize++;
     NV_ASSERT(_scrubGetFreeEntries(pScrubber) <= MAX_SCRUB_ITEMS);
+
+    _scrubIntervalInsert(pScrubber, idx);
+
+    pScrubber->stats.workSubmitted++;
+    pScrubber->stats.queueDepthMax = NV_MAX(pScrubber->stats.queueDepthMax,
+                                            pScrubber->scrubListSize);
 }
 
 
@@ -1104,6 +1361,12 @@ _scrubCombinePages
 {
     NvU64 i, j;
 
+    *ppScrubList = NULL;
+    *pSize       = 0;
+
+    if (pageCount == 0)
+        return NV_OK;
+
     *ppScrubList = (PSCRUB_NODE)portMemAllocNonPaged(sizeof(SCRUB_NODE) * pageCount);
     NV_ASSERT_OR_RETURN(*ppScrubList != NULL, NV_ERR_NO_MEMORY);
 
@@ -1111,18 +1374,34 @@ _scrubCombinePages
     (*ppScrubList)[0].base = pPages[0];
     (*ppScrubList)[0].size = pageSize;
 
+    //
+    // Pages freed in either ascending or descending address order are merged
+    // into the current run, so each contiguous range costs one scrub work.
+    //
     for (i = 0, j = 0; i < (pageCount - 1); i++)
     {
-        if ((((*ppScrubList)[j].size + pageSize) > SCRUB_MAX_BYTES_PER_LINE) ||
-            ((pPages[i] + pageSize) != pPages[i+1]))
+        PSCRUB_NODE pRun = &(*ppScrubList)[j];
+
+        if ((pRun->size + pageSize) > SCRUB_MAX_BYTES_PER_LINE)
         {
             j++;
             (*ppScrubList)[j].base = pPages[i+1];
             (*ppScrubList)[j].size = pageSize;
         }
+        else if ((pRun->base + pRun->size) == pPages[i+1])
+        {
+            pRun->size += pageSize;
+        }
+        else if ((pPages[i+1] + pageSize) == pRun->base)
+        {
+            pRun->base  = pPages[i+1];
+            pRun->size += pageSize;
+        }
         else
         {
-            (*ppScrubList)[j].size += pageSize;
+            j++;
+            (*ppScrubList)[j].base = pPages[i+1];
+            (*ppScrubList)[j].size = pageSize;
         }
     }
 
@@ -56,7 +56,7 @@
  * @brief This utility routine helps in determining the appropriate
  *        memory transfer technique to be used
  */
-static TRANSFER_TYPE
+TRANSFER_TYPE
 memmgrGetMemTransferType
 (
     MemoryManager    *pMemoryManager,
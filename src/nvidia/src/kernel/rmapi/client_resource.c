@@ -1185,6 +1185,28 @@ cliresCtrlCmdSystemGetLockTimes_IMPL
     return NV_OK;
 }
 
+//
+// Get GPU lock contention histograms and top holders.
+//
+// Lock Requirements:
+//      None
+//
+NV_STATUS
+cliresCtrlCmdSystemGetGpuLockProfile_IMPL
+(
+    RmClientResource *pRmCliRes,
+    NV0000_CTRL_SYSTEM_GET_GPU_LOCK_PROFILE_PARAMS *pParams
+)
+{
+    OBJSYS *pSys = SYS_GET_INSTANCE();
+
+    // Profiling data is only collected along with lock times
+    if (!pSys->getProperty(pSys, PDB_PROP_SYS_RM_LOCK_TIME_COLLECT))
+        return NV_ERR_NOT_SUPPORTED;
+
+    return rmGpuLockGetProfile(pParams);
+}
+
 static NV_STATUS
 classGetSystemClasses(NV0000_CTRL_SYSTEM_GET_CLASSLIST_PARAMS *pParams)
 {
@@ -5511,6 +5533,16 @@ NV_STATUS cliresCtrlCmdSystemRmctrlCacheModeCtrl_IMPL
     return NV_OK;
 }
 
+NV_STATUS cliresCtrlCmdSystemGetRmctrlCacheStats_IMPL
+(
+    RmClientResource *pRmCliRes,
+    NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams
+)
+{
+    rmapiControlCacheGetStats(pParams);
+    return NV_OK;
+}
+
 NV_STATUS
 cliresCtrlCmdSystemPfmreqhndlrGetPerfSensorCounters_IMPL
 (
@@ -109,11 +109,40 @@ static NvU64 _getGpuAttrFromGpu(OBJGPU *pGpu)
     return gpuAttr;
 }
 
-static struct {
+//
+// The cached control values are striped by (GPU instance, command) hash so
+// that fills for one GPU or command do not block lookups of another.
+// Each stripe owns its own multimap and lock; entries of one GPU are spread
+// over all stripes.
+//
+#define RMAPI_CONTROL_CACHE_STRIPE_COUNT 16
+
+typedef struct
+{
     GpusControlCache gpusControlCache;
+    PORT_RWLOCK *pLock;
+} RmapiControlCacheStripe;
+
+//
+// Per-command hit/miss/fill counters, in an open-addressed table keyed by
+// command. Slots are claimed and counted atomically, without cache locks.
+//
+#define RMAPI_CONTROL_CACHE_STATS_SLOTS NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_MAX_ENTRIES
+
+typedef struct
+{
+    volatile NvU32 cmd;     // 0 if the slot is unused
+    volatile NvU64 hits;
+    volatile NvU64 misses;
+    volatile NvU64 fills;
+} RmapiControlCacheCmdStats;
+
+static struct {
+    RmapiControlCacheStripe stripes[RMAPI_CONTROL_CACHE_STRIPE_COUNT];
     ObjectToGpuAttrMap objectToGpuAttrMap;
     NvU32 mode;
-    PORT_RWLOCK *pLock;
+    PORT_RWLOCK *pAttrLock;     // Protects objectToGpuAttrMap
+    RmapiControlCacheCmdStats cmdStats[RMAPI_CONTROL_CACHE_STATS_SLOTS];
 } RmapiControlCache;
 
 enum CACHE_LOCK_TYPE
@@ -122,20 +151,110 @@ enum CACHE_LOCK_TYPE
     LOCK_SHARED
 };
 
-static void _cacheLockAcquire(enum CACHE_LOCK_TYPE lockType)
+static void _cacheRwLockAcquire(PORT_RWLOCK *pLock, enum CACHE_LOCK_TYPE lockType)
 {
     if (lockType == LOCK_EXCLUSIVE)
-        portSyncRwLockAcquireWrite(RmapiControlCache.pLock);
+        portSyncRwLockAcquireWrite(pLock);
     else
-        portSyncRwLockAcquireRead(RmapiControlCache.pLock);
+        portSyncRwLockAcquireRead(pLock);
 }
 
-static void _cacheLockRelease(enum CACHE_LOCK_TYPE lockType)
+static void _cacheRwLockRelease(PORT_RWLOCK *pLock, enum CACHE_LOCK_TYPE lockType)
 {
     if (lockType == LOCK_EXCLUSIVE)
-        portSyncRwLockReleaseWrite(RmapiControlCache.pLock);
+        portSyncRwLockReleaseWrite(pLock);
     else
-        portSyncRwLockReleaseRead(RmapiControlCache.pLock);
+        portSyncRwLockReleaseRead(pLock);
+}
+
+static inline NvU32 _cacheStripeIndex(NvU32 gpuInst, NvU32 cmd)
+{
+    NvU32 hash = (gpuInst * 0x9E3779B1U) ^ (cmd * 0x85EBCA6BU);
+
+    return (hash ^ (hash >> 16)) % RMAPI_CONTROL_CACHE_STRIPE_COUNT;
+}
+
+static RmapiControlCacheStripe *_cacheStripeAcquire
+(
+    NvU32 gpuInst,
+    NvU32 cmd,
+    enum CACHE_LOCK_TYPE lockType
+)
+{
+    RmapiControlCacheStripe *pStripe =
+        &RmapiControlCache.stripes[_cacheStripeIndex(gpuInst, cmd)];
+
+    _cacheRwLockAcquire(pStripe->pLock, lockType);
+    return pStripe;
+}
+
+static void _cacheStripeRelease(RmapiControlCacheStripe *pStripe, enum CACHE_LOCK_TYPE lockType)
+{
+    _cacheRwLockRelease(pStripe->pLock, lockType);
+}
+
+// Takes every stripe lock in index order, for cache-wide updates.
+static void _cacheStripesAcquireAll(void)
+{
+    NvU32 i;
+
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STRIPE_COUNT; i++)
+        portSyncRwLockAcquireWrite(RmapiControlCache.stripes[i].pLock);
+}
+
+static void _cacheStripesReleaseAll(void)
+{
+    NvU32 i;
+
+    for (i = RMAPI_CONTROL_CACHE_STRIPE_COUNT; i > 0; i--)
+        portSyncRwLockReleaseWrite(RmapiControlCache.stripes[i - 1].pLock);
+}
+
+// Find or claim the stats slot for cmd
+static RmapiControlCacheCmdStats *_cacheStatsFind(NvU32 cmd)
+{
+    NvU32 start = (cmd * 0x9E3779B1U) % RMAPI_CONTROL_CACHE_STATS_SLOTS;
+    NvU32 i;
+
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STATS_SLOTS; i++)
+    {
+        RmapiControlCacheCmdStats *pStats =
+            &RmapiControlCache.cmdStats[(start + i) % RMAPI_CONTROL_CACHE_STATS_SLOTS];
+        NvU32 slotCmd = pStats->cmd;
+
+        if (slotCmd == cmd)
+            return pStats;
+
+        if ((slotCmd == 0) &&
+            (portAtomicCompareAndSwapU32(&pStats->cmd, cmd, 0) || (pStats->cmd == cmd)))
+        {
+            return pStats;
+        }
+    }
+
+    // Table full, the command is not tracked
+    return NULL;
+}
+
+static void _cacheStatsRecordGet(NvU32 cmd, NV_STATUS status)
+{
+    RmapiControlCacheCmdStats *pStats = _cacheStatsFind(cmd);
+
+    if (pStats == NULL)
+        return;
+
+    if (status == NV_OK)
+        portAtomicExIncrementU64(&pStats->hits);
+    else
+        portAtomicExIncrementU64(&pStats->misses);
+}
+
+static void _cacheStatsRecordFill(NvU32 cmd)
+{
+    RmapiControlCacheCmdStats *pStats = _cacheStatsFind(cmd);
+
+    if (pStats != NULL)
+        portAtomicExIncrementU64(&pStats->fills);
 }
 
 static inline
@@ -145,9 +264,9 @@ NvBool _cacheIsDisabled(void)
                 NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_DISABLE);
 }
 
-static RmapiControlCacheEntry* _setCacheEntry(NvU64 key1, NvU64 key2, NvU32 allocSize,
-                                              NvU32 rmctrlFlags, NvBool *pbParamsAllocated);
-static RmapiControlCacheEntry* _getCacheEntry(NvU64 key1, NvU64 key2);
+static RmapiControlCacheEntry* _setCacheEntry(RmapiControlCacheStripe *pStripe, NvU64 key1, NvU64 key2,
+                                              NvU32 allocSize, NvU32 rmctrlFlags, NvBool *pbParamsAllocated);
+static RmapiControlCacheEntry* _getCacheEntry(RmapiControlCacheStripe *pStripe, NvU64 key1, NvU64 key2);
 
 NvBool rmapiControlIsCacheable(NvU32 flags, NvU32 accessRight, NvBool bAllowInternal)
 {
@@ -185,6 +304,8 @@ NvBool rmapiCmdIsCacheable(NvU32 cmd, NvBool bAllowInternal)
 
 NV_STATUS rmapiControlCacheInit(void)
 {
+    NvU32 i = 0;
+
 #if   defined(DEBUG)
     // Beware that verification only mode will not work during GCOFF.
     RmapiControlCache.mode = NV0000_CTRL_SYSTEM_RMCTRL_CACHE_MODE_CTRL_MODE_VERIFY_ONLY;
@@ -200,17 +321,43 @@ NV_STATUS rmapiControlCacheInit(void)
     }
     NV_PRINTF(LEVEL_INFO, "using cache mode %d\n", RmapiControlCache.mode);
 
-    multimapInit(&RmapiControlCache.gpusControlCache, portMemAllocatorGetGlobalNonPaged());
+    portMemSet(RmapiControlCache.cmdStats, 0, sizeof(RmapiControlCache.cmdStats));
+
     mapInit(&RmapiControlCache.objectToGpuAttrMap, portMemAllocatorGetGlobalNonPaged());
-    RmapiControlCache.pLock = portSyncRwLockCreate(portMemAllocatorGetGlobalNonPaged());
-    if (RmapiControlCache.pLock == NULL)
+    RmapiControlCache.pAttrLock = portSyncRwLockCreate(portMemAllocatorGetGlobalNonPaged());
+    if (RmapiControlCache.pAttrLock == NULL)
+        goto fail;
+
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STRIPE_COUNT; i++)
     {
-        NV_PRINTF(LEVEL_ERROR, "failed to create rw lock\n");
-        multimapDestroy(&RmapiControlCache.gpusControlCache);
-        mapDestroy(&RmapiControlCache.objectToGpuAttrMap);
-        return NV_ERR_NO_MEMORY;
+        RmapiControlCacheStripe *pStripe = &RmapiControlCache.stripes[i];
+
+        multimapInit(&pStripe->gpusControlCache, portMemAllocatorGetGlobalNonPaged());
+        pStripe->pLock = portSyncRwLockCreate(portMemAllocatorGetGlobalNonPaged());
+        if (pStripe->pLock == NULL)
+        {
+            multimapDestroy(&pStripe->gpusControlCache);
+            goto fail;
+        }
     }
     return NV_OK;
+
+fail:
+    NV_PRINTF(LEVEL_ERROR, "failed to create rw lock\n");
+    while (i > 0)
+    {
+        i--;
+        multimapDestroy(&RmapiControlCache.stripes[i].gpusControlCache);
+        portSyncRwLockDestroy(RmapiControlCache.stripes[i].pLock);
+        RmapiControlCache.stripes[i].pLock = NULL;
+    }
+    if (RmapiControlCache.pAttrLock != NULL)
+    {
+        portSyncRwLockDestroy(RmapiControlCache.pAttrLock);
+        RmapiControlCache.pAttrLock = NULL;
+    }
+    mapDestroy(&RmapiControlCache.objectToGpuAttrMap);
+    return NV_ERR_NO_MEMORY;
 }
 
 NV_STATUS rmapiControlCacheSetGpuAttrForObject
@@ -231,7 +378,7 @@ NV_STATUS rmapiControlCacheSetGpuAttrForObject
 
     NV_PRINTF(LEVEL_INFO, "gpu attr set for 0x%x 0x%x: 0x%llx\n", hClient, hObject, gpuAttr);
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    _cacheRwLockAcquire(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
     entry = mapFind(&RmapiControlCache.objectToGpuAttrMap, _handlesToGpuAttrKey(hClient, hObject));
 
     if (entry != NULL)
@@ -255,11 +402,14 @@ NV_STATUS rmapiControlCacheSetGpuAttrForObject
     *entry = gpuAttr;
 
 done:
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheRwLockRelease(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
     return status;
 }
 
-// Need to hold rmapi control cache read/write lock
+//
+// Takes the gpu attr lock. Cache stripe locks must not be held, the result
+// only selects which stripe to lock.
+//
 static NV_STATUS _rmapiControlCacheGetGpuAttrForObject
 (
     NvHandle hClient,
@@ -269,10 +419,13 @@ static NV_STATUS _rmapiControlCacheGetGpuAttrForObject
 )
 {
     NV_STATUS status = NV_ERR_OBJECT_NOT_FOUND;
-    NvU64* entry = mapFind(&RmapiControlCache.objectToGpuAttrMap, _handlesToGpuAttrKey(hClient, hObject));
+    NvU64* entry;
 
     NV_PRINTF(LEVEL_INFO, "cached gpu attr lookup for 0x%x 0x%x\n", hClient, hObject);
 
+    _cacheRwLockAcquire(RmapiControlCache.pAttrLock, LOCK_SHARED);
+    entry = mapFind(&RmapiControlCache.objectToGpuAttrMap, _handlesToGpuAttrKey(hClient, hObject));
+
     if (entry != NULL)
     {
         NV_PRINTF(LEVEL_INFO, "cached gpu attr for 0x%x 0x%x: 0x%llx\n", hClient, hObject, *entry);
@@ -286,10 +439,11 @@ static NV_STATUS _rmapiControlCacheGetGpuAttrForObject
         status = NV_OK;
     }
 
+    _cacheRwLockRelease(RmapiControlCache.pAttrLock, LOCK_SHARED);
     return status;
 }
 
-// Need to hold rmapi control cache write lock
+// Need to hold rmapi control cache gpu attr write lock
 static void _rmapiControlCacheFreeGpuAttrForObject
 (
     NvHandle hClient,
@@ -306,7 +460,7 @@ static void _rmapiControlCacheFreeGpuAttrForObject
     }
 }
 
-// Need to hold rmapi control cache write lock
+// Need to hold rmapi control cache gpu attr write lock
 static void _rmapiControlCacheFreeGpuAttrForClient(NvHandle hClient)
 {
     while (NV_TRUE)
@@ -337,30 +491,31 @@ static NV_STATUS _rmapiControlCacheGetCacheable
 )
 {
     RmapiControlCacheEntry *entry;
+    RmapiControlCacheStripe *pStripe;
     NvU32 gpuInst;
     NV_STATUS status = NV_OK;
 
-    _cacheLockAcquire(LOCK_SHARED);
-
-    if (_cacheIsDisabled())
-    {
-        // unexpected mode change.
-        status = NV_ERR_INVALID_STATE;
-        goto done;
-    }
-
     if (_isCmdSystemWide(cmd))
     {
-       gpuInst = NV_MAX_DEVICES;
+        gpuInst = NV_MAX_DEVICES;
     }
     else
     {
         status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
         if (status != NV_OK)
-            goto done;
+            return status;
     }
 
-    entry = _getCacheEntry(gpuInst, cmd);
+    pStripe = _cacheStripeAcquire(gpuInst, cmd, LOCK_SHARED);
+
+    if (_cacheIsDisabled())
+    {
+        // unexpected mode change.
+        status = NV_ERR_INVALID_STATE;
+        goto done;
+    }
+
+    entry = _getCacheEntry(pStripe, gpuInst, cmd);
     if (entry == NULL || entry->params == NULL)
     {
         status = NV_ERR_OBJECT_NOT_FOUND;
@@ -387,7 +542,7 @@ static NV_STATUS _rmapiControlCacheGetCacheable
 
     portMemCopy(params, paramsSize, entry->params, entry->paramSize);
 done:
-    _cacheLockRelease(LOCK_SHARED);
+    _cacheStripeRelease(pStripe, LOCK_SHARED);
     return status;
 }
 
@@ -415,33 +570,32 @@ static NV_STATUS _rmapiControlCacheGetAny
 )
 {
     RmapiControlCacheEntry *entry;
+    RmapiControlCacheStripe *pStripe;
     NvU32 gpuInst;
     NV_STATUS status = NV_OK;
     NvU32 rmctrlFlags = 0;
 
-    _cacheLockAcquire(LOCK_SHARED);
-
-    if (_cacheIsDisabled())
-    {
-        // unexpected mode change.
-        status = NV_ERR_INVALID_STATE;
-        goto fail_release;
-    }
-
     if (_isCmdSystemWide(cmd))
     {
-       gpuInst = NV_MAX_DEVICES;
+        gpuInst = NV_MAX_DEVICES;
     }
     else
     {
         status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
         if (status != NV_OK)
-        {
-            goto fail_release;
-        }
+            return status;
     }
 
-    entry = _getCacheEntry(gpuInst, cmd);
+    pStripe = _cacheStripeAcquire(gpuInst, cmd, LOCK_SHARED);
+
+    if (_cacheIsDisabled())
+    {
+        // unexpected mode change.
+        status = NV_ERR_INVALID_STATE;
+        goto fail_release;
+    }
+
+    entry = _getCacheEntry(pStripe, gpuInst, cmd);
     if (entry == NULL || entry->params == NULL)
     {
         status = NV_ERR_OBJECT_NOT_FOUND;
@@ -454,7 +608,7 @@ static NV_STATUS _rmapiControlCacheGetAny
     if (status != NV_OK)
         goto fail_release;
 
-    _cacheLockRelease(LOCK_SHARED);
+    _cacheStripeRelease(pStripe, LOCK_SHARED);
 
     // Re-acquire the lock when we do the actual lookup
     switch ((rmctrlFlags & RMCTRL_FLAGS_CACHEABLE_ANY))
@@ -474,7 +628,7 @@ static NV_STATUS _rmapiControlCacheGetAny
     return status;
 
 fail_release:
-    _cacheLockRelease(LOCK_SHARED);
+    _cacheStripeRelease(pStripe, LOCK_SHARED);
     return status;
 }
 
@@ -490,18 +644,10 @@ static NV_STATUS _rmapiControlCacheSet
 {
     NV_STATUS status = NV_OK;
     RmapiControlCacheEntry* entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     NvU32 gpuInst;
     NvBool bParamsAllocated;
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
-
-    if (_cacheIsDisabled())
-    {
-        // unexpected mode change.
-        status = NV_ERR_INVALID_STATE;
-        goto done;
-    }
-
     if (_isCmdSystemWide(cmd))
     {
         gpuInst = NV_MAX_DEVICES;
@@ -510,10 +656,19 @@ static NV_STATUS _rmapiControlCacheSet
     {
         status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
         if (status != NV_OK)
-            goto done;
+            return status;
+    }
+
+    pStripe = _cacheStripeAcquire(gpuInst, cmd, LOCK_EXCLUSIVE);
+
+    if (_cacheIsDisabled())
+    {
+        // unexpected mode change.
+        status = NV_ERR_INVALID_STATE;
+        goto done;
     }
 
-    entry = _setCacheEntry(gpuInst, cmd, paramsSize, rmctrlFlags, &bParamsAllocated);
+    entry = _setCacheEntry(pStripe, gpuInst, cmd, paramsSize, rmctrlFlags, &bParamsAllocated);
     if (entry == NULL)
     {
         status = NV_ERR_NO_MEMORY;
@@ -542,14 +697,16 @@ static NV_STATUS _rmapiControlCacheSet
     portMemCopy(entry->params, paramsSize, params, paramsSize);
 
 done:
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheStripeRelease(pStripe, LOCK_EXCLUSIVE);
     return status;
 }
 
 //
 // Create new cache entry without taking any locks.
-// Requires cache lock to be held before calling.
+// Requires the stripe lock to be held before calling.
 //
+//   pStripe [IN]
+//     Cache stripe selected by _cacheStripeAcquire for (key1, key2)
 //   key1 [IN]
 //     First key for the multimap entry
 //   key2 [IN]
@@ -565,6 +722,7 @@ done:
 static RmapiControlCacheEntry*
 _setCacheEntry
 (
+    RmapiControlCacheStripe *pStripe,
     NvU64 key1,
     NvU64 key2,
     NvU32 allocSize,
@@ -575,19 +733,19 @@ _setCacheEntry
     RmapiControlCacheEntry *entry = NULL;
     GpusControlCacheSubmap *insertedSubmap = NULL;
 
-    entry = multimapFindItem(&RmapiControlCache.gpusControlCache, key1, key2);
+    entry = multimapFindItem(&pStripe->gpusControlCache, key1, key2);
 
     // for cache set, try to init entry if not valid
     if (entry == NULL)
     {
-        if (multimapFindSubmap(&RmapiControlCache.gpusControlCache, key1) == NULL)
+        if (multimapFindSubmap(&pStripe->gpusControlCache, key1) == NULL)
         {
-            insertedSubmap = multimapInsertSubmap(&RmapiControlCache.gpusControlCache, key1);
+            insertedSubmap = multimapInsertSubmap(&pStripe->gpusControlCache, key1);
             if (insertedSubmap == NULL)
                 goto failed;
         }
 
-        entry = multimapInsertItemNew(&RmapiControlCache.gpusControlCache, key1, key2);
+        entry = multimapInsertItemNew(&pStripe->gpusControlCache, key1, key2);
     }
 
     if (entry == NULL)
@@ -615,28 +773,29 @@ _setCacheEntry
 
 failed_free_entry:
     if (entry != NULL)
-        multimapRemoveItem(&RmapiControlCache.gpusControlCache, entry);
+        multimapRemoveItem(&pStripe->gpusControlCache, entry);
 failed_free_submap:
     if (insertedSubmap != NULL)
-        multimapRemoveSubmap(&RmapiControlCache.gpusControlCache, insertedSubmap);
+        multimapRemoveSubmap(&pStripe->gpusControlCache, insertedSubmap);
 failed:
     return NULL;
 }
 
 
 /*!
- * Look up an entry keyed with (key1, key2) in RMCTRL cache.
+ * Look up an entry keyed with (key1, key2) in RMCTRL cache stripe pStripe.
  * Does not take any locks.
  */
 static RmapiControlCacheEntry*
 _getCacheEntry
 (
+    RmapiControlCacheStripe *pStripe,
     NvU64 key1,
     NvU64 key2
 )
 {
     // for cache get, return map find result directly
-    return multimapFindItem(&RmapiControlCache.gpusControlCache, key1, key2);
+    return multimapFindItem(&pStripe->gpusControlCache, key1, key2);
 }
 
 static NvBool _isGpuGetInfoIndexCacheable(NvU32 index, NvU32 cacheGpuFlags)
@@ -738,10 +897,11 @@ static NvBool _isGetInfoIndexCacheable(NvU32 cmd, NvU32 index, NvU32 cacheGpuFla
 
 void _rmapiControlCacheRemoveMapEntry
 (
+    RmapiControlCacheStripe *pStripe,
     RmapiControlCacheEntry *pEntry
 )
 {
-    multimapRemoveItem(&RmapiControlCache.gpusControlCache, pEntry);
+    multimapRemoveItem(&pStripe->gpusControlCache, pEntry);
 }
 
 //
@@ -778,6 +938,7 @@ static NV_STATUS _getInfoCacheHandler
     NvU32 gpuInst;
     NvU32 cacheGpuFlags;
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     GetInfoCacheEntry *cachedTable = NULL;
     const NvU32 allocSize = sizeof(GetInfoCacheEntry) * listSizeLimit;
     enum CACHE_LOCK_TYPE lockType = bSet ? LOCK_EXCLUSIVE : LOCK_SHARED;
@@ -787,7 +948,11 @@ static NV_STATUS _getInfoCacheHandler
         return NV_ERR_INVALID_PARAMETER;
     }
 
-    _cacheLockAcquire(lockType);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, &cacheGpuFlags);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, cmd, lockType);
 
     if (_cacheIsDisabled())
     {
@@ -796,14 +961,10 @@ static NV_STATUS _getInfoCacheHandler
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, &cacheGpuFlags);
-    if (status != NV_OK)
-        goto done;
-
     if (bSet)
-        entry = _setCacheEntry(gpuInst, cmd, allocSize, rmctrlFlags, NULL);
+        entry = _setCacheEntry(pStripe, gpuInst, cmd, allocSize, rmctrlFlags, NULL);
     else
-        entry = _getCacheEntry(gpuInst, cmd);
+        entry = _getCacheEntry(pStripe, gpuInst, cmd);
 
     if (entry == NULL || entry->params == NULL)
     {
@@ -868,11 +1029,11 @@ done:
         if (entry != NULL)
         {
             portMemFree(entry->params);
-            _rmapiControlCacheRemoveMapEntry(entry);
+            _rmapiControlCacheRemoveMapEntry(pStripe, entry);
         }
     }
 
-    _cacheLockRelease(lockType);
+    _cacheStripeRelease(pStripe, lockType);
 
     return status;
 }
@@ -892,10 +1053,15 @@ NV_STATUS _rmapiControlCacheGetByInputTemplateMethod
     NvU32                   gpuInst;
     NV_STATUS               status   = NV_OK;
     RmapiControlCacheEntry *entry    = NULL;
+    RmapiControlCacheStripe *pStripe;
     enum CACHE_LOCK_TYPE    lockType = (bSet) ? LOCK_EXCLUSIVE : LOCK_SHARED;
     NvBool                  bCacheEntryAllocated;
 
-    _cacheLockAcquire(lockType);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, cmd, lockType);
 
     if (_cacheIsDisabled())
     {
@@ -904,14 +1070,10 @@ NV_STATUS _rmapiControlCacheGetByInputTemplateMethod
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
-    if (status != NV_OK)
-        goto done;
-
     if (bSet)
-        entry = _setCacheEntry(gpuInst, cmd, cacheEntrySize, rmctrlFlags, &bCacheEntryAllocated);
+        entry = _setCacheEntry(pStripe, gpuInst, cmd, cacheEntrySize, rmctrlFlags, &bCacheEntryAllocated);
     else
-        entry = _getCacheEntry(gpuInst, cmd);
+        entry = _getCacheEntry(pStripe, gpuInst, cmd);
 
     if (entry == NULL || entry->params == NULL)
     {
@@ -927,10 +1089,10 @@ done:
         {
             if (entry->params)
                 portMemFree(entry->params);
-            _rmapiControlCacheRemoveMapEntry(entry);
+            _rmapiControlCacheRemoveMapEntry(pStripe, entry);
         }
     }
-    _cacheLockRelease(lockType);
+    _cacheStripeRelease(pStripe, lockType);
     return status;
 }
 
@@ -952,9 +1114,14 @@ NV_STATUS _gpuNameStringGet
     NvU32 gpuInst;
     NV_STATUS status = NV_OK;
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     GpuNameStringCacheEntry *cachedParams = NULL;
 
-    _cacheLockAcquire(LOCK_SHARED);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING, LOCK_SHARED);
 
     if (_cacheIsDisabled())
     {
@@ -963,11 +1130,7 @@ NV_STATUS _gpuNameStringGet
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
-    if (status != NV_OK)
-        goto done;
-
-    entry = _getCacheEntry(gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING);
+    entry = _getCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING);
     if (entry == NULL || entry->params == NULL)
     {
         status = NV_ERR_OBJECT_NOT_FOUND;
@@ -1014,7 +1177,7 @@ NV_STATUS _gpuNameStringGet
             goto done;
     }
 done:
-    _cacheLockRelease(LOCK_SHARED);
+    _cacheStripeRelease(pStripe, LOCK_SHARED);
     return status;
 }
 
@@ -1029,9 +1192,14 @@ NV_STATUS _gpuNameStringSet
     NvU32 gpuInst;
     NV_STATUS status;
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     GpuNameStringCacheEntry *cachedParams = NULL;
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING, LOCK_EXCLUSIVE);
 
     if (_cacheIsDisabled())
     {
@@ -1040,11 +1208,7 @@ NV_STATUS _gpuNameStringSet
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
-    if (status != NV_OK)
-        goto done;
-
-    entry = _setCacheEntry(gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING, sizeof(GpuNameStringCacheEntry), rmctrlFlags, NULL);
+    entry = _setCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_GPU_GET_NAME_STRING, sizeof(GpuNameStringCacheEntry), rmctrlFlags, NULL);
     if (entry == NULL)
     {
         status = NV_ERR_NO_MEMORY;
@@ -1104,10 +1268,10 @@ done:
         {
             if (entry->params)
                 portMemFree(entry->params);
-            _rmapiControlCacheRemoveMapEntry(entry);
+            _rmapiControlCacheRemoveMapEntry(pStripe, entry);
         }
     }
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheStripeRelease(pStripe, LOCK_EXCLUSIVE);
 
     return status;
 }
@@ -1131,6 +1295,7 @@ static NV_STATUS _getCePhysicalCapsHandler
     NV_STATUS status = NV_OK;
     NvU32 gpuInst;
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     CePhysicalCapsCacheEntry *cachedTable = NULL;
     const NvU32 allocSize = sizeof(CePhysicalCapsCacheEntry) * NV2080_ENGINE_TYPE_COPY_SIZE;
     enum CACHE_LOCK_TYPE lockType = bSet ? LOCK_EXCLUSIVE : LOCK_SHARED;
@@ -1142,7 +1307,11 @@ static NV_STATUS _getCePhysicalCapsHandler
     }
     ceEngineIndex = NV2080_ENGINE_TYPE_COPY_IDX(ceEngineType);
 
-    _cacheLockAcquire(lockType);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, NV2080_CTRL_CMD_CE_GET_PHYSICAL_CAPS, lockType);
 
     if (_cacheIsDisabled())
     {
@@ -1151,14 +1320,10 @@ static NV_STATUS _getCePhysicalCapsHandler
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
-    if (status != NV_OK)
-        goto done;
-
     if (bSet)
-        entry = _setCacheEntry(gpuInst, NV2080_CTRL_CMD_CE_GET_PHYSICAL_CAPS, allocSize, rmctrlFlags, NULL);
+        entry = _setCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_CE_GET_PHYSICAL_CAPS, allocSize, rmctrlFlags, NULL);
     else
-        entry = _getCacheEntry(gpuInst, NV2080_CTRL_CMD_CE_GET_PHYSICAL_CAPS);
+        entry = _getCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_CE_GET_PHYSICAL_CAPS);
 
     if (entry == NULL || entry->params == NULL)
     {
@@ -1214,10 +1379,10 @@ done:
         {
             if (entry->params != NULL)
                 portMemFree(entry->params);
-            multimapRemoveItem(&RmapiControlCache.gpusControlCache, entry);
+            multimapRemoveItem(&pStripe->gpusControlCache, entry);
         }
     }
-    _cacheLockRelease(lockType);
+    _cacheStripeRelease(pStripe, lockType);
 
     return status;
 }
@@ -1241,6 +1406,7 @@ static NV_STATUS _getCePceMaskHandler
     NV_STATUS status = NV_OK;
     NvU32 gpuInst;
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
     CePceMaskCacheEntry *cachedTable = NULL;
     const NvU32 allocSize = sizeof(CePceMaskCacheEntry) * NV2080_ENGINE_TYPE_COPY_SIZE;
     enum CACHE_LOCK_TYPE lockType = bSet ? LOCK_EXCLUSIVE : LOCK_SHARED;
@@ -1252,7 +1418,11 @@ static NV_STATUS _getCePceMaskHandler
     }
     ceEngineIndex = NV2080_ENGINE_TYPE_COPY_IDX(ceEngineType);
 
-    _cacheLockAcquire(lockType);
+    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
+    if (status != NV_OK)
+        return status;
+
+    pStripe = _cacheStripeAcquire(gpuInst, NV2080_CTRL_CMD_CE_GET_CE_PCE_MASK, lockType);
 
     if (_cacheIsDisabled())
     {
@@ -1261,14 +1431,10 @@ static NV_STATUS _getCePceMaskHandler
         goto done;
     }
 
-    status = _rmapiControlCacheGetGpuAttrForObject(hClient, hObject, &gpuInst, NULL);
-    if (status != NV_OK)
-        goto done;
-
     if (bSet)
-        entry = _setCacheEntry(gpuInst, NV2080_CTRL_CMD_CE_GET_CE_PCE_MASK, allocSize, rmctrlFlags, NULL);
+        entry = _setCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_CE_GET_CE_PCE_MASK, allocSize, rmctrlFlags, NULL);
     else
-        entry = _getCacheEntry(gpuInst, NV2080_CTRL_CMD_CE_GET_CE_PCE_MASK);
+        entry = _getCacheEntry(pStripe, gpuInst, NV2080_CTRL_CMD_CE_GET_CE_PCE_MASK);
 
     if (entry == NULL || entry->params == NULL)
     {
@@ -1316,10 +1482,10 @@ done:
         {
             if (entry->params != NULL)
                 portMemFree(entry->params);
-            multimapRemoveItem(&RmapiControlCache.gpusControlCache, entry);
+            multimapRemoveItem(&pStripe->gpusControlCache, entry);
         }
     }
-    _cacheLockRelease(lockType);
+    _cacheStripeRelease(pStripe, lockType);
 
     return status;
 }
@@ -1331,10 +1497,11 @@ NV_STATUS rmapiControlCacheFreeForControl
 )
 {
     RmapiControlCacheEntry *entry = NULL;
+    RmapiControlCacheStripe *pStripe;
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    pStripe = _cacheStripeAcquire(gpuInstance, cmd, LOCK_EXCLUSIVE);
 
-    entry = multimapFindItem(&RmapiControlCache.gpusControlCache, gpuInstance, cmd);
+    entry = _getCacheEntry(pStripe, gpuInstance, cmd);
 
     if (entry == NULL)
         goto done;
@@ -1342,10 +1509,10 @@ NV_STATUS rmapiControlCacheFreeForControl
     if (entry->params != NULL)
         portMemFree(entry->params);
 
-    multimapRemoveItem(&RmapiControlCache.gpusControlCache, entry);
+    multimapRemoveItem(&pStripe->gpusControlCache, entry);
 
 done:
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheStripeRelease(pStripe, LOCK_EXCLUSIVE);
 
     return NV_OK;
 }
@@ -1530,6 +1697,7 @@ NV_STATUS rmapiControlCacheGetUnchecked
         return NV_ERR_OBJECT_NOT_FOUND;
 
     status = _rmapiControlCacheGetAny(hClient, hObject, cmd, params, paramsSize, pSecInfo);
+    _cacheStatsRecordGet(cmd, status);
 
     NV_PRINTF(LEVEL_INFO, "control cache get for 0x%x 0x%x 0x%x status: 0x%x\n", hClient, hObject, cmd, status);
     return status;
@@ -1586,6 +1754,8 @@ NV_STATUS rmapiControlCacheGet
             goto done;
     }
 
+    _cacheStatsRecordGet(cmd, status);
+
 done:
     NV_PRINTF(LEVEL_INFO, "control cache get for 0x%x 0x%x 0x%x status: 0x%x\n", hClient, hObject, cmd, status);
     return status;
@@ -1657,12 +1827,15 @@ NV_STATUS rmapiControlCacheSetUnchecked
             goto done;
     }
 
+    if (status == NV_OK)
+        _cacheStatsRecordFill(cmd);
+
 done:
     NV_PRINTF(LEVEL_INFO, "control cache set for 0x%x 0x%x 0x%x status: 0x%x\n", hClient, hObject, cmd, status);
     return status;
 }
 
-// Need to hold rmapi control cache write lock
+// Need to hold the cache stripe write lock for pMap
 static void _freeSubmap(GpusControlCache *pMap, GpusControlCacheSubmap* pSubmap, NvBool bFreePersistent)
 {
     /* (Sub)map modification invalidates the iterator, so we have to restart */
@@ -1698,13 +1871,24 @@ static void _freeSubmap(GpusControlCache *pMap, GpusControlCacheSubmap* pSubmap,
     }
 }
 
+// Entries of one GPU are spread over all stripes, so visit each in turn
 static void _rmapiControlCacheFreeGpuCache(NvU32 gpuInst, NvBool bFreePersistent)
 {
-    GpusControlCacheSubmap *submap;
+    NvU32 i;
+
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STRIPE_COUNT; i++)
+    {
+        RmapiControlCacheStripe *pStripe = &RmapiControlCache.stripes[i];
+        GpusControlCacheSubmap *submap;
 
-    submap = multimapFindSubmap(&RmapiControlCache.gpusControlCache, gpuInst);
-    if (submap != NULL)
-        _freeSubmap(&RmapiControlCache.gpusControlCache, submap, bFreePersistent);
+        _cacheRwLockAcquire(pStripe->pLock, LOCK_EXCLUSIVE);
+
+        submap = multimapFindSubmap(&pStripe->gpusControlCache, gpuInst);
+        if (submap != NULL)
+            _freeSubmap(&pStripe->gpusControlCache, submap, bFreePersistent);
+
+        _cacheRwLockRelease(pStripe->pLock, LOCK_EXCLUSIVE);
+    }
 }
 
 void rmapiControlCacheFreeNonPersistentCacheForGpu
@@ -1712,11 +1896,7 @@ void rmapiControlCacheFreeNonPersistentCacheForGpu
     NvU32 gpuInst
 )
 {
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
-
     _rmapiControlCacheFreeGpuCache(gpuInst, NV_FALSE);
-
-    _cacheLockRelease(LOCK_EXCLUSIVE);
 }
 
 void rmapiControlCacheFreeAllCacheForGpu
@@ -1724,18 +1904,14 @@ void rmapiControlCacheFreeAllCacheForGpu
     NvU32 gpuInst
 )
 {
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
-
     _rmapiControlCacheFreeGpuCache(gpuInst, NV_TRUE);
-
-    _cacheLockRelease(LOCK_EXCLUSIVE);
 }
 
 void rmapiControlCacheFreeClientEntry(NvHandle hClient)
 {
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    _cacheRwLockAcquire(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
     _rmapiControlCacheFreeGpuAttrForClient(hClient);
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheRwLockRelease(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
 }
 
 void rmapiControlCacheFreeObjectEntry(NvHandle hClient, NvHandle hObject)
@@ -1746,39 +1922,81 @@ void rmapiControlCacheFreeObjectEntry(NvHandle hClient, NvHandle hObject)
         return;
     }
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    _cacheRwLockAcquire(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
     _rmapiControlCacheFreeGpuAttrForObject(hClient, hObject);
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheRwLockRelease(RmapiControlCache.pAttrLock, LOCK_EXCLUSIVE);
 }
 
 void rmapiControlCacheFree(void)
 {
     GpusControlCacheIter it;
+    NvU32 i;
 
-    it = multimapItemIterAll(&RmapiControlCache.gpusControlCache);
-    while (multimapItemIterNext(&it))
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STRIPE_COUNT; i++)
     {
-        RmapiControlCacheEntry* entry = it.pValue;
+        RmapiControlCacheStripe *pStripe = &RmapiControlCache.stripes[i];
 
-        portMemFree(entry->params);
+        it = multimapItemIterAll(&pStripe->gpusControlCache);
+        while (multimapItemIterNext(&it))
+        {
+            RmapiControlCacheEntry* entry = it.pValue;
+
+            portMemFree(entry->params);
+        }
+
+        multimapDestroy(&pStripe->gpusControlCache);
+        portSyncRwLockDestroy(pStripe->pLock);
+        pStripe->pLock = NULL;
     }
 
-    multimapDestroy(&RmapiControlCache.gpusControlCache);
     mapDestroy(&RmapiControlCache.objectToGpuAttrMap);
-    portSyncRwLockDestroy(RmapiControlCache.pLock);
-    RmapiControlCache.pLock = NULL;
+    portSyncRwLockDestroy(RmapiControlCache.pAttrLock);
+    RmapiControlCache.pAttrLock = NULL;
 }
 
 void rmapiControlCacheSetMode(NvU32 mode)
 {
     NV_PRINTF(LEVEL_INFO, "Set rmapi control cache mode to 0x%x\n", mode);
 
-    _cacheLockAcquire(LOCK_EXCLUSIVE);
+    _cacheStripesAcquireAll();
     RmapiControlCache.mode = mode;
-    _cacheLockRelease(LOCK_EXCLUSIVE);
+    _cacheStripesReleaseAll();
 }
 
 NvU32 rmapiControlCacheGetMode(void)
 {
     return RmapiControlCache.mode;
 }
+
+void rmapiControlCacheGetStats
+(
+    NV0000_CTRL_SYSTEM_GET_RMCTRL_CACHE_STATS_PARAMS *pParams
+)
+{
+    NvU32 i;
+
+    pParams->numEntries = 0;
+
+    for (i = 0; i < RMAPI_CONTROL_CACHE_STATS_SLOTS; i++)
+    {
+        RmapiControlCacheCmdStats *pStats = &RmapiControlCache.cmdStats[i];
+        NV0000_CTRL_SYSTEM_RMCTRL_CACHE_STATS_ENTRY *pEntry;
+
+        if (pStats->cmd == 0)
+            continue;
+
+        pEntry = &pParams->entries[pParams->numEntries++];
+        pEntry->cmd    = pStats->cmd;
+        pEntry->hits   = pStats->hits;
+        pEntry->misses = pStats->misses;
+        pEntry->fills  = pStats->fills;
+
+        // Subtract what was reported so concurrent increments are not lost
+        if (pParams->bReset)
+        {
+            portAtomicExSubU64(&pStats->hits, pEntry->hits);
+            portAtomicExSubU64(&pStats->misses, pEntry->misses);
+            portAtomicExSubU64(&pStats->fills, pEntry->fills);
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Userspace benchmark of the Map backends: the default red-black tree and the
+ * B+-tree selected with mapUseBtree(). For 1k to 1M random and ascending
+ * keys, it reports the average ns per insert, find and iteration step of
+ * each backend. Ascending keys follow the resserv handle generator.
+ *
+ * It is not part of the driver build. From src/nvidia:
+ *
+ *   cc -O2 -std=gnu11 -DNV_LINUX -DNV_X86_64 -DNV_ARCH_BITS=64 -DNVRM     \
+ *      -D_LANGUAGE_C -D__NO_CTYPE -DNV_CONTAINERS_NO_TEMPLATES            \
+ *      -DPORT_IS_KERNEL_BUILD=1 -DPORT_IS_CHECKED_BUILD=0                 \
+ *      -DPORT_ATOMIC_64_BIT_SUPPORTED=1 -DPORT_MODULE_memory=1            \
+ *      -DPORT_MODULE_core=1 -DPORT_MODULE_debug=1 -DPORT_MODULE_safe=1    \
+ *      -DPORT_MODULE_util=1 -DPORT_MODULE_atomic=1                        \
+ *      -DNV_PRINTF_STRINGS_ALLOWED=1 -DNV_ASSERT_FAILED_USES_STRINGS=1    \
+ *      -DPORT_ASSERT_FAILED_USES_STRINGS=1                                \
+ *      -include ../common/sdk/nvidia/inc/cpuopsys.h                       \
+ *      -I ../common/sdk/nvidia/inc -I ../common/shared/inc                \
+ *      -I ../common/inc -I arch/nvalloc/common/inc -I inc -I inc/os       \
+ *      -I inc/libraries -I src/libraries -I inc/kernel -I generated       \
+ *      src/libraries/containers/bench/map_bench.c                         \
+ *      src/libraries/containers/map.c                                     \
+ *      src/libraries/containers/multimap.c -o map_bench
+ *   ./map_bench
+ */
+
+#include "containers/map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//
+// The containers only need the allocator and a few memory helpers from
+// nvport; back them with libc.
+//
+void nvAssertFailedNoLog(NV_ASSERT_FAILED_FUNC_TYPE)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", pszFileName, lineNum);
+    abort();
+}
+
+void *portMemCopy(void *pDst, NvLength dstSize, const void *pSrc, NvLength srcSize)
+{
+    return memcpy(pDst, pSrc, srcSize);
+}
+
+void *portMemMove(void *pDst, NvLength dstSize, const void *pSrc, NvLength srcSize)
+{
+    return memmove(pDst, pSrc, srcSize);
+}
+
+void *portMemSet(void *pData, NvU8 value, NvLength lengthBytes)
+{
+    return memset(pData, value, lengthBytes);
+}
+
+void *_portMemAllocatorAlloc(PORT_MEM_ALLOCATOR *pAlloc, NvLength length)
+{
+    return malloc(length);
+}
+
+void _portMemAllocatorFree(PORT_MEM_ALLOCATOR *pAlloc, void *pMem)
+{
+    free(pMem);
+}
+
+MAKE_MAP(BenchMap, NvU64);
+
+typedef struct
+{
+    double insertNs;
+    double findNs;
+    double iterNs;
+} BENCH_RESULT;
+
+static PORT_MEM_ALLOCATOR benchAllocator;
+
+static double
+_benchNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static NvU64
+_benchRandom(void)
+{
+    return ((NvU64)rand() << 62) ^ ((NvU64)rand() << 31) ^ (NvU64)rand();
+}
+
+static void
+_benchRun
+(
+    const NvU64  *pKeys,
+    NvU32         count,
+    NvBool        bBtree,
+    BENCH_RESULT *pResult
+)
+{
+    BenchMap map;
+    BenchMapIter it;
+    volatile NvU64 sum = 0;
+    double start;
+    NvU32 i;
+
+    mapInit(&map, &benchAllocator);
+    if (bBtree && !mapUseBtree(&map, &benchAllocator))
+    {
+        fprintf(stderr, "mapUseBtree failed\n");
+        exit(1);
+    }
+
+    start = _benchNowNs();
+    for (i = 0; i < count; i++)
+    {
+        NvU64 *pValue = mapInsertNew(&map, pKeys[i]);
+
+        if (pValue != NULL)
+            *pValue = i;
+    }
+    pResult->insertNs += (_benchNowNs() - start) / count;
+
+    // Look the keys up in a different order than they were inserted
+    start = _benchNowNs();
+    for (i = 0; i < count; i++)
+    {
+        NvU64 *pValue = mapFind(&map, pKeys[(i * 2654435761u) % count]);
+
+        sum += (pValue != NULL) ? *pValue : 0;
+    }
+    pResult->findNs += (_benchNowNs() - start) / count;
+
+    start = _benchNowNs();
+    it = mapIterAll(&map);
+    while (mapIterNext(&it))
+    {
+        sum += *it.pValue;
+    }
+    pResult->iterNs += (_benchNowNs() - start) / mapCount(&map);
+
+    mapDestroy(&map);
+}
+
+static void
+_benchSize(NvU32 count, NvU32 reps, NvBool bAscending)
+{
+    BENCH_RESULT result[2];
+    NvU64 *pKeys = malloc(count * sizeof(*pKeys));
+    NvU32 rep;
+    NvU32 i;
+
+    if (pKeys == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    memset(result, 0, sizeof(result));
+
+    for (rep = 0; rep < reps; rep++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            pKeys[i] = bAscending ? (0xcaf00000ULL + i) : _benchRandom();
+        }
+
+        _benchRun(pKeys, count, NV_FALSE, &result[0]);
+        _benchRun(pKeys, count, NV_TRUE, &result[1]);
+    }
+
+    printf("%-10s %8u  insert %7.1f / %7.1f  find %7.1f / %7.1f  iterate %5.1f / %5.1f\n",
+           bAscending ? "ascending" : "random", count,
+           result[0].insertNs / reps, result[1].insertNs / reps,
+           result[0].findNs / reps, result[1].findNs / reps,
+           result[0].iterNs / reps, result[1].iterNs / reps);
+
+    free(pKeys);
+}
+
+int main(void)
+{
+    static const struct { NvU32 count; NvU32 reps; } sizes[] =
+    {
+        { 1000,    200 },
+        { 10000,   50  },
+        { 100000,  5   },
+        { 1000000, 3   },
+    };
+    NvU32 order;
+    NvU32 i;
+
+    srand(1);
+
+    printf("ns per operation, red-black tree / B+-tree\n");
+
+    for (order = 0; order < 2; order++)
+    {
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            _benchSize(sizes[i].count, sizes[i].reps, order == 1);
+        }
+    }
+
+    return 0;
+}
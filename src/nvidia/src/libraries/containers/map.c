@@ -50,6 +50,51 @@ static void _mapAdoptChildrenNodes(MapNode *pTargetNode, MapNode *pNewNode);
  */
 static NvBool _mapInsertBase(MapBase *pMap, NvU64 key, void *pValue);
 
+/**
+ * @brief Maximum number of keys held by a B+-tree node.
+ * @details The 16 keys and 16 pointers of a node fill four cache lines, of
+ *          which a lookup reads the two holding the keys and one pointer.
+ *          A lookup in a 1M entry map visits ~5 nodes instead of ~20
+ *          red-black tree nodes.
+ */
+#define MAP_BTREE_ORDER 16
+
+struct MapBtreeNode
+{
+    MapBtreeNode   *pParent;
+    MapBtreeNode   *pPrev;      // Neighbouring leaves, NULL for internal nodes
+    MapBtreeNode   *pNext;
+    NvU32           count;
+    NvBool          bLeaf;
+    // Leaves: key of each entry. Internal nodes: lower bound of each child,
+    // with every key of child i below keys[i + 1].
+    NvU64           keys[MAP_BTREE_ORDER];
+    union
+    {
+        MapNode        *pEntries[MAP_BTREE_ORDER];
+        MapBtreeNode   *pChildren[MAP_BTREE_ORDER];
+    } u;
+};
+
+/**
+ * @brief B+-tree counterparts of the red-black tree operations.
+ * @details In B+-tree mode MapNode::pParent points to the leaf holding the
+ *          node; the remaining MapNode links are unused.
+ */
+static NvBool _mapBtreeInsert(MapBase *pMap, MapNode *pNode);
+static void _mapBtreeRemove(MapBase *pMap, MapNode *pNode);
+static void _mapBtreeDestroy(MapBase *pMap, PORT_MEM_ALLOCATOR *pAllocator);
+static MapNode *_mapBtreeFind(MapBase *pMap, NvU64 key);
+static MapNode *_mapBtreeFindGEQ(MapBase *pMap, NvU64 keyMin);
+static MapNode *_mapBtreeFindLEQ(MapBase *pMap, NvU64 keyMax);
+static MapNode *_mapBtreeNext(MapNode *pNode);
+static MapNode *_mapBtreePrev(MapNode *pNode);
+
+static NV_FORCEINLINE NvBool _mapIsBtree(MapBase *pMap)
+{
+    return pMap->pBtreeAllocator != NULL;
+}
+
 void mapInit_IMPL
 (
     NonIntrusiveMap     *pMap,
@@ -78,12 +123,33 @@ void mapInitIntrusive_IMPL
     pMap->base.nodeOffset = nodeOffset;
 }
 
+NvBool mapUseBtree_IMPL
+(
+    MapBase             *pMap,
+    PORT_MEM_ALLOCATOR  *pAllocator
+)
+{
+    NV_ASSERT_OR_RETURN(NULL != pMap, NV_FALSE);
+    NV_ASSERT_OR_RETURN(NULL != pAllocator, NV_FALSE);
+    NV_ASSERT_OR_RETURN(0 == pMap->count, NV_FALSE);
+    pMap->pBtreeAllocator = pAllocator;
+    return NV_TRUE;
+}
+
 static void _mapDestroy(MapBase *pMap, PORT_MEM_ALLOCATOR *pAllocator)
 {
     MapNode *pNode;
 
     NV_ASSERT_OR_RETURN_VOID(NULL != pMap);
 
+    if (_mapIsBtree(pMap))
+    {
+        _mapBtreeDestroy(pMap, pAllocator);
+        pMap->count = 0;
+        NV_CHECKED_ONLY(pMap->versionNumber++);
+        return;
+    }
+
     pNode = pMap->pRoot;
     while (NULL != pNode)
     {
@@ -250,6 +316,15 @@ void mapRemoveIntrusive_IMPL
     NV_ASSERT_OR_RETURN_VOID(NULL != z);
     NV_ASSERT_CHECKED(z->pMap == pMap);
 
+    if (_mapIsBtree(pMap))
+    {
+        _mapBtreeRemove(pMap, z);
+        NV_CHECKED_ONLY(pMap->versionNumber++);
+        NV_CHECKED_ONLY(z->pMap = NULL);
+        pMap->count--;
+        return;
+    }
+
     if (z->pLeft == NULL || z->pRight == NULL)
     {
         // z has at least one empty successor, y = z
@@ -324,6 +399,10 @@ void *mapFind_IMPL
 {
     MapNode *pCurrent;
     NV_ASSERT_OR_RETURN(NULL != pMap, NULL);
+
+    if (_mapIsBtree(pMap))
+        return mapNodeToValue(pMap, _mapBtreeFind(pMap, key));
+
     pCurrent = pMap->pRoot;
 
     while (pCurrent != NULL)
@@ -348,6 +427,10 @@ void *mapFindGEQ_IMPL
     MapNode *pCurrent;
     MapNode *pResult;
     NV_ASSERT_OR_RETURN(NULL != pMap, NULL);
+
+    if (_mapIsBtree(pMap))
+        return mapNodeToValue(pMap, _mapBtreeFindGEQ(pMap, keyMin));
+
     pCurrent = pMap->pRoot;
     pResult = NULL;
 
@@ -380,6 +463,10 @@ void *mapFindLEQ_IMPL
     MapNode *pCurrent;
     MapNode *pResult;
     NV_ASSERT_OR_RETURN(NULL != pMap, NULL);
+
+    if (_mapIsBtree(pMap))
+        return mapNodeToValue(pMap, _mapBtreeFindLEQ(pMap, keyMax));
+
     pCurrent = pMap->pRoot;
     pResult = NULL;
 
@@ -414,6 +501,9 @@ void *mapNext_IMPL
     NV_ASSERT_OR_RETURN(NULL != pNode, NULL);
     NV_ASSERT_CHECKED(pNode->pMap == pMap);
 
+    if (_mapIsBtree(pMap))
+        return mapNodeToValue(pMap, _mapBtreeNext(pNode));
+
     if (NULL != (pCurrent = pNode->pRight))
     {
         while (pCurrent->pLeft != NULL)
@@ -454,6 +544,9 @@ void *mapPrev_IMPL
     NV_ASSERT_OR_RETURN(NULL != pNode, NULL);
     NV_ASSERT_CHECKED(pNode->pMap == pMap);
 
+    if (_mapIsBtree(pMap))
+        return mapNodeToValue(pMap, _mapBtreePrev(pNode));
+
     if (NULL != (pCurrent = pNode->pLeft))
     {
         while (pCurrent->pRight != NULL)
@@ -852,6 +945,21 @@ static NvBool _mapInsertBase
     MapNode *pParent;
     MapNode *pNode;
     pNode = mapValueToNode(pMap, pValue);
+
+    if (_mapIsBtree(pMap))
+    {
+        pNode->key    = key;
+        pNode->pLeft  = NULL;
+        pNode->pRight = NULL;
+        if (!_mapBtreeInsert(pMap, pNode))
+            return NV_FALSE;
+
+        NV_CHECKED_ONLY(pNode->pMap = pMap);
+        NV_CHECKED_ONLY(pMap->versionNumber++);
+        pMap->count++;
+        return NV_TRUE;
+    }
+
     // 1. locate parent leaf node for the new node
     pCurrent = pMap->pRoot;
     pParent = NULL;
@@ -898,6 +1006,407 @@ static NvBool _mapInsertBase
     return NV_TRUE;
 }
 
+static NV_FORCEINLINE MapBtreeNode *
+_mapBtreeLeafOf(MapNode *pNode)
+{
+    return (MapBtreeNode *)pNode->pParent;
+}
+
+/**
+ * @brief Index of the first key in pNode that is >= key (count if none).
+ */
+static NvU32 _mapBtreeLowerBound(MapBtreeNode *pNode, NvU64 key)
+{
+    NvU32 lo = 0;
+    NvU32 hi = pNode->count;
+
+    while (lo < hi)
+    {
+        NvU32 mid = (lo + hi) / 2;
+        if (pNode->keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Index of the first key in pNode that is > key (count if none).
+ */
+static NvU32 _mapBtreeUpperBound(MapBtreeNode *pNode, NvU64 key)
+{
+    NvU32 lo = 0;
+    NvU32 hi = pNode->count;
+
+    while (lo < hi)
+    {
+        NvU32 mid = (lo + hi) / 2;
+        if (pNode->keys[mid] <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Index of the child of internal node pNode that may hold key.
+ */
+static NV_FORCEINLINE NvU32 _mapBtreeChildIndex(MapBtreeNode *pNode, NvU64 key)
+{
+    NvU32 i = _mapBtreeUpperBound(pNode, key);
+    return (i == 0) ? 0 : i - 1;
+}
+
+/**
+ * @brief Leaf that holds key if it is present, NULL for an empty map.
+ */
+static MapBtreeNode *_mapBtreeDescend(MapBase *pMap, NvU64 key)
+{
+    MapBtreeNode *pCurrent = pMap->pBtreeRoot;
+
+    while (pCurrent != NULL && !pCurrent->bLeaf)
+        pCurrent = pCurrent->u.pChildren[_mapBtreeChildIndex(pCurrent, key)];
+
+    return pCurrent;
+}
+
+static MapBtreeNode *_mapBtreeAllocNode(MapBase *pMap, NvBool bLeaf)
+{
+    MapBtreeNode *pNode = PORT_ALLOC(pMap->pBtreeAllocator, sizeof(*pNode));
+
+    if (pNode != NULL)
+    {
+        portMemSet(pNode, 0, sizeof(*pNode));
+        pNode->bLeaf = bLeaf;
+    }
+    return pNode;
+}
+
+/**
+ * @brief Split the full child idx of pParent, which must not be full.
+ */
+static NvBool _mapBtreeSplitChild(MapBase *pMap, MapBtreeNode *pParent, NvU32 idx)
+{
+    MapBtreeNode *pChild = pParent->u.pChildren[idx];
+    MapBtreeNode *pSibling;
+    const NvU32 half = MAP_BTREE_ORDER / 2;
+    NvU32 i;
+
+    pSibling = _mapBtreeAllocNode(pMap, pChild->bLeaf);
+    if (pSibling == NULL)
+        return NV_FALSE;
+
+    // 1. move the upper half of pChild into pSibling
+    pSibling->pParent = pParent;
+    pSibling->count = pChild->count - half;
+    portMemCopy(pSibling->keys, pSibling->count * sizeof(pSibling->keys[0]),
+                &pChild->keys[half], pSibling->count * sizeof(pChild->keys[0]));
+    portMemCopy(pSibling->u.pEntries, pSibling->count * sizeof(pSibling->u.pEntries[0]),
+                &pChild->u.pEntries[half], pSibling->count * sizeof(pChild->u.pEntries[0]));
+    pChild->count = half;
+
+    for (i = 0; i < pSibling->count; i++)
+    {
+        if (pSibling->bLeaf)
+            pSibling->u.pEntries[i]->pParent = (MapNode *)pSibling;
+        else
+            pSibling->u.pChildren[i]->pParent = pSibling;
+    }
+
+    // 2. link the new leaf into the leaf list
+    if (pSibling->bLeaf)
+    {
+        pSibling->pPrev = pChild;
+        pSibling->pNext = pChild->pNext;
+        if (pChild->pNext != NULL)
+            pChild->pNext->pPrev = pSibling;
+        pChild->pNext = pSibling;
+    }
+
+    // 3. add pSibling to pParent right after pChild
+    for (i = pParent->count; i > idx + 1; i--)
+    {
+        pParent->keys[i] = pParent->keys[i - 1];
+        pParent->u.pChildren[i] = pParent->u.pChildren[i - 1];
+    }
+    pParent->keys[idx + 1] = pSibling->keys[0];
+    pParent->u.pChildren[idx + 1] = pSibling;
+    pParent->count++;
+
+    return NV_TRUE;
+}
+
+static NvBool _mapBtreeInsert(MapBase *pMap, MapNode *pNode)
+{
+    MapBtreeNode *pCurrent;
+    NvU64 key = pNode->key;
+    NvU32 i;
+
+    // 1. grow the tree at the root if needed
+    if (pMap->pBtreeRoot == NULL)
+    {
+        pMap->pBtreeRoot = _mapBtreeAllocNode(pMap, NV_TRUE);
+        if (pMap->pBtreeRoot == NULL)
+            return NV_FALSE;
+    }
+    else if (pMap->pBtreeRoot->count == MAP_BTREE_ORDER)
+    {
+        MapBtreeNode *pOldRoot = pMap->pBtreeRoot;
+        MapBtreeNode *pNewRoot = _mapBtreeAllocNode(pMap, NV_FALSE);
+        if (pNewRoot == NULL)
+            return NV_FALSE;
+
+        pNewRoot->count = 1;
+        pNewRoot->keys[0] = pOldRoot->keys[0];
+        pNewRoot->u.pChildren[0] = pOldRoot;
+        if (!_mapBtreeSplitChild(pMap, pNewRoot, 0))
+        {
+            PORT_FREE(pMap->pBtreeAllocator, pNewRoot);
+            return NV_FALSE;
+        }
+        pOldRoot->pParent = pNewRoot;
+        pMap->pBtreeRoot = pNewRoot;
+    }
+
+    // 2. descend, splitting full nodes on the way so the leaf has room
+    pCurrent = pMap->pBtreeRoot;
+    while (!pCurrent->bLeaf)
+    {
+        i = _mapBtreeChildIndex(pCurrent, key);
+
+        // only possible for the leftmost child; keeps keys[0] a lower bound
+        if (key < pCurrent->keys[i])
+            pCurrent->keys[i] = key;
+
+        if (pCurrent->u.pChildren[i]->count == MAP_BTREE_ORDER)
+        {
+            if (!_mapBtreeSplitChild(pMap, pCurrent, i))
+                return NV_FALSE;
+            if (key >= pCurrent->keys[i + 1])
+                i++;
+        }
+        pCurrent = pCurrent->u.pChildren[i];
+    }
+
+    // 3. insert into the leaf
+    i = _mapBtreeLowerBound(pCurrent, key);
+    if (i < pCurrent->count && pCurrent->keys[i] == key)
+    {
+        // duplication detected
+        return NV_FALSE;
+    }
+
+    portMemMove(&pCurrent->keys[i + 1], (pCurrent->count - i) * sizeof(pCurrent->keys[0]),
+                &pCurrent->keys[i], (pCurrent->count - i) * sizeof(pCurrent->keys[0]));
+    portMemMove(&pCurrent->u.pEntries[i + 1], (pCurrent->count - i) * sizeof(pCurrent->u.pEntries[0]),
+                &pCurrent->u.pEntries[i], (pCurrent->count - i) * sizeof(pCurrent->u.pEntries[0]));
+    pCurrent->keys[i] = key;
+    pCurrent->u.pEntries[i] = pNode;
+    pCurrent->count++;
+    pNode->pParent = (MapNode *)pCurrent;
+
+    return NV_TRUE;
+}
+
+/**
+ * @brief Unlink and free empty nodes from pNode up, then collapse the root.
+ * @details Non-empty nodes are never merged; a sparse tree stays valid and
+ *          is reclaimed once its leaves drain.
+ */
+static void _mapBtreeRemoveEmpty(MapBase *pMap, MapBtreeNode *pNode)
+{
+    MapBtreeNode *pRoot;
+
+    while (pNode != NULL && pNode->count == 0)
+    {
+        MapBtreeNode *pParent = pNode->pParent;
+
+        if (pNode->bLeaf)
+        {
+            if (pNode->pPrev != NULL)
+                pNode->pPrev->pNext = pNode->pNext;
+            if (pNode->pNext != NULL)
+                pNode->pNext->pPrev = pNode->pPrev;
+        }
+
+        if (pParent == NULL)
+        {
+            pMap->pBtreeRoot = NULL;
+        }
+        else
+        {
+            NvU32 i = 0;
+
+            while (pParent->u.pChildren[i] != pNode)
+                i++;
+
+            for (; i + 1 < pParent->count; i++)
+            {
+                pParent->keys[i] = pParent->keys[i + 1];
+                pParent->u.pChildren[i] = pParent->u.pChildren[i + 1];
+            }
+            pParent->count--;
+        }
+
+        PORT_FREE(pMap->pBtreeAllocator, pNode);
+        pNode = pParent;
+    }
+
+    pRoot = pMap->pBtreeRoot;
+    while (pRoot != NULL && !pRoot->bLeaf && pRoot->count == 1)
+    {
+        MapBtreeNode *pChild = pRoot->u.pChildren[0];
+
+        pChild->pParent = NULL;
+        PORT_FREE(pMap->pBtreeAllocator, pRoot);
+        pRoot = pChild;
+    }
+    pMap->pBtreeRoot = pRoot;
+}
+
+static void _mapBtreeRemove(MapBase *pMap, MapNode *pNode)
+{
+    MapBtreeNode *pLeaf = _mapBtreeLeafOf(pNode);
+    NvU32 i;
+
+    NV_ASSERT_OR_RETURN_VOID(NULL != pLeaf);
+    i = _mapBtreeLowerBound(pLeaf, pNode->key);
+    NV_ASSERT_OR_RETURN_VOID((i < pLeaf->count) && (pLeaf->u.pEntries[i] == pNode));
+
+    portMemMove(&pLeaf->keys[i], (pLeaf->count - i - 1) * sizeof(pLeaf->keys[0]),
+                &pLeaf->keys[i + 1], (pLeaf->count - i - 1) * sizeof(pLeaf->keys[0]));
+    portMemMove(&pLeaf->u.pEntries[i], (pLeaf->count - i - 1) * sizeof(pLeaf->u.pEntries[0]),
+                &pLeaf->u.pEntries[i + 1], (pLeaf->count - i - 1) * sizeof(pLeaf->u.pEntries[0]));
+    pLeaf->count--;
+    pNode->pParent = NULL;
+
+    if (pLeaf->count == 0)
+        _mapBtreeRemoveEmpty(pMap, pLeaf);
+}
+
+static void _mapBtreeFreeNode
+(
+    MapBase            *pMap,
+    MapBtreeNode       *pNode,
+    PORT_MEM_ALLOCATOR *pAllocator
+)
+{
+    NvU32 i;
+
+    for (i = 0; i < pNode->count; i++)
+    {
+        if (pNode->bLeaf)
+        {
+            MapNode *pEntry = pNode->u.pEntries[i];
+
+            pEntry->pParent = NULL;
+            NV_CHECKED_ONLY(pEntry->pMap = NULL);
+            if (NULL != pAllocator)
+            {
+                PORT_FREE(pAllocator, pEntry);
+            }
+        }
+        else
+        {
+            _mapBtreeFreeNode(pMap, pNode->u.pChildren[i], pAllocator);
+        }
+    }
+
+    PORT_FREE(pMap->pBtreeAllocator, pNode);
+}
+
+static void _mapBtreeDestroy(MapBase *pMap, PORT_MEM_ALLOCATOR *pAllocator)
+{
+    // Depth is bounded by log(count) / log(MAP_BTREE_ORDER / 2), < 12 levels
+    if (pMap->pBtreeRoot != NULL)
+        _mapBtreeFreeNode(pMap, pMap->pBtreeRoot, pAllocator);
+    pMap->pBtreeRoot = NULL;
+}
+
+static MapNode *_mapBtreeFind(MapBase *pMap, NvU64 key)
+{
+    MapBtreeNode *pLeaf = _mapBtreeDescend(pMap, key);
+    NvU32 i;
+
+    if (pLeaf == NULL)
+        return NULL;
+
+    i = _mapBtreeLowerBound(pLeaf, key);
+    if (i < pLeaf->count && pLeaf->keys[i] == key)
+        return pLeaf->u.pEntries[i];
+
+    return NULL;
+}
+
+static MapNode *_mapBtreeFindGEQ(MapBase *pMap, NvU64 keyMin)
+{
+    MapBtreeNode *pLeaf = _mapBtreeDescend(pMap, keyMin);
+    NvU32 i;
+
+    if (pLeaf == NULL)
+        return NULL;
+
+    i = _mapBtreeLowerBound(pLeaf, keyMin);
+    if (i == pLeaf->count)
+    {
+        pLeaf = pLeaf->pNext;
+        i = 0;
+    }
+
+    return (pLeaf != NULL) ? pLeaf->u.pEntries[i] : NULL;
+}
+
+static MapNode *_mapBtreeFindLEQ(MapBase *pMap, NvU64 keyMax)
+{
+    MapBtreeNode *pLeaf = _mapBtreeDescend(pMap, keyMax);
+    NvU32 i;
+
+    if (pLeaf == NULL)
+        return NULL;
+
+    i = _mapBtreeUpperBound(pLeaf, keyMax);
+    if (i == 0)
+    {
+        pLeaf = pLeaf->pPrev;
+        if (pLeaf == NULL)
+            return NULL;
+        i = pLeaf->count;
+    }
+
+    return pLeaf->u.pEntries[i - 1];
+}
+
+static MapNode *_mapBtreeNext(MapNode *pNode)
+{
+    MapBtreeNode *pLeaf = _mapBtreeLeafOf(pNode);
+    NvU32 i;
+
+    NV_ASSERT_OR_RETURN(NULL != pLeaf, NULL);
+    i = _mapBtreeLowerBound(pLeaf, pNode->key);
+
+    if (i + 1 < pLeaf->count)
+        return pLeaf->u.pEntries[i + 1];
+
+    return (pLeaf->pNext != NULL) ? pLeaf->pNext->u.pEntries[0] : NULL;
+}
+
+static MapNode *_mapBtreePrev(MapNode *pNode)
+{
+    MapBtreeNode *pLeaf = _mapBtreeLeafOf(pNode);
+    NvU32 i;
+
+    NV_ASSERT_OR_RETURN(NULL != pLeaf, NULL);
+    i = _mapBtreeLowerBound(pLeaf, pNode->key);
+
+    if (i > 0)
+        return pLeaf->u.pEntries[i - 1];
+
+    return (pLeaf->pPrev != NULL) ?
+        pLeaf->pPrev->u.pEntries[pLeaf->pPrev->count - 1] : NULL;
+}
+
 NvBool mapIsValid_IMPL(void *pMap)
 {
 #if NV_TYPEOF_SUPPORTED
@@ -74,18 +74,33 @@ void multimapClear_IMPL
 )
 {
     PORT_MEM_ALLOCATOR *pAllocator;
+    PORT_MEM_ALLOCATOR *pBtreeAllocator;
     NvU32 valueSize;
     NvS32 nodeOffset;
     NvU32 submapSize;
 
     NV_ASSERT_OR_RETURN_VOID(NULL != pBase);
     pAllocator = pBase->map.pAllocator;
+    pBtreeAllocator = pBase->map.base.pBtreeAllocator;
     valueSize = pBase->itemSize;
     nodeOffset = pBase->multimapNodeOffset;
     submapSize = pBase->map.valueSize;
 
     multimapDestroy_IMPL(pBase);
     multimapInit_IMPL(pBase, pAllocator, valueSize, nodeOffset, submapSize);
+
+    if (NULL != pBtreeAllocator)
+        mapUseBtree_IMPL(&pBase->map.base, pBtreeAllocator);
+}
+
+NvBool multimapUseBtree_IMPL
+(
+    MultimapBase *pBase
+)
+{
+    NV_ASSERT_OR_RETURN(NULL != pBase, NV_FALSE);
+    NV_ASSERT_OR_RETURN(0 == pBase->itemCount, NV_FALSE);
+    return mapUseBtree_IMPL(&pBase->map.base, pBase->map.pAllocator);
 }
 
 void *multimapInsertSubmap_IMPL(MultimapBase *pBase, NvU64 submapKey)
@@ -99,6 +114,13 @@ void *multimapInsertSubmap_IMPL(MultimapBase *pBase, NvU64 submapKey)
         NvS32 submapNodeOffset = pBase->multimapNodeOffset +
                                  NV_OFFSETOF(MultimapNode, submapNode);
         mapInitIntrusive_IMPL((IntrusiveMap *)pSubmap, submapNodeOffset);
+
+        // Submaps follow the backend of the submap index
+        if (NULL != pBase->map.base.pBtreeAllocator)
+        {
+            mapUseBtree_IMPL(&((IntrusiveMap *)pSubmap)->base,
+                             pBase->map.base.pBtreeAllocator);
+        }
     }
 
     return pSubmap;
@@ -66,16 +66,50 @@ typedef struct ThreadEntry
 
     NvU8 *pTlsBlock; // backing memory for TlsEntryMap nodes
     PORT_MEM_ALLOCATOR *pTlsEntryAllocator;
+    NvU32 slot;      // Slot in the shard holding a passive thread, or TLS_THREAD_ENTRY_SLOT_NONE
 } ThreadEntry;
 
 #define TLS_THREAD_ENTRY_BLOCK_SZ PORT_MEM_PREALLOCATED_BLOCK(sizeof(TlsEntry[16]))
 
 MAKE_INTRUSIVE_MAP(ThreadEntryMap, ThreadEntry, node);
 
+//
+// Passive thread entries are spread over TLS_THREAD_ENTRY_SHARDS shards by a
+// hash of the thread ID, so that threads only contend on a shard lock when
+// they hash to the same shard.
+//
+// Each shard also has TLS_THREAD_ENTRY_SLOTS slots that a thread claims with
+// a compare-and-swap of its thread ID. A slot is only ever written by the
+// thread whose ID it holds, and a thread only ever matches its own ID, so
+// lookups scan the slots without taking any lock. Threads that find all
+// slots of their shard taken fall back to the shard's locked map.
+//
+#define TLS_THREAD_ENTRY_SHARDS     64
+#if PORT_ATOMIC_64_BIT_SUPPORTED
+#define TLS_THREAD_ENTRY_SLOTS      8
+#else
+#define TLS_THREAD_ENTRY_SLOTS      0
+#endif
+#define TLS_THREAD_ENTRY_SLOT_NONE  (~(NvU32)0)
+
+typedef struct ThreadEntryShard
+{
+#if TLS_THREAD_ENTRY_SLOTS > 0
+    struct {
+        volatile NvU64        threadId; /// < 0 if the slot is free
+        ThreadEntry *volatile pThreadEntry;
+    } slots[TLS_THREAD_ENTRY_SLOTS];
+#endif
+    /// @brief Lock for the overflow map
+    PORT_SPINLOCK *pLock;
+    /// @brief Number of entries in the overflow map
+    volatile NvU32 overflowCount;
+    /// @brief Thread entries which did not get a slot
+    ThreadEntryMap overflow;
+} ThreadEntryShard;
+
 /**
  * @brief Stores all necessary data for TLS mechanism.
- *
- * @todo Use RW Spinlocks instead. Nice perf boost.
  */
 typedef struct TlsDatabase
 {
@@ -88,10 +122,8 @@ typedef struct TlsDatabase
     ThreadEntry passiveThreadEntry;
     ThreadEntry isrThreadEntry;
 #else
-    /// @brief Lock for the passive thread entry map
-    PORT_SPINLOCK *pLock;
-    /// @brief Map of thread entries of non ISR threads.
-    ThreadEntryMap threadEntries;
+    /// @brief Sharded thread entries of non ISR threads.
+    ThreadEntryShard threadEntries[TLS_THREAD_ENTRY_SHARDS];
 
 #if TLS_ISR_CAN_USE_LOCK
     /// @brief Lock which controls access to ISR-specific structures
@@ -138,6 +170,11 @@ static PORT_MEM_ALLOCATOR *_tlsAllocatorGet(ThreadEntry *pThreadEntry);
 static NV_STATUS           _tlsPassiveThreadEntryInit(ThreadEntry *pThreadEntry);
 
 #if !TLS_IS_SINGLE_THREADED
+static NV_STATUS           _tlsThreadEntriesInit(void);
+static void                _tlsThreadEntriesDestroy(void);
+static void                _tlsThreadEntriesInsert(ThreadEntry *pThreadEntry);
+static void                _tlsThreadEntriesRemove(ThreadEntry *pThreadEntry);
+static ThreadEntry        *_tlsThreadEntriesFind(NvU64 threadId);
 static NV_STATUS           _tlsIsrEntriesInit(void);
 static void                _tlsIsrEntriesDestroy(void);
 static void                _tlsIsrEntriesInsert(ThreadEntry *pThreadEntry);
@@ -197,14 +234,9 @@ NV_STATUS tlsInitialize(void)
 
     mapInitIntrusive(&tlsDatabase.passiveThreadEntry.map);
 #else
-    tlsDatabase.pLock = portSyncSpinlockCreate(tlsDatabase.pAllocator);
-    if (tlsDatabase.pLock == NULL)
-    {
-        status = NV_ERR_INSUFFICIENT_RESOURCES;
+    status = _tlsThreadEntriesInit();
+    if (status != NV_OK)
         goto done;
-    }
-
-    mapInitIntrusive(&tlsDatabase.threadEntries);
 
     status = _tlsIsrEntriesInit();
     if (status != NV_OK)
@@ -253,10 +285,7 @@ void tlsShutdown(void)
     PORT_FREE(tlsDatabase.pAllocator, tlsDatabase.passiveThreadEntry.pTlsBlock);
     mapDestroy(&tlsDatabase.passiveThreadEntry.map);
 #else
-    mapDestroy(&tlsDatabase.threadEntries);
-    if (tlsDatabase.pLock)
-        portSyncSpinlockDestroy(tlsDatabase.pLock);
-
+    _tlsThreadEntriesDestroy();
     _tlsIsrEntriesDestroy();
 #endif
 
@@ -544,10 +573,7 @@ _tlsThreadEntryGet(void)
     }
     else
     {
-        NvU64 threadId = portThreadGetCurrentThreadId();
-        portSyncSpinlockAcquire(tlsDatabase.pLock);
-        pThreadEntry = mapFind(&tlsDatabase.threadEntries, threadId);
-        portSyncSpinlockRelease(tlsDatabase.pLock);
+        pThreadEntry = _tlsThreadEntriesFind(portThreadGetCurrentThreadId());
     }
     return pThreadEntry;
 }
@@ -572,11 +598,7 @@ _tlsThreadEntryGetOrAlloc(void)
             }
 
             mapInitIntrusive(&pThreadEntry->map);
-            portSyncSpinlockAcquire(tlsDatabase.pLock);
-            mapInsertExisting(&tlsDatabase.threadEntries,
-                              pThreadEntry->key.threadId,
-                              pThreadEntry);
-            portSyncSpinlockRelease(tlsDatabase.pLock);
+            _tlsThreadEntriesInsert(pThreadEntry);
         }
     }
 
@@ -641,9 +663,7 @@ _tlsEntryRelease
             PORT_FREE(tlsDatabase.pAllocator, pThreadEntry->pTlsBlock);
 
             mapDestroy(&pThreadEntry->map);
-            portSyncSpinlockAcquire(tlsDatabase.pLock);
-            mapRemove(&tlsDatabase.threadEntries, pThreadEntry);
-            portSyncSpinlockRelease(tlsDatabase.pLock);
+            _tlsThreadEntriesRemove(pThreadEntry);
             PORT_FREE(tlsDatabase.pAllocator, pThreadEntry);
         }
 #endif
@@ -681,12 +701,124 @@ static PORT_MEM_ALLOCATOR *_tlsAllocatorGet(ThreadEntry *pThreadEntry)
 }
 
 #if !TLS_IS_SINGLE_THREADED
+
+static ThreadEntryShard *_tlsThreadEntriesShard(NvU64 threadId)
+{
+    // Thread IDs are often sequential, so mix the bits before picking a shard
+    NvU64 hash = threadId * 0x9E3779B97F4A7C15ULL;
+    return &tlsDatabase.threadEntries[(hash >> 32) % TLS_THREAD_ENTRY_SHARDS];
+}
+
+static NV_STATUS _tlsThreadEntriesInit(void)
+{
+    NvU32 i;
+
+    for (i = 0; i < TLS_THREAD_ENTRY_SHARDS; i++)
+    {
+        ThreadEntryShard *pShard = &tlsDatabase.threadEntries[i];
+
+        pShard->pLock = portSyncSpinlockCreate(tlsDatabase.pAllocator);
+        if (pShard->pLock == NULL)
+        {
+            return NV_ERR_INSUFFICIENT_RESOURCES;
+        }
+        mapInitIntrusive(&pShard->overflow);
+    }
+    return NV_OK;
+}
+static void _tlsThreadEntriesDestroy(void)
+{
+    NvU32 i;
+
+    for (i = 0; i < TLS_THREAD_ENTRY_SHARDS; i++)
+    {
+        ThreadEntryShard *pShard = &tlsDatabase.threadEntries[i];
+
+        if (pShard->pLock == NULL)
+            continue;
+
+        mapDestroy(&pShard->overflow);
+        portSyncSpinlockDestroy(pShard->pLock);
+    }
+}
+static void _tlsThreadEntriesInsert(ThreadEntry *pThreadEntry)
+{
+    NvU64 threadId = pThreadEntry->key.threadId;
+    ThreadEntryShard *pShard = _tlsThreadEntriesShard(threadId);
+
+#if TLS_THREAD_ENTRY_SLOTS > 0
+    NvU32 i;
+
+    // ID 0 marks a free slot, so such a thread always uses the overflow map
+    for (i = 0; (threadId != 0) && (i < TLS_THREAD_ENTRY_SLOTS); i++)
+    {
+        if (portAtomicExCompareAndSwapU64(&pShard->slots[i].threadId, threadId, 0))
+        {
+            pShard->slots[i].pThreadEntry = pThreadEntry;
+            pThreadEntry->slot = i;
+            return;
+        }
+    }
+#endif
+
+    pThreadEntry->slot = TLS_THREAD_ENTRY_SLOT_NONE;
+    portSyncSpinlockAcquire(pShard->pLock);
+    mapInsertExisting(&pShard->overflow, threadId, pThreadEntry);
+    pShard->overflowCount++;
+    portSyncSpinlockRelease(pShard->pLock);
+}
+static void _tlsThreadEntriesRemove(ThreadEntry *pThreadEntry)
+{
+    ThreadEntryShard *pShard = _tlsThreadEntriesShard(pThreadEntry->key.threadId);
+
+#if TLS_THREAD_ENTRY_SLOTS > 0
+    if (pThreadEntry->slot != TLS_THREAD_ENTRY_SLOT_NONE)
+    {
+        pShard->slots[pThreadEntry->slot].pThreadEntry = NULL;
+        portAtomicExSetU64(&pShard->slots[pThreadEntry->slot].threadId, 0);
+        return;
+    }
+#endif
+
+    portSyncSpinlockAcquire(pShard->pLock);
+    mapRemove(&pShard->overflow, pThreadEntry);
+    pShard->overflowCount--;
+    portSyncSpinlockRelease(pShard->pLock);
+}
+static ThreadEntry *_tlsThreadEntriesFind(NvU64 threadId)
+{
+    ThreadEntryShard *pShard = _tlsThreadEntriesShard(threadId);
+    ThreadEntry *pThreadEntry;
+
+#if TLS_THREAD_ENTRY_SLOTS > 0
+    NvU32 i;
+
+    for (i = 0; (threadId != 0) && (i < TLS_THREAD_ENTRY_SLOTS); i++)
+    {
+        if (pShard->slots[i].threadId == threadId)
+            return pShard->slots[i].pThreadEntry;
+    }
+#endif
+
+    //
+    // A thread inserts its own entry before looking it up, so if the count
+    // is zero the entry cannot be in the overflow map.
+    //
+    if (pShard->overflowCount == 0)
+        return NULL;
+
+    portSyncSpinlockAcquire(pShard->pLock);
+    pThreadEntry = mapFind(&pShard->overflow, threadId);
+    portSyncSpinlockRelease(pShard->pLock);
+    return pThreadEntry;
+}
+
 #if TLS_ISR_CAN_USE_LOCK
 
 static NV_STATUS _tlsIsrEntriesInit(void)
 {
     tlsDatabase.pIsrLock = portSyncSpinlockCreate(tlsDatabase.pAllocator);
-    if (tlsDatabase.pLock == NULL)
+    if (tlsDatabase.pIsrLock == NULL)
     {
         return NV_ERR_INSUFFICIENT_RESOURCES;
     }